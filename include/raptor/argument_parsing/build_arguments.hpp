@@ -16,6 +16,9 @@
 
 #include <hibf/misc/timer.hpp>
 
+#include <raptor/argument_parsing/perf_counters.hpp>
+#include <raptor/argument_parsing/trace_recorder.hpp>
+
 namespace raptor
 {
 
@@ -33,7 +36,16 @@ struct build_arguments
     mutable uint64_t bits{4096}; // Allow to change bits for each partition
     uint64_t hash{2};
     uint8_t parts{1u};
+    bool single_pass{false};
+    std::string store_memory_string{};
+    size_t store_memory{}; // Memory of parts that are stored while the next one is built
+    std::string count_memory_string{};
+    size_t count_memory{}; // Memory for counting the minimisers of the biggest user bin
+    std::string index_memory_string{};
+    size_t index_memory{}; // Memory of the IBF; bigger IBFs are built in slices
     double fpr{0.05};
+    bool minimiser_store{false};
+    bool compress{false};
 
     // General arguments
     std::vector<std::vector<std::string>> bin_path{};
@@ -42,7 +54,12 @@ struct build_arguments
     bool is_hibf{false};
     bool input_is_minimiser{false};
     bool quiet{false};
+    bool perf_counters{false};
     std::filesystem::path timing_out{};
+    std::filesystem::path trace_out{};
+
+    // Copies share the recorded events
+    trace_recorder trace{};
 
     // Timers do not copy the stored duration upon copy construction/assignment
     mutable seqan::hibf::concurrent_timer wall_clock_timer{};
@@ -53,6 +70,9 @@ struct build_arguments
     mutable seqan::hibf::concurrent_timer fill_ibf_timer{};
     mutable seqan::hibf::concurrent_timer store_index_timer{};
 
+    // Hardware counters; only recorded if perf_counters is set
+    mutable concurrent_perf_counter fill_ibf_perf{};
+
     void print_timings() const;
     void write_timings_to_file() const;
 };
@@ -15,31 +15,54 @@
 #include <string>
 
 #include <raptor/argument_parsing/formatted_bytes.hpp>
+#include <raptor/index_sections.hpp>
 
 namespace raptor
 {
 
-[[nodiscard]] inline size_t index_size_in_KiB(std::filesystem::path const & index_path, uint8_t const parts)
+namespace detail
+{
+
+[[nodiscard]] inline size_t
+sum_over_parts(std::filesystem::path const & index_path, uint8_t const parts, auto && size_in_bytes)
 {
-    size_t index_size_in_bytes{};
     if (parts == 1u)
-    {
-        index_size_in_bytes = std::filesystem::file_size(index_path);
-    }
-    else
-    {
-        for (size_t part = 0u; part < parts; ++part)
-        {
-            index_size_in_bytes += std::filesystem::file_size(index_path.string() + "_" + std::to_string(part));
-        }
-    }
-
-    return index_size_in_bytes >> 10;
+        return size_in_bytes(index_path);
+
+    size_t result{};
+    for (size_t part = 0u; part < parts; ++part)
+        result += size_in_bytes(std::filesystem::path{index_path.string() + "_" + std::to_string(part)});
+    return result;
+}
+
+} // namespace detail
+
+[[nodiscard]] inline size_t index_size_in_KiB(std::filesystem::path const & index_path, uint8_t const parts)
+{
+    return detail::sum_over_parts(index_path,
+                                  parts,
+                                  [](std::filesystem::path const & path)
+                                  {
+                                      return std::filesystem::file_size(path);
+                                  })
+        >> 10;
+}
+
+//!\brief The size of the index after loading. Differs from index_size_in_KiB for compressed indexes.
+[[nodiscard]] inline size_t index_memory_size_in_KiB(std::filesystem::path const & index_path, uint8_t const parts)
+{
+    return detail::sum_over_parts(index_path, parts, &index_section_table::memory_size) >> 10;
 }
 
 [[nodiscard]] inline std::string formatted_index_size(std::filesystem::path const & index_path, uint8_t const parts)
 {
-    return formatted_bytes(index_size_in_KiB(index_path, parts) << 10);
+    size_t const size_in_KiB = index_size_in_KiB(index_path, parts);
+    size_t const memory_size_in_KiB = index_memory_size_in_KiB(index_path, parts);
+
+    std::string result = formatted_bytes(size_in_KiB << 10);
+    if (memory_size_in_KiB != size_in_KiB)
+        result += " (in memory " + formatted_bytes(memory_size_in_KiB << 10) + ")";
+    return result;
 }
 
 } // namespace raptor
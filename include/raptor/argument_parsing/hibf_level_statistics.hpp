@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::hibf_level_counts and raptor::concurrent_hibf_level_statistics.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace raptor
+{
+
+//!\brief How often the IBFs of one HIBF level were queried, and how often they had to be loaded.
+struct hibf_level_counts
+{
+    uint64_t queries{};
+    uint64_t loads{};
+
+    uint64_t hits() const noexcept
+    {
+        return queries - loads;
+    }
+
+    double hit_rate_in_percent() const noexcept
+    {
+        return queries ? hits() * 100.0 / queries : 0.0;
+    }
+};
+
+//!\brief Per-level counts that can be added from multiple threads. The counts are not copied.
+class concurrent_hibf_level_statistics
+{
+public:
+    concurrent_hibf_level_statistics() = default;
+    concurrent_hibf_level_statistics(concurrent_hibf_level_statistics const &) noexcept
+    {}
+    concurrent_hibf_level_statistics(concurrent_hibf_level_statistics &&) noexcept
+    {}
+    concurrent_hibf_level_statistics & operator=(concurrent_hibf_level_statistics const &) noexcept
+    {
+        return *this;
+    }
+    concurrent_hibf_level_statistics & operator=(concurrent_hibf_level_statistics &&) noexcept
+    {
+        return *this;
+    }
+    ~concurrent_hibf_level_statistics() = default;
+
+    void operator+=(std::vector<hibf_level_counts> const & other)
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+        counts.resize(std::max(counts.size(), other.size()));
+        for (size_t level = 0; level < other.size(); ++level)
+        {
+            counts[level].queries += other[level].queries;
+            counts[level].loads += other[level].loads;
+        }
+    }
+
+    std::vector<hibf_level_counts> value() const
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+        return counts;
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+        return counts.empty();
+    }
+
+private:
+    mutable std::mutex mutex{};
+    std::vector<hibf_level_counts> counts{};
+};
+
+} // namespace raptor
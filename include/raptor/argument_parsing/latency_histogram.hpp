@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::latency_histogram, raptor::concurrent_latency_histogram, and raptor::concurrent_counter.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace raptor
+{
+
+namespace detail
+{
+
+/*!\brief Log-linear bucketing in the style of HdrHistogram.
+ * \details
+ * Values below `2 * sub_bucket_count` are recorded exactly. Larger values are split into powers of two, and each
+ * power of two is divided into `sub_bucket_count` equally sized buckets. The relative error is hence at most
+ * `1 / sub_bucket_count` (6.25%), independent of the magnitude of the value.
+ */
+struct latency_buckets
+{
+    static constexpr size_t sub_bucket_bits{4u};
+    static constexpr size_t sub_bucket_count{1ULL << sub_bucket_bits};
+    static constexpr size_t bucket_count{(65u - sub_bucket_bits) * sub_bucket_count};
+
+    static constexpr size_t index_of(uint64_t const value) noexcept
+    {
+        int const width = std::bit_width(value);
+        if (width <= static_cast<int>(sub_bucket_bits + 1u))
+            return value;
+
+        int const shift = width - static_cast<int>(sub_bucket_bits + 1u);
+        return (shift + 1) * sub_bucket_count + ((value >> shift) - sub_bucket_count);
+    }
+
+    //!\brief The largest value that is mapped to the bucket `index`.
+    static constexpr uint64_t highest_equivalent_value(size_t const index) noexcept
+    {
+        if (index < 2u * sub_bucket_count)
+            return index;
+
+        size_t const shift = index / sub_bucket_count - 1u;
+        uint64_t const mantissa = index % sub_bucket_count + sub_bucket_count;
+        return ((mantissa + 1u) << shift) - 1u;
+    }
+};
+
+} // namespace detail
+
+//!\brief Records durations in nanoseconds. Meant to be used thread-locally and merged into a concurrent histogram.
+class latency_histogram
+{
+public:
+    latency_histogram() = default;
+    latency_histogram(latency_histogram const &) = default;
+    latency_histogram(latency_histogram &&) = default;
+    latency_histogram & operator=(latency_histogram const &) = default;
+    latency_histogram & operator=(latency_histogram &&) = default;
+    ~latency_histogram() = default;
+
+    void record(std::chrono::steady_clock::duration const duration) noexcept
+    {
+        uint64_t const value = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        ++counts[detail::latency_buckets::index_of(value)];
+        ++total;
+        max = std::max(max, value);
+    }
+
+private:
+    friend class concurrent_latency_histogram;
+
+    std::array<uint64_t, detail::latency_buckets::bucket_count> counts{};
+    uint64_t total{};
+    uint64_t max{};
+};
+
+/*!\brief Accumulates latency_histograms from multiple threads.
+ * \details
+ * Like `seqan::hibf::concurrent_timer`, the recorded values are not copied upon copy construction/assignment.
+ */
+class concurrent_latency_histogram
+{
+public:
+    concurrent_latency_histogram() = default;
+    concurrent_latency_histogram(concurrent_latency_histogram const &) noexcept
+    {}
+    concurrent_latency_histogram(concurrent_latency_histogram &&) noexcept
+    {}
+    concurrent_latency_histogram & operator=(concurrent_latency_histogram const &) noexcept
+    {
+        return *this;
+    }
+    concurrent_latency_histogram & operator=(concurrent_latency_histogram &&) noexcept
+    {
+        return *this;
+    }
+    ~concurrent_latency_histogram() = default;
+
+    void operator+=(latency_histogram const & other) noexcept
+    {
+        for (size_t i = 0; i < other.counts.size(); ++i)
+            if (other.counts[i])
+                counts[i].fetch_add(other.counts[i], std::memory_order_relaxed);
+
+        total.fetch_add(other.total, std::memory_order_relaxed);
+
+        uint64_t current_max = max.load(std::memory_order_relaxed);
+        while (current_max < other.max
+               && !max.compare_exchange_weak(current_max, other.max, std::memory_order_relaxed))
+        {}
+    }
+
+    //!\brief The number of recorded values.
+    uint64_t count() const noexcept
+    {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    //!\brief Returns the `percentile` (in `[0, 100]`) in microseconds. Returns 0 if nothing was recorded.
+    double percentile_in_microseconds(double const percentile) const noexcept
+    {
+        uint64_t const recorded = count();
+        if (recorded == 0u)
+            return 0.0;
+
+        uint64_t const rank = std::max<uint64_t>(1u, static_cast<uint64_t>(percentile / 100.0 * recorded + 0.5));
+        uint64_t cumulative{};
+
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            cumulative += counts[i].load(std::memory_order_relaxed);
+            if (cumulative >= rank)
+                return std::min(detail::latency_buckets::highest_equivalent_value(i), max_value()) / 1000.0;
+        }
+
+        return max_in_microseconds(); // GCOVR_EXCL_LINE
+    }
+
+    double max_in_microseconds() const noexcept
+    {
+        return max_value() / 1000.0;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, detail::latency_buckets::bucket_count> counts{};
+    std::atomic<uint64_t> total{};
+    std::atomic<uint64_t> max{};
+
+    uint64_t max_value() const noexcept
+    {
+        return max.load(std::memory_order_relaxed);
+    }
+};
+
+//!\brief A counter that can be incremented from multiple threads. The value is not copied.
+class concurrent_counter
+{
+public:
+    concurrent_counter() = default;
+    concurrent_counter(concurrent_counter const &) noexcept
+    {}
+    concurrent_counter(concurrent_counter &&) noexcept
+    {}
+    concurrent_counter & operator=(concurrent_counter const &) noexcept
+    {
+        return *this;
+    }
+    concurrent_counter & operator=(concurrent_counter &&) noexcept
+    {
+        return *this;
+    }
+    ~concurrent_counter() = default;
+
+    void operator+=(uint64_t const value) noexcept
+    {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const noexcept
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> counter{};
+};
+
+} // namespace raptor
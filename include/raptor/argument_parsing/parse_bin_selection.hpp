@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::parse_bin_selection.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <raptor/argument_parsing/search_arguments.hpp>
+
+namespace raptor
+{
+
+namespace detail
+{
+
+//!\brief Whether `text` matches `pattern`, where `*` matches any sequence of characters and `?` any character.
+bool matches_pattern(std::string_view const pattern, std::string_view const text);
+
+} // namespace detail
+
+/*!\brief Sets `arguments.selected_bins` from `arguments.bins`.
+ * \details
+ * `arguments.bins` is either `@` followed by the path of a file with one entry per line, or a comma-separated list of
+ * entries. An entry is a user bin ID (`3`), a range of user bin IDs (`3-7`), or a pattern that is matched against the
+ * file names of each user bin. A pattern without a `/` only has to match the last path component of a file name.
+ */
+void parse_bin_selection(search_arguments & arguments);
+
+} // namespace raptor
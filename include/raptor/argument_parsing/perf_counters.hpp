@@ -0,0 +1,343 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::perf_counter_group, raptor::serial_perf_counter, and raptor::concurrent_perf_counter.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#if __has_include(<linux/perf_event.h>) && __has_include(<sys/syscall.h>) && __has_include(<unistd.h>)
+#    include <linux/perf_event.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    define RAPTOR_HAS_PERF_EVENT 1
+#else
+#    define RAPTOR_HAS_PERF_EVENT 0
+#endif
+
+namespace raptor
+{
+
+namespace detail
+{
+
+//!\brief The hardware events that are recorded. The first one is the group leader.
+enum perf_event : uint8_t
+{
+    cycles,
+    instructions,
+    llc_misses,
+    dtlb_load_misses
+};
+
+inline constexpr size_t perf_event_count{4u};
+
+using perf_values = std::array<uint64_t, perf_event_count>;
+
+} // namespace detail
+
+/*!\brief Hardware performance counters for the calling thread.
+ * \details
+ * Opens a `perf_event_open` group counting cycles, instructions, last level cache misses, and dTLB load misses of the
+ * calling thread in user space. Events that cannot be opened (e.g., insufficient permissions, virtual machines, or
+ * non-Linux systems) are marked as unavailable; if the cycle counter is unavailable, the group is invalid and all
+ * reads return zero.
+ */
+class perf_counter_group
+{
+public:
+    perf_counter_group() = default;
+    perf_counter_group(perf_counter_group const &) = delete;
+    perf_counter_group(perf_counter_group &&) = delete;
+    perf_counter_group & operator=(perf_counter_group const &) = delete;
+    perf_counter_group & operator=(perf_counter_group &&) = delete;
+
+    ~perf_counter_group()
+    {
+#if RAPTOR_HAS_PERF_EVENT
+        for (int const fd : file_descriptors)
+            if (fd != -1)
+                close(fd);
+#endif
+    }
+
+    //!\brief Opens the counters for the calling thread if `enable` is true.
+    explicit perf_counter_group(bool const enable)
+    {
+        if (enable)
+            open();
+    }
+
+    bool is_valid() const noexcept
+    {
+        return file_descriptors[detail::perf_event::cycles] != -1;
+    }
+
+    //!\brief A bitmask of the events that could not be opened.
+    uint8_t unavailable_mask() const noexcept
+    {
+        uint8_t mask{};
+        for (size_t i = 0; i < detail::perf_event_count; ++i)
+            mask |= static_cast<uint8_t>(file_descriptors[i] == -1) << i;
+        return mask;
+    }
+
+    //!\brief Returns the current counter values, scaled if the kernel had to multiplex the counters.
+    detail::perf_values read() const noexcept
+    {
+        detail::perf_values result{};
+#if RAPTOR_HAS_PERF_EVENT
+        if (!is_valid())
+            return result;
+
+        // PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+        // { nr, time_enabled, time_running, values[nr] }
+        std::array<uint64_t, 3u + detail::perf_event_count> buffer{};
+        if (::read(file_descriptors[detail::perf_event::cycles], buffer.data(), sizeof(buffer)) <= 0)
+            return result; // GCOVR_EXCL_LINE
+
+        uint64_t const time_enabled = buffer[1];
+        uint64_t const time_running = buffer[2];
+        double const scale = (time_running > 0u && time_running < time_enabled)
+                               ? static_cast<double>(time_enabled) / time_running
+                               : 1.0;
+
+        for (size_t i = 0; i < detail::perf_event_count; ++i)
+            if (file_descriptors[i] != -1)
+                result[i] = static_cast<uint64_t>(buffer[3u + group_position[i]] * scale);
+#endif
+        return result;
+    }
+
+private:
+    std::array<int, detail::perf_event_count> file_descriptors{-1, -1, -1, -1};
+    std::array<size_t, detail::perf_event_count> group_position{};
+
+    void open()
+    {
+#if RAPTOR_HAS_PERF_EVENT
+        constexpr uint64_t dtlb_read_miss = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        constexpr std::array<std::pair<uint32_t, uint64_t>, detail::perf_event_count> events{
+            {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+             {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+             {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+             {PERF_TYPE_HW_CACHE, dtlb_read_miss}}};
+
+        size_t opened{};
+        for (size_t i = 0; i < detail::perf_event_count; ++i)
+        {
+            perf_event_attr attributes{};
+            attributes.size = sizeof(perf_event_attr);
+            attributes.type = events[i].first;
+            attributes.config = events[i].second;
+            attributes.read_format =
+                PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+
+            int const leader = file_descriptors[detail::perf_event::cycles];
+            if (i != detail::perf_event::cycles && leader == -1)
+                return;
+
+            // pid = 0, cpu = -1: Count the calling thread on any CPU.
+            long const fd = syscall(SYS_perf_event_open, &attributes, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+            if (fd == -1)
+                continue;
+
+            file_descriptors[i] = static_cast<int>(fd);
+            group_position[i] = opened++;
+        }
+#endif
+    }
+};
+
+//!\brief Accumulates counter differences between start() and stop(). Like seqan::hibf::serial_timer.
+class serial_perf_counter
+{
+public:
+    serial_perf_counter() = delete;
+    serial_perf_counter(serial_perf_counter const &) = default;
+    serial_perf_counter(serial_perf_counter &&) = default;
+    serial_perf_counter & operator=(serial_perf_counter const &) = default;
+    serial_perf_counter & operator=(serial_perf_counter &&) = default;
+    ~serial_perf_counter() = default;
+
+    explicit serial_perf_counter(perf_counter_group const & group) : group{std::addressof(group)}
+    {}
+
+    void start() noexcept
+    {
+        if (group->is_valid())
+            begin = group->read();
+    }
+
+    void stop() noexcept
+    {
+        if (!group->is_valid())
+            return;
+
+        detail::perf_values const end = group->read();
+        // Scaled values of multiplexed counters are estimates and not necessarily monotonic.
+        for (size_t i = 0; i < detail::perf_event_count; ++i)
+            values[i] += end[i] > begin[i] ? end[i] - begin[i] : 0u;
+    }
+
+private:
+    friend class concurrent_perf_counter;
+
+    perf_counter_group const * group{nullptr};
+    detail::perf_values begin{};
+    detail::perf_values values{};
+};
+
+/*!\brief Accumulates serial_perf_counters from multiple threads.
+ * \details
+ * Like `seqan::hibf::concurrent_timer`, the recorded values are not copied upon copy construction/assignment.
+ */
+class concurrent_perf_counter
+{
+public:
+    concurrent_perf_counter() = default;
+    concurrent_perf_counter(concurrent_perf_counter const &) noexcept
+    {}
+    concurrent_perf_counter(concurrent_perf_counter &&) noexcept
+    {}
+    concurrent_perf_counter & operator=(concurrent_perf_counter const &) noexcept
+    {
+        return *this;
+    }
+    concurrent_perf_counter & operator=(concurrent_perf_counter &&) noexcept
+    {
+        return *this;
+    }
+    ~concurrent_perf_counter() = default;
+
+    void operator+=(serial_perf_counter const & other) noexcept
+    {
+        if (!other.group->is_valid())
+            return;
+
+        for (size_t i = 0; i < detail::perf_event_count; ++i)
+            values[i].fetch_add(other.values[i], std::memory_order_relaxed);
+
+        unavailable.fetch_or(other.group->unavailable_mask(), std::memory_order_relaxed);
+        measurements.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    //!\brief Whether `event` was recorded by every thread that contributed.
+    bool is_available(detail::perf_event const event) const noexcept
+    {
+        return measurements.load(std::memory_order_relaxed) > 0u
+            && !(unavailable.load(std::memory_order_relaxed) & (1u << event));
+    }
+
+    uint64_t operator[](detail::perf_event const event) const noexcept
+    {
+        return values[event].load(std::memory_order_relaxed);
+    }
+
+    //!\brief Instructions per cycle.
+    double ipc() const noexcept
+    {
+        uint64_t const cycles = (*this)[detail::perf_event::cycles];
+        return cycles > 0u ? static_cast<double>((*this)[detail::perf_event::instructions]) / cycles : 0.0;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, detail::perf_event_count> values{};
+    std::atomic<uint8_t> unavailable{};
+    std::atomic<uint64_t> measurements{};
+};
+
+namespace detail
+{
+
+struct perf_counter_phase
+{
+    std::string_view name{};       // For print_timings, e.g. "Query IBF"
+    std::string_view column{};     // For the timing file, e.g. "query_ibf"
+    concurrent_perf_counter const & counter;
+};
+
+inline void print_perf_counters(std::initializer_list<perf_counter_phase> const phases)
+{
+    std::cerr << "Hardware counters\n";
+
+    size_t remaining{phases.size()};
+    for (perf_counter_phase const & phase : phases)
+    {
+        bool const is_last = --remaining == 0u;
+        std::string_view const prefix = is_last ? "    " : "│   ";
+        std::cerr << (is_last ? "└── " : "├── ") << phase.name << '\n';
+
+        auto print = [&](std::string_view const name, perf_event const event, bool const last = false)
+        {
+            std::cerr << prefix << (last ? "└── " : "├── ") << name << ": ";
+            if (phase.counter.is_available(event))
+                std::cerr << phase.counter[event] << '\n';
+            else
+                std::cerr << "Not available\n";
+        };
+
+        print("Cycles", perf_event::cycles);
+        print("Instructions", perf_event::instructions);
+        std::cerr << prefix << "├── IPC: ";
+        if (phase.counter.is_available(perf_event::cycles) && phase.counter.is_available(perf_event::instructions))
+            std::cerr << phase.counter.ipc() << '\n';
+        else
+            std::cerr << "Not available\n";
+        print("LLC misses", perf_event::llc_misses);
+        print("dTLB load misses", perf_event::dtlb_load_misses, true);
+    }
+}
+
+//!\brief Writes the column names, each preceded by a tab.
+inline void write_perf_counter_header(std::ostream & output_stream, std::string_view const column)
+{
+    output_stream << '\t' << column << "_cycles"       //
+                  << '\t' << column << "_instructions" //
+                  << '\t' << column << "_ipc"          //
+                  << '\t' << column << "_llc_misses"   //
+                  << '\t' << column << "_dtlb_load_misses";
+}
+
+//!\brief Writes the values, each preceded by a tab.
+inline void write_perf_counter_values(std::ostream & output_stream, concurrent_perf_counter const & counter)
+{
+    auto write = [&](perf_event const event)
+    {
+        output_stream << '\t';
+        if (counter.is_available(event))
+            output_stream << counter[event];
+        else
+            output_stream << "NA";
+    };
+
+    write(perf_event::cycles);
+    write(perf_event::instructions);
+    output_stream << '\t';
+    if (counter.is_available(perf_event::cycles) && counter.is_available(perf_event::instructions))
+        output_stream << counter.ipc();
+    else
+        output_stream << "NA";
+    write(perf_event::llc_misses);
+    write(perf_event::dtlb_load_misses);
+}
+
+} // namespace detail
+
+} // namespace raptor
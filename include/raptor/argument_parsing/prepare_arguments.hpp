@@ -17,6 +17,7 @@
 #include <hibf/misc/timer.hpp>
 
 #include <raptor/argument_parsing/memory_usage.hpp>
+#include <raptor/argument_parsing/trace_recorder.hpp>
 #include <raptor/strong_types.hpp>
 
 namespace raptor
@@ -30,6 +31,10 @@ struct prepare_arguments
     seqan3::shape shape{seqan3::ungapped{kmer_size}};
     bool use_filesize_dependent_cutoff{false};
     uint8_t kmer_count_cutoff{1u};
+    bool compress{false};
+    bool container{false};
+    std::string memory_string{};
+    size_t memory{}; // Memory for counting the minimisers of all threads
 
     std::filesystem::path out_dir{"./"};
 
@@ -37,6 +42,10 @@ struct prepare_arguments
     std::filesystem::path bin_file{};
     uint8_t threads{1u};
     bool quiet{false};
+    std::filesystem::path trace_out{};
+
+    // Copies share the recorded events
+    trace_recorder trace{};
 
     // Timers do not copy the stored duration upon copy construction/assignment
     mutable seqan::hibf::concurrent_timer wall_clock_timer{};
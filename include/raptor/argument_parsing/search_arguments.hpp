@@ -10,6 +10,7 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
 #include <vector>
 
 #include <seqan3/search/kmer_index/shape.hpp>
@@ -17,7 +18,12 @@
 #include <hibf/misc/timer.hpp>
 
 #include <raptor/argument_parsing/formatted_index_size.hpp>
+#include <raptor/argument_parsing/hibf_level_statistics.hpp>
+#include <raptor/argument_parsing/latency_histogram.hpp>
 #include <raptor/argument_parsing/memory_usage.hpp>
+#include <raptor/argument_parsing/perf_counters.hpp>
+#include <raptor/argument_parsing/trace_recorder.hpp>
+#include <raptor/bin_path_table.hpp>
 #include <raptor/threshold/threshold_parameters.hpp>
 
 namespace raptor
@@ -43,16 +49,28 @@ struct search_arguments
 
     // Related to IBF
     std::filesystem::path index_file{};
+    uint64_t hibf_cache_size{}; // In MiB. If not 0, the lower levels of the HIBF are loaded on demand.
+    uint8_t hibf_resident_levels{1u};
+    size_t hibf_batch_size{1024u}; // Reads that traverse the HIBF together.
 
     // General arguments
-    std::vector<std::vector<std::string>> bin_path{};
+    bin_path_table bin_path{};
+    std::string bins{};                // Restricts the search to these user bins; see raptor::parse_bin_selection.
+    std::vector<bool> selected_bins{}; // Empty if all user bins are searched.
     std::filesystem::path query_file{};
     std::filesystem::path out_file{"search.out"};
     bool write_time{false};
     bool is_hibf{false};
     bool cache_thresholds{false};
     bool quiet{false};
+    bool compact_header{false};
+    bool perf_counters{false};
+    bool latency{false};
     std::filesystem::path timing_out{};
+    std::filesystem::path trace_out{};
+
+    // Copies share the recorded events
+    trace_recorder trace{};
 
     // FPGA
     bool use_fpga{false};
@@ -70,9 +88,32 @@ struct search_arguments
     mutable seqan::hibf::concurrent_timer complete_search_timer{};
     mutable seqan::hibf::concurrent_timer parallel_search_timer{};
 
+    // Per-read latencies (only recorded if latency is set) and throughput; like the timers, these are not copied
+    mutable concurrent_latency_histogram compute_minimiser_latency{};
+    mutable concurrent_latency_histogram threshold_latency{};
+    mutable concurrent_latency_histogram query_ibf_latency{};
+    mutable concurrent_latency_histogram generate_results_latency{};
+    // An HIBF is queried for a batch of reads at once; see raptor::hibf_batch_agent
+    mutable concurrent_latency_histogram query_hibf_batch_latency{};
+    mutable concurrent_counter query_counter{};
+    mutable concurrent_counter minimiser_counter{};
+
+    // Only recorded if the HIBF is loaded on demand; see raptor::lazy_hibf
+    mutable concurrent_hibf_level_statistics hibf_level_statistics{};
+
+    // Hardware counters per phase; only recorded if perf_counters is set
+    mutable concurrent_perf_counter compute_minimiser_perf{};
+    mutable concurrent_perf_counter query_ibf_perf{};
+    mutable concurrent_perf_counter generate_results_perf{};
+
     void print_timings() const;
     void write_timings_to_file() const;
 
+    bool is_selected(uint64_t const user_bin_id) const noexcept
+    {
+        return selected_bins.empty() || selected_bins[user_bin_id];
+    }
+
     raptor::threshold::threshold_parameters make_threshold_parameters() const noexcept
     {
         return {.window_size = window_size,
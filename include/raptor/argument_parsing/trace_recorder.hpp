@@ -0,0 +1,274 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::trace_recorder.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace raptor
+{
+
+/*!\brief Records spans and writes them in the Chrome trace event format.
+ * \details
+ * The resulting JSON can be opened with `chrome://tracing` or https://ui.perfetto.dev.
+ * A default-constructed recorder is disabled and recording is a no-op. Copies share the recorded events, i.e.,
+ * spans recorded via a copy of the arguments end up in the same trace.
+ *
+ * Each thread appends to its own buffer; the buffers are merged by write(). At most `max_events` events are kept,
+ * further events are only counted and reported as `dropped_events` in the trace.
+ */
+class trace_recorder
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    //!\brief Records a complete event upon destruction.
+    class span
+    {
+    public:
+        span() = default;
+        span(span const &) = delete;
+        span(span && other) noexcept :
+            recorder{std::exchange(other.recorder, nullptr)},
+            name{std::move(other.name)},
+            category{other.category},
+            start{other.start},
+            args{std::move(other.args)}
+        {}
+        span & operator=(span const &) = delete;
+        span & operator=(span &&) = delete;
+        ~span()
+        {
+            stop();
+        }
+
+        //!\brief Ends the span before it goes out of scope. Subsequent calls have no effect.
+        void stop()
+        {
+            if (trace_recorder const * const current = std::exchange(recorder, nullptr); current != nullptr)
+                current->record(std::move(name), category, start, clock::now(), std::move(args));
+        }
+
+        //!\brief Attaches a numerical argument that is displayed when selecting the span.
+        template <typename value_t>
+            requires std::integral<value_t> || std::floating_point<value_t>
+        void add_arg(std::string_view const key, value_t const value)
+        {
+            if (recorder == nullptr)
+                return;
+
+            std::array<char, 32> buffer{};
+            auto const conv = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+
+            args += args.empty() ? "\"" : ",\"";
+            args += key;
+            args += "\":";
+            args.append(buffer.data(), conv.ptr);
+        }
+
+    private:
+        friend class trace_recorder;
+
+        span(trace_recorder const & recorder, std::string_view const name, std::string_view const category) :
+            recorder{std::addressof(recorder)},
+            name{name},
+            category{category},
+            start{clock::now()}
+        {}
+
+        trace_recorder const * recorder{nullptr};
+        std::string name{};
+        std::string_view category{};
+        clock::time_point start{};
+        std::string args{};
+    };
+
+    trace_recorder() = default;
+    trace_recorder(trace_recorder const &) = default;
+    trace_recorder(trace_recorder &&) = default;
+    trace_recorder & operator=(trace_recorder const &) = default;
+    trace_recorder & operator=(trace_recorder &&) = default;
+    ~trace_recorder() = default;
+
+    static constexpr size_t default_max_events{1'000'000};
+
+    //!\brief Starts recording. Timestamps are relative to the time of this call.
+    void enable(size_t const max_events = default_max_events)
+    {
+        state = std::make_shared<state_t>(max_events);
+    }
+
+    bool is_enabled() const noexcept
+    {
+        return state != nullptr;
+    }
+
+    /*!\brief Returns a span that ends when it goes out of scope.
+     * \details
+     * `category` must outlive the recorder, e.g., a string literal.
+     */
+    [[nodiscard]] span scoped(std::string_view const name, std::string_view const category) const
+    {
+        if (!is_enabled())
+            return {};
+
+        return span{*this, name, category};
+    }
+
+    void record(std::string name,
+                std::string_view const category,
+                clock::time_point const start,
+                clock::time_point const end,
+                std::string args = {}) const
+    {
+        if (!is_enabled())
+            return;
+
+        if (state->recorded.fetch_add(1u, std::memory_order_relaxed) >= state->max_events)
+        {
+            state->dropped.fetch_add(1u, std::memory_order_relaxed);
+            return;
+        }
+
+        thread_buffer & buffer = state->local_buffer();
+        std::lock_guard guard{buffer.mutex}; // Only contended while write() runs.
+        buffer.events.push_back({.name = std::move(name),
+                                 .category = category,
+                                 .thread_id = thread_id(),
+                                 .start = start,
+                                 .end = end,
+                                 .args = std::move(args)});
+    }
+
+    //!\brief Writes all recorded events to `path`.
+    void write(std::filesystem::path const & path) const
+    {
+        if (!is_enabled())
+            return;
+
+        std::ofstream output_stream{path};
+        output_stream << std::fixed << std::setprecision(3);
+        std::lock_guard guard{state->mutex};
+
+        output_stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first{true};
+        for (std::unique_ptr<thread_buffer> const & buffer : state->buffers)
+        {
+            std::lock_guard buffer_guard{buffer->mutex};
+            for (event const & current : buffer->events)
+            {
+                output_stream << (first ? "\n" : ",\n");
+                first = false;
+
+                output_stream << "{\"name\":\"";
+                write_escaped(output_stream, current.name);
+                output_stream << "\",\"cat\":\"";
+                write_escaped(output_stream, current.category);
+                output_stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << current.thread_id
+                              << ",\"ts\":" << microseconds_since(state->origin, current.start)
+                              << ",\"dur\":" << microseconds_since(current.start, current.end) << ",\"args\":{"
+                              << current.args << "}}";
+            }
+        }
+        output_stream << "\n],\"otherData\":{\"dropped_events\":" << state->dropped.load(std::memory_order_relaxed)
+                      << "}}\n";
+    }
+
+private:
+    struct event
+    {
+        std::string name{};
+        std::string_view category{};
+        size_t thread_id{};
+        clock::time_point start{};
+        clock::time_point end{};
+        std::string args{};
+    };
+
+    struct thread_buffer
+    {
+        std::mutex mutex{};
+        std::vector<event> events{};
+    };
+
+    struct state_t
+    {
+        explicit state_t(size_t const max_events) : max_events{max_events}
+        {}
+
+        clock::time_point const origin{clock::now()};
+        size_t const max_events{};
+        uint64_t const id{next_state_id.fetch_add(1u, std::memory_order_relaxed)};
+        std::atomic<size_t> recorded{};
+        std::atomic<size_t> dropped{};
+        std::mutex mutex{}; // Guards buffers.
+        std::vector<std::unique_ptr<thread_buffer>> buffers{};
+
+        //!\brief The buffer of the calling thread. Only locks the first time a thread records an event.
+        thread_buffer & local_buffer()
+        {
+            // IDs are never reused, unlike the addresses of destroyed states.
+            thread_local uint64_t cached_id{};
+            thread_local thread_buffer * cached_buffer{};
+            if (cached_buffer == nullptr || cached_id != id)
+            {
+                std::lock_guard guard{mutex};
+                cached_buffer = buffers.emplace_back(std::make_unique<thread_buffer>()).get();
+                cached_id = id;
+            }
+            return *cached_buffer;
+        }
+    };
+
+    static inline std::atomic<uint64_t> next_state_id{1u};
+
+    std::shared_ptr<state_t> state{};
+
+    //!\brief Threads are numbered in the order in which they first record an event.
+    static size_t thread_id() noexcept
+    {
+        static std::atomic<size_t> next_id{};
+        thread_local size_t const id = next_id.fetch_add(1u, std::memory_order_relaxed);
+        return id;
+    }
+
+    static double microseconds_since(clock::time_point const from, clock::time_point const to) noexcept
+    {
+        return std::chrono::duration<double, std::micro>(to - from).count();
+    }
+
+    static void write_escaped(std::ostream & output_stream, std::string_view const str)
+    {
+        for (char const c : str)
+        {
+            if (c == '"' || c == '\\')
+                output_stream << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                output_stream << ' ';
+            else
+                output_stream << c;
+        }
+    }
+};
+
+} // namespace raptor
@@ -14,6 +14,8 @@
 
 #include <seqan3/search/kmer_index/shape.hpp>
 
+#include <raptor/argument_parsing/trace_recorder.hpp>
+
 namespace raptor
 {
 
@@ -26,6 +28,10 @@ struct update_arguments
     std::filesystem::path bin_file{};
     uint8_t threads{1u};
     bool input_is_minimiser{false};
+    std::filesystem::path trace_out{};
+
+    // Copies share the recorded events
+    trace_recorder trace{};
 
     uint32_t window_size{20u};
     seqan3::shape shape{seqan3::ungapped{20u}};
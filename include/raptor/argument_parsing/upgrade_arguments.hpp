@@ -32,6 +32,11 @@ struct upgrade_arguments
     std::filesystem::path output_file{};
 
     std::vector<std::vector<std::string>> bin_path{};
+
+    // Conversion of Raptor 4.0 indexes to the sectioned index format.
+    bool sectioned{false};
+    bool compress{false};
+    bool is_hibf{false};
 };
 
 } // namespace raptor
@@ -13,6 +13,7 @@
 
 #include <seqan3/io/sequence_file/input.hpp>
 
+#include <raptor/minimiser_container.hpp>
 #include <raptor/strong_types.hpp>
 
 namespace raptor::detail
@@ -184,6 +185,14 @@ public:
 
                 if (is_minimiser_input && (file_path.extension() != ".minimiser"))
                     throw sharg::validation_error{"You cannot mix sequence and minimiser files as input."};
+
+                if (std::optional<minimiser_container::entry> const entry = minimiser_container::find(file_path))
+                {
+                    if (entry->size == 0u)
+                        throw sharg::validation_error{"The file " + value + " is empty."};
+                    continue;
+                }
+
                 if (!std::filesystem::exists(file_path))
                     throw sharg::validation_error{"The file " + value + " does not exist."};
                 if (std::filesystem::file_size(file_path) == 0u)
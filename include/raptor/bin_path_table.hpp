@@ -0,0 +1,300 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::bin_path_table.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+namespace raptor
+{
+
+/*!\brief The file names of all user bins as a front-coded string table.
+ * \details
+ * The user bins are grouped into buckets of `bucket_size` user bins. Within a bucket, each file name is stored as the
+ * length of the prefix it shares with the previous file name, and the remaining suffix. The first file name of a
+ * bucket is stored as is. Lengths are LEB128 varints. Each user bin starts with the number of its files.
+ *
+ * File names of the same data set usually share long prefixes, e.g., the directory. The table is a single string
+ * instead of one allocation per file name, and loading it does not parse any file names.
+ * The file names of a user bin are decoded on demand, which decodes at most `bucket_size - 1` other user bins.
+ *
+ * Tables whose size is a multiple of `bucket_size` can be concatenated without decoding.
+ */
+class bin_path_table
+{
+public:
+    static constexpr size_t bucket_size{16u};
+
+    bin_path_table() = default;
+    bin_path_table(bin_path_table const &) = default;
+    bin_path_table(bin_path_table &&) = default;
+    bin_path_table & operator=(bin_path_table const &) = default;
+    bin_path_table & operator=(bin_path_table &&) = default;
+    ~bin_path_table() = default;
+
+    explicit bin_path_table(std::vector<std::vector<std::string>> const & bin_path)
+    {
+        for (auto const & file_names : bin_path)
+            push_back(file_names);
+    }
+
+    //!\brief The number of user bins.
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0u;
+    }
+
+    //!\brief The size of the encoded table in bytes.
+    size_t encoded_size() const noexcept
+    {
+        return data_.size() + bucket_offsets_.size() * sizeof(uint64_t);
+    }
+
+    //!\brief The file names of a user bin.
+    std::vector<std::string> operator[](size_t const user_bin_id) const
+    {
+        std::vector<std::string> result{};
+        for_each_file(user_bin_id,
+                      [&result](std::string_view const file_name)
+                      {
+                          result.emplace_back(file_name);
+                      });
+        return result;
+    }
+
+    //!\brief Calls `fn(std::string_view)` for each file name of a user bin.
+    template <typename fn_t>
+    void for_each_file(size_t const user_bin_id, fn_t && fn) const
+    {
+        assert(user_bin_id < size_);
+        decode_bucket(user_bin_id / bucket_size,
+                      user_bin_id + 1u,
+                      [&](size_t const current_id, std::string_view const file_name)
+                      {
+                          if (current_id == user_bin_id)
+                              fn(file_name);
+                      });
+    }
+
+    void push_back(std::vector<std::string> const & file_names)
+    {
+        if (size_ % bucket_size == 0u)
+        {
+            bucket_offsets_.push_back(data_.size());
+            previous_.clear();
+            previous_is_valid_ = true;
+        }
+        else if (!previous_is_valid_)
+        {
+            decode_bucket(bucket_offsets_.size() - 1u,
+                          size_,
+                          [&](size_t, std::string_view const file_name)
+                          {
+                              previous_ = file_name;
+                          });
+            previous_is_valid_ = true;
+        }
+
+        write_varint(file_names.size());
+        for (std::string const & file_name : file_names)
+        {
+            auto const mismatch = std::ranges::mismatch(previous_, file_name);
+            size_t const prefix = std::distance(previous_.begin(), mismatch.in1);
+            write_varint(prefix);
+            write_varint(file_name.size() - prefix);
+            data_.append(file_name, prefix);
+            previous_ = file_name;
+        }
+
+        ++size_;
+    }
+
+    //!\brief Appends all user bins of `other`.
+    void append(bin_path_table const & other)
+    {
+        if (size_ % bucket_size != 0u)
+        {
+            for (size_t i = 0; i < other.size(); ++i)
+                push_back(other[i]);
+            return;
+        }
+
+        uint64_t const offset = data_.size();
+        data_.append(other.data_);
+        for (uint64_t const bucket_offset : other.bucket_offsets_)
+            bucket_offsets_.push_back(bucket_offset + offset);
+        size_ += other.size_;
+        previous_ = other.previous_;
+        previous_is_valid_ = other.previous_is_valid_;
+    }
+
+    /*!\brief The user bins `[first, first + count)` as a table.
+     * \details
+     * `first` must be a multiple of `bucket_size`. The buckets are copied without decoding them.
+     */
+    bin_path_table subtable(size_t const first, size_t const count) const
+    {
+        assert(first % bucket_size == 0u);
+        assert(first + count <= size_);
+
+        bin_path_table result{};
+        if (count == 0u)
+            return result;
+
+        uint64_t const begin = bucket_offsets_[first / bucket_size];
+        uint64_t const end = offset_of(first + count);
+        result.data_ = data_.substr(begin, end - begin);
+        for (size_t bucket = first / bucket_size; bucket * bucket_size < first + count; ++bucket)
+            result.bucket_offsets_.push_back(bucket_offsets_[bucket] - begin);
+        result.size_ = count;
+        result.previous_is_valid_ = false;
+        return result;
+    }
+
+    std::vector<std::vector<std::string>> to_vector() const
+    {
+        std::vector<std::vector<std::string>> result(size_);
+        for (size_t bucket = 0; bucket < bucket_offsets_.size(); ++bucket)
+            decode_bucket(bucket,
+                          std::min(size_, (bucket + 1u) * bucket_size),
+                          [&result](size_t const user_bin_id, std::string_view const file_name)
+                          {
+                              result[user_bin_id].emplace_back(file_name);
+                          });
+        return result;
+    }
+
+    friend bool operator==(bin_path_table const & lhs, bin_path_table const & rhs) noexcept
+    {
+        return lhs.size_ == rhs.size_ && lhs.bucket_offsets_ == rhs.bucket_offsets_ && lhs.data_ == rhs.data_;
+    }
+
+    /*!\cond DEV
+     * \brief Serialisation support function.
+     * \tparam archive_t Type of `archive`; must satisfy seqan3::cereal_archive.
+     * \param[in] archive The archive being serialised from/to.
+     *
+     * \attention These functions are never called directly.
+     * \sa https://docs.seqan.de/seqan/3.2.0/group__io.html#serialisation
+     */
+    template <typename archive_t>
+    void CEREAL_SERIALIZE_FUNCTION_NAME(archive_t & archive)
+    {
+        archive(size_);
+        archive(bucket_offsets_);
+        archive(data_);
+        previous_is_valid_ = false;
+
+        if (bucket_offsets_.size() != (size_ + bucket_size - 1u) / bucket_size
+            || std::ranges::any_of(bucket_offsets_,
+                                   [this](uint64_t const offset)
+                                   {
+                                       return offset > data_.size();
+                                   }))
+            throw std::runtime_error{"The bin path table is corrupted."};
+    }
+    //!\endcond
+
+private:
+    uint64_t size_{};
+    std::vector<uint64_t> bucket_offsets_{};
+    std::string data_{};
+
+    // The last file name of the last bucket. Needed to encode the next file name.
+    std::string previous_{};
+    bool previous_is_valid_{true};
+
+    void write_varint(uint64_t value)
+    {
+        while (value >= 0x80u)
+        {
+            data_.push_back(static_cast<char>((value & 0x7Fu) | 0x80u));
+            value >>= 7;
+        }
+        data_.push_back(static_cast<char>(value));
+    }
+
+    uint64_t read_varint(size_t & position) const
+    {
+        uint64_t value{};
+        for (size_t shift = 0u; shift < 64u; shift += 7u)
+        {
+            if (position >= data_.size())
+                break;
+
+            uint8_t const byte = static_cast<uint8_t>(data_[position++]);
+            value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+            if (!(byte & 0x80u))
+                return value;
+        }
+        throw std::runtime_error{"The bin path table is corrupted."};
+    }
+
+    //!\brief Calls `fn(user_bin_id, file_name)` for the user bins of a bucket, up to the user bin `end`.
+    template <typename fn_t>
+    void decode_bucket(size_t const bucket, size_t const end, fn_t && fn) const
+    {
+        size_t position = bucket_offsets_[bucket];
+        std::string file_name{};
+
+        for (size_t user_bin_id = bucket * bucket_size; user_bin_id < end; ++user_bin_id)
+        {
+            uint64_t const file_count = read_varint(position);
+            for (uint64_t i = 0; i < file_count; ++i)
+            {
+                uint64_t const prefix = read_varint(position);
+                uint64_t const suffix = read_varint(position);
+                if (prefix > file_name.size() || suffix > data_.size() - position)
+                    throw std::runtime_error{"The bin path table is corrupted."};
+
+                file_name.resize(prefix);
+                file_name.append(data_, position, suffix);
+                position += suffix;
+                fn(user_bin_id, std::string_view{file_name});
+            }
+        }
+    }
+
+    //!\brief The offset of the first byte of a user bin.
+    uint64_t offset_of(size_t const user_bin_id) const
+    {
+        if (user_bin_id == size_)
+            return data_.size();
+        if (user_bin_id % bucket_size == 0u)
+            return bucket_offsets_[user_bin_id / bucket_size];
+
+        size_t position = bucket_offsets_[user_bin_id / bucket_size];
+        for (size_t current = user_bin_id / bucket_size * bucket_size; current < user_bin_id; ++current)
+        {
+            uint64_t const file_count = read_varint(position);
+            for (uint64_t i = 0; i < file_count; ++i)
+            {
+                read_varint(position);
+                position += read_varint(position);
+            }
+        }
+        return position;
+    }
+};
+
+} // namespace raptor
@@ -0,0 +1,296 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::detail::compressing_buffer and raptor::detail::decompressing_buffer.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <omp.h>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+#ifdef SEQAN3_HAS_ZLIB
+#    include <zlib.h>
+#endif
+
+namespace raptor::detail
+{
+
+#ifdef SEQAN3_HAS_ZLIB
+inline constexpr bool has_block_compression{true};
+#else
+inline constexpr bool has_block_compression{false};
+#endif
+
+/*!\brief The uncompressed size of a block.
+ * \details
+ * zlib decompresses a few hundred MB/s per thread. Each thread decompresses one block at a time, so the blocks must be
+ * big enough to keep all threads busy between reads, but small enough to keep the buffered data small.
+ */
+inline constexpr size_t compression_block_size{1ULL << 22};
+
+/*!\brief A stream buffer that compresses everything written to it in blocks.
+ * \details
+ * Each block is a frame: The uncompressed size (uint32_t), the compressed size (uint32_t), and the zlib data.
+ * `threads` blocks are buffered and compressed in parallel. Call `finish()` after the last write.
+ */
+class compressing_buffer : public std::streambuf
+{
+public:
+    compressing_buffer() = delete;
+    compressing_buffer(compressing_buffer const &) = delete;
+    compressing_buffer(compressing_buffer &&) = delete;
+    compressing_buffer & operator=(compressing_buffer const &) = delete;
+    compressing_buffer & operator=(compressing_buffer &&) = delete;
+    ~compressing_buffer() override = default;
+
+    compressing_buffer(std::ostream & sink, uint8_t const threads) :
+        sink{std::addressof(sink)},
+        threads{std::max<uint8_t>(threads, 1u)},
+        buffer(this->threads * compression_block_size),
+        frames(this->threads)
+    {
+        if constexpr (!has_block_compression)
+            throw std::runtime_error{"Raptor was built without zlib. Compression is not available."};
+
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    //!\brief Compresses and writes the remaining data.
+    void finish()
+    {
+        write_blocks();
+    }
+
+    //!\brief The number of bytes written to the buffer.
+    size_t raw_size() const noexcept
+    {
+        return raw_bytes + (pptr() - pbase());
+    }
+
+    //!\brief The number of bytes written to the sink.
+    size_t compressed_size() const noexcept
+    {
+        return compressed_bytes;
+    }
+
+protected:
+    int_type overflow(int_type const character) override
+    {
+        write_blocks();
+        if (!traits_type::eq_int_type(character, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(character);
+            pbump(1);
+        }
+        return traits_type::not_eof(character);
+    }
+
+    std::streamsize xsputn(char const * data, std::streamsize const size) override
+    {
+        std::streamsize written{};
+        while (written < size)
+        {
+            if (pptr() == epptr())
+                write_blocks();
+
+            std::streamsize const chunk = std::min<std::streamsize>(size - written, epptr() - pptr());
+            std::memcpy(pptr(), data + written, chunk);
+            pbump(static_cast<int>(chunk));
+            written += chunk;
+        }
+        return size;
+    }
+
+private:
+    std::ostream * sink{nullptr};
+    uint8_t threads{};
+    std::vector<char> buffer{};
+    std::vector<std::vector<char>> frames{};
+    size_t raw_bytes{};
+    size_t compressed_bytes{};
+
+    void write_blocks()
+    {
+        size_t const used = pptr() - pbase();
+        size_t const blocks = (used + compression_block_size - 1u) / compression_block_size;
+        std::atomic_bool failed{false};
+
+#pragma omp parallel for schedule(static) num_threads(threads)
+        for (size_t i = 0; i < blocks; ++i)
+        {
+            size_t const begin = i * compression_block_size;
+            size_t const size = std::min(compression_block_size, used - begin);
+            failed = failed || !compress(buffer.data() + begin, size, frames[i]);
+        }
+
+        if (failed)
+            throw std::runtime_error{"Could not compress the index."};
+
+        for (size_t i = 0; i < blocks; ++i)
+        {
+            sink->write(frames[i].data(), frames[i].size());
+            compressed_bytes += frames[i].size();
+        }
+
+        raw_bytes += used;
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    static bool
+    compress([[maybe_unused]] char const * data, [[maybe_unused]] size_t const size, std::vector<char> & frame)
+    {
+#ifdef SEQAN3_HAS_ZLIB
+        uLongf compressed_size = compressBound(size);
+        frame.resize(2u * sizeof(uint32_t) + compressed_size);
+        int const status = compress2(reinterpret_cast<Bytef *>(frame.data() + 2u * sizeof(uint32_t)),
+                                     &compressed_size,
+                                     reinterpret_cast<Bytef const *>(data),
+                                     size,
+                                     Z_BEST_SPEED);
+        if (status != Z_OK)
+            return false;
+
+        std::array<uint32_t, 2> const sizes{static_cast<uint32_t>(size), static_cast<uint32_t>(compressed_size)};
+        std::memcpy(frame.data(), sizes.data(), sizeof(sizes));
+        frame.resize(sizeof(sizes) + compressed_size);
+        return true;
+#else
+        frame.clear();
+        return false;
+#endif
+    }
+};
+
+/*!\brief A stream buffer that reads `size` bytes written by raptor::detail::compressing_buffer.
+ * \details
+ * Up to `threads` frames are read at once and decompressed in parallel.
+ */
+class decompressing_buffer : public std::streambuf
+{
+public:
+    decompressing_buffer() = delete;
+    decompressing_buffer(decompressing_buffer const &) = delete;
+    decompressing_buffer(decompressing_buffer &&) = delete;
+    decompressing_buffer & operator=(decompressing_buffer const &) = delete;
+    decompressing_buffer & operator=(decompressing_buffer &&) = delete;
+    ~decompressing_buffer() override = default;
+
+    decompressing_buffer(std::istream & source, uint64_t const size, uint8_t const threads) :
+        source{std::addressof(source)},
+        remaining{size},
+        threads{std::max<uint8_t>(threads, 1u)}
+    {
+        if constexpr (!has_block_compression)
+            throw std::runtime_error{"Raptor was built without zlib. The index is compressed and cannot be read."};
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() == egptr() && !read_blocks())
+            return traits_type::eof();
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize xsgetn(char * data, std::streamsize const size) override
+    {
+        std::streamsize read{};
+        while (read < size)
+        {
+            if (gptr() == egptr() && !read_blocks())
+                break;
+
+            std::streamsize const chunk = std::min<std::streamsize>(size - read, egptr() - gptr());
+            std::memcpy(data + read, gptr(), chunk);
+            gbump(static_cast<int>(chunk));
+            read += chunk;
+        }
+        return read;
+    }
+
+private:
+    struct frame
+    {
+        std::vector<char> data{};
+        size_t raw_offset{};
+        size_t raw_size{};
+    };
+
+    std::istream * source{nullptr};
+    uint64_t remaining{};
+    uint8_t threads{};
+    std::vector<char> buffer{};
+    std::vector<frame> frames{};
+
+    bool read_blocks()
+    {
+        frames.clear();
+        size_t raw_size{};
+
+        while (remaining != 0u && frames.size() < threads)
+        {
+            std::array<uint32_t, 2> sizes{};
+            if (remaining < sizeof(sizes) || !source->read(reinterpret_cast<char *>(sizes.data()), sizeof(sizes)))
+                throw std::runtime_error{"The compressed index is truncated."};
+            remaining -= sizeof(sizes);
+
+            if (sizes[0] > compression_block_size || sizes[1] > remaining)
+                throw std::runtime_error{"The compressed index is corrupted."};
+
+            frame & current = frames.emplace_back();
+            current.data.resize(sizes[1]);
+            current.raw_offset = raw_size;
+            current.raw_size = sizes[0];
+            if (!source->read(current.data.data(), sizes[1]))
+                throw std::runtime_error{"The compressed index is truncated."};
+            remaining -= sizes[1];
+            raw_size += sizes[0];
+        }
+
+        if (frames.empty())
+            return false;
+
+        buffer.resize(raw_size);
+        std::atomic_bool failed{false};
+
+#pragma omp parallel for schedule(static) num_threads(threads)
+        for (size_t i = 0; i < frames.size(); ++i)
+            failed = failed || !decompress(frames[i], buffer.data() + frames[i].raw_offset);
+
+        if (failed)
+            throw std::runtime_error{"The compressed index is corrupted."};
+
+        setg(buffer.data(), buffer.data(), buffer.data() + buffer.size());
+        return true;
+    }
+
+    static bool decompress([[maybe_unused]] frame const & current, [[maybe_unused]] char * target)
+    {
+#ifdef SEQAN3_HAS_ZLIB
+        uLongf size = current.raw_size;
+        int const status = uncompress(reinterpret_cast<Bytef *>(target),
+                                      &size,
+                                      reinterpret_cast<Bytef const *>(current.data.data()),
+                                      current.data.size());
+        return status == Z_OK && size == current.raw_size;
+#else
+        return false;
+#endif
+    }
+};
+
+} // namespace raptor::detail
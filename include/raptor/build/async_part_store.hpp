@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::async_part_store.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <utility>
+
+#include <raptor/argument_parsing/build_arguments.hpp>
+#include <raptor/build/store_index.hpp>
+#include <raptor/index.hpp>
+
+namespace raptor
+{
+
+/*!\brief Stores the parts of a partitioned index in the background.
+ * \details
+ * `push` returns as soon as the part is handed to a background thread, such that the next part can be built while the
+ * previous one is serialised. Before a part is handed over, `push` waits for older parts until the memory of all parts
+ * that are still being stored does not exceed `build_arguments::store_memory`. At least one part is always stored in
+ * the background, i.e., a limit of 0 means that storing part `p` overlaps with building part `p + 1`.
+ * The time spent storing is recorded in `build_arguments::store_index_timer`.
+ */
+class async_part_store
+{
+public:
+    async_part_store() = delete;
+    async_part_store(async_part_store const &) = delete;
+    async_part_store(async_part_store &&) = delete;
+    async_part_store & operator=(async_part_store const &) = delete;
+    async_part_store & operator=(async_part_store &&) = delete;
+
+    ~async_part_store()
+    {
+        // Exceptions are only propagated by wait().
+        for (auto & [future, bytes] : in_flight)
+            if (future.valid())
+                future.wait();
+    }
+
+    explicit async_part_store(build_arguments const & args) : arguments{std::addressof(args)}
+    {}
+
+    void push(std::filesystem::path path, raptor_index<> && index, size_t const part)
+    {
+        size_t const bytes = index.ibf().bit_size() / 8u;
+
+        while (!in_flight.empty() && in_flight_bytes + bytes > arguments->store_memory)
+            pop();
+
+        auto store = [arguments = arguments, path = std::move(path), part](raptor_index<> && index)
+        {
+            auto span = arguments->trace.scoped("Store index", "io");
+            span.add_arg("part", part);
+            seqan::hibf::serial_timer local_timer{};
+            local_timer.start();
+            store_index(path, std::move(index), 1u, arguments->compress);
+            local_timer.stop();
+            arguments->store_index_timer += local_timer;
+        };
+
+        in_flight.emplace_back(std::async(std::launch::async, std::move(store), std::move(index)), bytes);
+        in_flight_bytes += bytes;
+    }
+
+    //!\brief Waits until all parts are stored. Rethrows exceptions that occurred while storing.
+    void wait()
+    {
+        while (!in_flight.empty())
+            pop();
+    }
+
+private:
+    build_arguments const * arguments{nullptr};
+    std::deque<std::pair<std::future<void>, size_t>> in_flight{};
+    size_t in_flight_bytes{};
+
+    void pop()
+    {
+        auto [future, bytes] = std::move(in_flight.front());
+        in_flight.pop_front();
+        in_flight_bytes -= bytes;
+        future.get();
+    }
+};
+
+} // namespace raptor
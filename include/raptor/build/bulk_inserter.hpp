@@ -0,0 +1,284 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::bulk_inserter.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <hibf/interleaved_bloom_filter.hpp>
+#include <hibf/misc/divide_and_ceil.hpp>
+
+namespace raptor
+{
+
+namespace detail
+{
+
+/*!\brief Computes the words that `seqan::hibf::interleaved_bloom_filter::emplace` modifies.
+ * \details
+ * This is a replica of the IBF's `hash_and_fit`. Because the number of technical bins is a multiple of 64, all bits of
+ * a user bin `b` are in the word column `b / 64` and at bit `b % 64`.
+ * The unit test `bulk_inserter.replica_matches_ibf` checks that the replica matches the IBF. If the IBF implementation
+ * changes, this test fails and the replica has to be updated.
+ */
+class ibf_positions
+{
+public:
+    ibf_positions() = default;
+    ibf_positions(ibf_positions const &) = default;
+    ibf_positions(ibf_positions &&) = default;
+    ibf_positions & operator=(ibf_positions const &) = default;
+    ibf_positions & operator=(ibf_positions &&) = default;
+    ~ibf_positions() = default;
+
+    explicit ibf_positions(seqan::hibf::interleaved_bloom_filter const & ibf) :
+        bin_size{ibf.bin_size()},
+        bin_words{ibf.bit_size() / ibf.bin_size() / 64u},
+        hash_shift{std::countl_zero(bin_size)},
+        hash_count{ibf.hash_function_count()}
+    {
+        assert(hash_count > 0u && hash_count <= hash_seeds.size());
+    }
+
+    //!\brief For an IBF with the given parameters that is not allocated, see raptor::detail::sliced_index_writer.
+    ibf_positions(seqan::hibf::bin_count const bins,
+                  seqan::hibf::bin_size const size,
+                  seqan::hibf::hash_function_count const functions) :
+        bin_size{size.value},
+        bin_words{seqan::hibf::divide_and_ceil(bins.value, 64u)},
+        hash_shift{std::countl_zero(bin_size)},
+        hash_count{functions.value}
+    {
+        assert(hash_count > 0u && hash_count <= hash_seeds.size());
+    }
+
+    size_t hash_function_count() const noexcept
+    {
+        return hash_count;
+    }
+
+    //!\brief The index of the word that hash function `i` sets for `value` in the first word column.
+    size_t word(uint64_t value, size_t const i) const noexcept
+    {
+        value *= hash_seeds[i];
+        value ^= value >> hash_shift;
+        value *= 11'400'714'819'323'198'485ULL;
+#ifdef __SIZEOF_INT128__
+        value = static_cast<uint64_t>((static_cast<__uint128_t>(value) * static_cast<__uint128_t>(bin_size)) >> 64);
+#else
+        value %= bin_size;
+#endif
+        return value * bin_words;
+    }
+
+private:
+    // Same as seqan::hibf::interleaved_bloom_filter::hash_seeds.
+    static constexpr std::array<size_t, 5> hash_seeds{13'572'355'802'537'770'549ULL,
+                                                      13'043'817'825'332'782'213ULL,
+                                                      10'650'232'656'628'343'401ULL,
+                                                      16'499'269'484'942'379'435ULL,
+                                                      4'893'150'838'803'335'377ULL};
+
+    size_t bin_size{};
+    size_t bin_words{};
+    int hash_shift{};
+    size_t hash_count{};
+};
+
+} // namespace detail
+
+/*!\brief Buffers the minimisers of a user bin and inserts them in memory order.
+ * \details
+ * `emplace` touches one random cache line per hash function. Instead, the bulk inserter buffers minimisers, computes
+ * the words that need to be modified, partitions them by memory block (counting sort), and sets the bits block by
+ * block. Each block (256 KiB) fits into the L2 cache.
+ *
+ * There must be one bulk inserter per thread. Bits are set atomically because user bins of different threads may
+ * share a word. `call_parallel_on_bins` assigns chunks of 64 user bins to threads if there are at least 64 user bins
+ * per thread; in this case, each thread owns its word columns and there is no false sharing.
+ */
+class bulk_inserter
+{
+public:
+    bulk_inserter() = delete;
+    bulk_inserter(bulk_inserter const &) = delete;
+    bulk_inserter(bulk_inserter &&) = delete;
+    bulk_inserter & operator=(bulk_inserter const &) = delete;
+    bulk_inserter & operator=(bulk_inserter &&) = delete;
+
+    ~bulk_inserter()
+    {
+        flush();
+    }
+
+    explicit bulk_inserter(seqan::hibf::interleaved_bloom_filter & ibf, detail::ibf_positions const & positions) :
+        ibf{std::addressof(ibf)},
+        positions{std::addressof(positions)}
+    {
+        size_t const words = ibf.bit_size() / 64u;
+        block_shift = std::max(min_block_shift, static_cast<int>(std::bit_width(words)) - max_block_bits);
+        block_count = (words >> block_shift) + 1u;
+        values.reserve(buffer_size);
+    }
+
+    class iterator;
+
+    //!\brief Returns an output iterator that inserts into the given user bin.
+    iterator emplacer(seqan::hibf::bin_index const bin);
+
+    void push(uint64_t const value, size_t const bin)
+    {
+        if (bin != current_bin)
+        {
+            flush();
+            current_bin = bin;
+        }
+
+        values.push_back(value);
+
+        if (values.size() == buffer_size)
+            flush();
+    }
+
+    //!\brief Inserts a block of minimisers into the given user bin.
+    void insert(std::span<uint64_t const> hashes, seqan::hibf::bin_index const bin)
+    {
+        if (bin.value != current_bin)
+        {
+            flush();
+            current_bin = bin.value;
+        }
+
+        while (!hashes.empty())
+        {
+            size_t const count = std::min(buffer_size - values.size(), hashes.size());
+            values.insert(values.end(), hashes.begin(), hashes.begin() + count);
+            hashes = hashes.subspan(count);
+
+            if (values.size() == buffer_size)
+                flush();
+        }
+    }
+
+    //!\brief Inserts all buffered minimisers.
+    void flush()
+    {
+        if (values.empty())
+            return;
+
+        size_t const column = current_bin / 64u;
+        uint64_t const mask = 1ULL << (current_bin % 64u);
+        size_t const hash_count = positions->hash_function_count();
+
+        words.resize(values.size() * hash_count);
+        auto word_it = words.begin();
+        for (uint64_t const value : values)
+            for (size_t i = 0; i < hash_count; ++i)
+                *word_it++ = positions->word(value, i) + column;
+        values.clear();
+
+        if (block_count > 1u)
+        {
+            counts.assign(block_count + 1u, 0u);
+            for (size_t const word : words)
+                ++counts[(word >> block_shift) + 1u];
+            for (size_t i = 1; i < counts.size(); ++i)
+                counts[i] += counts[i - 1u];
+
+            partitioned.resize(words.size());
+            for (size_t const word : words)
+                partitioned[counts[word >> block_shift]++] = word;
+            std::swap(words, partitioned);
+        }
+
+        uint64_t * const data = ibf->raw_data().data();
+        for (size_t const word : words)
+            std::atomic_ref<uint64_t>{data[word]}.fetch_or(mask, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t buffer_size{1ULL << 20};
+    static constexpr int min_block_shift{15}; // 2^15 words = 256 KiB
+    static constexpr int max_block_bits{16};  // At most 2^16 blocks
+
+    seqan::hibf::interleaved_bloom_filter * ibf{nullptr};
+    detail::ibf_positions const * positions{nullptr};
+    int block_shift{};
+    size_t block_count{};
+    size_t current_bin{};
+
+    std::vector<uint64_t> values{};
+    std::vector<size_t> words{};
+    std::vector<size_t> partitioned{};
+    std::vector<size_t> counts{};
+};
+
+class bulk_inserter::iterator
+{
+public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    iterator() = delete;
+    iterator(iterator const &) = default;
+    iterator(iterator &&) = default;
+    iterator & operator=(iterator const &) = default;
+    iterator & operator=(iterator &&) = default;
+    ~iterator() = default;
+
+    explicit constexpr iterator(bulk_inserter & inserter, seqan::hibf::bin_index const idx) :
+        inserter{std::addressof(inserter)},
+        index{idx}
+    {}
+
+    iterator & operator=(uint64_t const value)
+    {
+        assert(inserter != nullptr);
+        inserter->push(value, index.value);
+        return *this;
+    }
+
+    [[nodiscard]] constexpr iterator & operator*() noexcept
+    {
+        return *this;
+    }
+
+    constexpr iterator & operator++() noexcept
+    {
+        return *this;
+    }
+
+    constexpr iterator operator++(int) noexcept
+    {
+        return *this;
+    }
+
+private:
+    bulk_inserter * inserter{nullptr};
+    seqan::hibf::bin_index index{};
+};
+
+inline bulk_inserter::iterator bulk_inserter::emplacer(seqan::hibf::bin_index const bin)
+{
+    return iterator{*this, bin};
+}
+
+} // namespace raptor
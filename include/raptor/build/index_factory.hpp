@@ -12,12 +12,13 @@
 #include <seqan3/search/views/minimiser_hash.hpp>
 
 #include <raptor/adjust_seed.hpp>
-#include <raptor/build/emplace_iterator.hpp>
+#include <raptor/build/bulk_inserter.hpp>
 #include <raptor/build/partition_config.hpp>
 #include <raptor/call_parallel_on_bins.hpp>
 #include <raptor/dna4_traits.hpp>
 #include <raptor/file_reader.hpp>
 #include <raptor/index.hpp>
+#include <raptor/record_ranges.hpp>
 
 namespace raptor
 {
@@ -32,7 +33,9 @@ public:
     index_factory & operator=(index_factory &&) = delete;      // const member
     ~index_factory() = default;
 
-    explicit index_factory(build_arguments const & args) : arguments{std::addressof(args)}
+    explicit index_factory(build_arguments const & args) :
+        arguments{std::addressof(args)},
+        bin_path{std::addressof(args.bin_path)}
     {
         if (arguments->input_is_minimiser)
             reader = file_reader<file_types::minimiser>{};
@@ -42,7 +45,8 @@ public:
 
     explicit index_factory(build_arguments const & args, partition_config const & cfg) :
         arguments{std::addressof(args)},
-        config{std::addressof(cfg)}
+        config{std::addressof(cfg)},
+        bin_path{std::addressof(args.bin_path)}
     {
         if (arguments->input_is_minimiser)
             reader = file_reader<file_types::minimiser>{}; // GCOVR_EXCL_LINE
@@ -50,6 +54,14 @@ public:
             reader = file_reader<file_types::sequence>{arguments->shape, arguments->window_size};
     }
 
+    //!\brief Fills the IBF from the minimiser files of a single partition, see raptor::partition_spill.
+    explicit index_factory(build_arguments const & args,
+                           std::vector<std::vector<std::string>> const & spilled_bin_path) :
+        arguments{std::addressof(args)},
+        bin_path{std::addressof(spilled_bin_path)},
+        reader{file_reader<file_types::minimiser>{}}
+    {}
+
     [[nodiscard]] raptor_index<> operator()(size_t const part = 0u) const
     {
         return construct(part);
@@ -58,21 +70,39 @@ public:
 private:
     build_arguments const * const arguments{nullptr};
     partition_config const * const config{nullptr};
+    std::vector<std::vector<std::string>> const * const bin_path{nullptr};
     std::variant<file_reader<file_types::sequence>, file_reader<file_types::minimiser>> reader;
 
     raptor_index<> construct(size_t const part) const
     {
         assert(arguments != nullptr);
 
-        arguments->index_allocation_timer.start();
-        raptor_index<> index{*arguments};
-        arguments->index_allocation_timer.stop();
+        raptor_index<> index = [&]()
+        {
+            auto span = arguments->trace.scoped("Allocate index", "build");
+            span.add_arg("part", part);
+            arguments->index_allocation_timer.start();
+            raptor_index<> result{*arguments};
+            arguments->index_allocation_timer.stop();
+            return result;
+        }();
+
+        detail::ibf_positions const positions{index.ibf()};
+
+        // Large user bins are inserted one after another, and each one uses all threads.
+        std::vector<bool> const large_bins =
+            std::holds_alternative<file_reader<file_types::sequence>>(reader)
+                ? large_user_bins(*bin_path, arguments->threads, record_chunk_size)
+                : std::vector<bool>(bin_path->size());
 
         auto worker = [&](auto && zipped_view)
         {
             seqan::hibf::serial_timer local_timer{};
-            auto & ibf = index.ibf();
+            perf_counter_group const perf_group{arguments->perf_counters};
+            serial_perf_counter local_perf{perf_group};
+            bulk_inserter inserter{index.ibf(), positions};
             local_timer.start();
+            local_perf.start();
             // https://godbolt.org/z/PeKnxzjn1
             for (auto && zipped : zipped_view)
             {
@@ -80,12 +110,22 @@ private:
                     [&](auto const & reader)
                     {
                         auto && [file_names, bin_number] = zipped;
+                        if (large_bins[bin_number])
+                            return;
+
+                        auto span = arguments->trace.scoped("Insert user bin", "build");
+                        span.add_arg("user_bin", bin_number);
+                        span.add_arg("part", part);
 
                         if (config == nullptr)
-                            reader.hash_into(file_names, emplacer(ibf, seqan::hibf::bin_index{bin_number}));
+                            reader.for_each_block(file_names,
+                                                  [&](std::span<uint64_t const> const block)
+                                                  {
+                                                      inserter.insert(block, seqan::hibf::bin_index{bin_number});
+                                                  });
                         else
                             reader.hash_into_if(file_names,
-                                                emplacer(ibf, seqan::hibf::bin_index{bin_number}),
+                                                inserter.emplacer(seqan::hibf::bin_index{bin_number}),
                                                 [&](uint64_t const hash)
                                                 {
                                                     return config->hash_partition(hash) == part;
@@ -93,12 +133,54 @@ private:
                     },
                     reader);
             }
+            inserter.flush();
+            local_perf.stop();
             local_timer.stop();
             arguments->user_bin_io_timer += local_timer;
             arguments->fill_ibf_timer += local_timer;
+            arguments->fill_ibf_perf += local_perf;
         };
 
-        call_parallel_on_bins(worker, arguments->bin_path, arguments->threads);
+        call_parallel_on_bins(worker, *bin_path, arguments->threads);
+
+        for (size_t bin_number = 0; bin_number < bin_path->size(); ++bin_number)
+        {
+            if (!large_bins[bin_number])
+                continue;
+
+            auto const & sequence_reader = std::get<file_reader<file_types::sequence>>(reader);
+            std::vector<record_range> const ranges = record_ranges((*bin_path)[bin_number], record_chunk_size);
+            auto span = arguments->trace.scoped("Insert user bin", "build");
+            span.add_arg("user_bin", bin_number);
+            span.add_arg("part", part);
+            span.add_arg("ranges", ranges.size());
+
+#pragma omp parallel num_threads(arguments->threads)
+            {
+                seqan::hibf::serial_timer local_timer{};
+                perf_counter_group const perf_group{arguments->perf_counters};
+                serial_perf_counter local_perf{perf_group};
+                bulk_inserter inserter{index.ibf(), positions};
+                local_timer.start();
+                local_perf.start();
+#pragma omp for schedule(dynamic)
+                for (size_t i = 0; i < ranges.size(); ++i)
+                {
+                    sequence_reader.for_each_hash(ranges[i],
+                                                  [&](uint64_t const hash)
+                                                  {
+                                                      if (config == nullptr || config->hash_partition(hash) == part)
+                                                          inserter.push(hash, bin_number);
+                                                  });
+                }
+                inserter.flush();
+                local_perf.stop();
+                local_timer.stop();
+                arguments->user_bin_io_timer += local_timer;
+                arguments->fill_ibf_timer += local_timer;
+                arguments->fill_ibf_perf += local_perf;
+            }
+        }
 
         return index;
     }
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::partition_spill.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <raptor/argument_parsing/build_arguments.hpp>
+#include <raptor/build/partition_config.hpp>
+
+namespace raptor
+{
+
+/*!\brief Reads each user bin once and writes its distinct minimisers per partition to temporary files.
+ * \details
+ * Each partition is a raptor::minimiser_container in `<output>.spill/<partition>`: Each thread appends the minimisers
+ * of its user bins to its own shard, and the shard index stores the offset of each user bin. The minimisers have the
+ * same binary format as `raptor prepare`, and the bin paths `<output>.spill/<partition>/<user bin>.minimiser` are
+ * resolved via the shard indices. Hence, each part can be filled via `file_reader<file_types::minimiser>` without
+ * reading and hashing the input again, and there are only `threads` files per partition instead of one per user bin.
+ * Because the minimisers are deduplicated, the number of minimisers of the biggest user bin per partition is exact and
+ * `max_count_per_partition` is not needed.
+ * The temporary files are removed upon destruction, also if the construction fails.
+ */
+class partition_spill
+{
+public:
+    partition_spill() = delete;
+    partition_spill(partition_spill const &) = delete;
+    partition_spill(partition_spill &&) = delete;
+    partition_spill & operator=(partition_spill const &) = delete;
+    partition_spill & operator=(partition_spill &&) = delete;
+    ~partition_spill() = default;
+
+    partition_spill(partition_config const & cfg, build_arguments const & arguments);
+
+    //!\brief The number of minimisers in the biggest user bin of the partition.
+    size_t max_count(size_t const part) const
+    {
+        return max_counts[part];
+    }
+
+    //!\brief One path per user bin, in the same order as `build_arguments::bin_path`.
+    std::vector<std::vector<std::string>> const & bin_path(size_t const part) const
+    {
+        return bin_paths[part];
+    }
+
+    //!\brief Removes the files of a partition once it is no longer needed.
+    void remove(size_t const part) const;
+
+private:
+    //!\brief Removes the directory upon destruction.
+    struct directory_guard
+    {
+        std::filesystem::path path{};
+
+        ~directory_guard()
+        {
+            std::error_code ec{};
+            std::filesystem::remove_all(path, ec);
+        }
+    };
+
+    directory_guard directory{};
+    std::vector<size_t> max_counts{};
+    std::vector<std::vector<std::vector<std::string>>> bin_paths{};
+};
+
+} // namespace raptor
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::detail::sliced_index_writer.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <hibf/misc/divide_and_ceil.hpp>
+
+#include <raptor/argument_parsing/build_arguments.hpp>
+#include <raptor/bin_path_table.hpp>
+#include <raptor/checksum_buffer.hpp>
+#include <raptor/index.hpp>
+#include <raptor/index_sections.hpp>
+#include <raptor/sectioned_index.hpp>
+
+namespace raptor::detail
+{
+
+/*!\brief Writes a raptor::raptor_index (IBF) whose bit vector is passed in slices.
+ * \details
+ * The output is the same as raptor::sectioned_index::store without compression, but the IBF never has to be in memory.
+ * Each slice is a range of rows, i.e., `bin_words` words per hash position.
+ *
+ * The parameter and bin path sections are written by the constructor. The IBF section is a replica of the
+ * serialisation of the IBF and its bit vector; its checksum is computed while the slices are written. `finish()`
+ * writes the section directory again, once the size of the IBF section is known. The stream must be seekable.
+ * The unit test `sliced_index_writer.same_as_store` checks that the output matches raptor::sectioned_index::store for
+ * several parameter sets. If the IBF implementation changes, this test fails and the replica has to be updated.
+ */
+class sliced_index_writer
+{
+public:
+    sliced_index_writer() = delete;
+    sliced_index_writer(sliced_index_writer const &) = delete;
+    sliced_index_writer(sliced_index_writer &&) = delete;
+    sliced_index_writer & operator=(sliced_index_writer const &) = delete;
+    sliced_index_writer & operator=(sliced_index_writer &&) = delete;
+    ~sliced_index_writer() = default;
+
+    //!\brief Writes everything up to the bit vector.
+    sliced_index_writer(std::ostream & stream, build_arguments const & arguments) :
+        stream{std::addressof(stream)},
+        checked{stream.rdbuf()},
+        checked_stream{&checked},
+        archive{checked_stream},
+        bins{arguments.bins},
+        technical_bins{seqan::hibf::divide_and_ceil(arguments.bins, 64u) * 64u},
+        bin_size{arguments.bits / arguments.parts},
+        bin_words{technical_bins / 64u}
+    {
+        bin_path_table const bin_path{arguments.bin_path};
+
+        sections.push_back({.kind = section_kind::parameters});
+        for (size_t i = 0; i < bin_path.size(); i += sectioned_index::bin_path_chunk_size)
+            sections.push_back({.kind = section_kind::bin_path_table, .id = i});
+        sections.push_back({.kind = section_kind::ibf});
+
+        index_section_table::write(stream, sections); // Written again by finish().
+
+        // raptor::raptor_index without bin paths and IBF, see raptor::sectioned_index.
+        write_section(sections.front(),
+                      [&](cereal::BinaryOutputArchive & parameters)
+                      {
+                          parameters(raptor_index<>::version);
+                          parameters(uint64_t{arguments.window_size});
+                          parameters(arguments.shape);
+                          parameters(arguments.parts);
+                          parameters(std::vector<std::vector<std::string>>{});
+                          parameters(arguments.fpr);
+                          parameters(false); // is_hibf
+                          parameters(seqan::hibf::config{});
+                          parameters(index_structure::ibf{});
+                      });
+
+        for (index_section & current : sections)
+        {
+            if (current.kind != section_kind::bin_path_table)
+                continue;
+
+            write_section(current,
+                          [&](cereal::BinaryOutputArchive & table)
+                          {
+                              size_t const count = std::min(sectioned_index::bin_path_chunk_size,
+                                                            bin_path.size() - current.id);
+                              table(bin_path.subtable(current.id, count));
+                          });
+        }
+
+        index_section_table::pad(stream);
+        sections.back().offset = stream.tellp();
+
+        // seqan::hibf::interleaved_bloom_filter
+        archive(bins);
+        archive(technical_bins);
+        archive(bin_size);
+        archive(static_cast<size_t>(std::countl_zero(bin_size))); // hash_shift
+        archive(bin_words);
+        archive(static_cast<size_t>(arguments.hash));
+
+        // seqan::hibf::bit_vector
+        archive(technical_bins * bin_size);
+        archive(cereal::make_size_tag(static_cast<cereal::size_type>(words())));
+    }
+
+    //!\brief The number of words of the bit vector.
+    size_t words() const noexcept
+    {
+        return bin_size * bin_words;
+    }
+
+    //!\brief The number of words per row.
+    size_t row_words() const noexcept
+    {
+        return bin_words;
+    }
+
+    //!\brief Appends the next words of the bit vector.
+    void write(std::span<uint64_t const> const data)
+    {
+        checked_stream.write(reinterpret_cast<char const *>(data.data()), data.size_bytes());
+        written += data.size();
+    }
+
+    //!\brief Writes everything after the bit vector and the section directory.
+    void finish()
+    {
+        assert(written == words());
+        archive(std::vector<size_t>(technical_bins)); // occupancy
+        archive(false);                               // track_occupancy
+
+        index_section & ibf = sections.back();
+        ibf.size = checked.size();
+        ibf.memory_size = checked.size();
+        ibf.checksum = checked.digest();
+
+        stream->seekp(0);
+        index_section_table::write(*stream, sections);
+        stream->flush();
+    }
+
+private:
+    std::ostream * stream{nullptr};
+    checksum_writer checked; //!< The IBF section.
+    std::ostream checked_stream;
+    cereal::BinaryOutputArchive archive;
+    std::vector<index_section> sections{};
+    size_t bins{};
+    size_t technical_bins{};
+    size_t bin_size{};
+    size_t bin_words{};
+    size_t written{};
+
+    void write_section(index_section & section, auto && writer)
+    {
+        index_section_table::pad(*stream);
+        section.offset = stream->tellp();
+
+        checksum_writer section_checked{stream->rdbuf()};
+        std::ostream section_stream{&section_checked};
+        {
+            cereal::BinaryOutputArchive section_archive{section_stream};
+            writer(section_archive);
+        }
+
+        section.size = section_checked.size();
+        section.memory_size = section_checked.size();
+        section.checksum = section_checked.digest();
+    }
+};
+
+} // namespace raptor::detail
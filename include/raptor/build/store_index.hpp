@@ -10,20 +10,25 @@
 #pragma once
 
 #include <filesystem>
-#include <fstream>
 
 #include <raptor/index.hpp>
+#include <raptor/sectioned_index.hpp>
 #include <raptor/strong_types.hpp>
 
 namespace raptor
 {
 
+/*!\brief Stores an index as raptor::sectioned_index, using `threads` threads.
+ * \details
+ * The file has format version raptor::index_section_table::format_version. Raptor 4.0.0-rc.1 and older cannot read it.
+ */
 template <typename data_t>
-static inline void store_index(std::filesystem::path const & path, raptor_index<data_t> && index)
+static inline void store_index(std::filesystem::path const & path,
+                               raptor_index<data_t> && index,
+                               uint8_t const threads = 1u,
+                               bool const compress = false)
 {
-    std::ofstream os{path, std::ios::binary};
-    cereal::BinaryOutputArchive oarchive{os};
-    oarchive(index);
+    sectioned_index::store(path, std::move(index), threads, compress);
 }
 
 } // namespace raptor
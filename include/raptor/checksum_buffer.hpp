@@ -0,0 +1,242 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::detail::checksum, raptor::detail::checksum_writer, and raptor::detail::checksum_reader.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+namespace raptor::detail
+{
+
+/*!\brief A 64 bit checksum that is computed while the data is written or read.
+ * \details
+ * The data is processed in 64 bit words. The result does not depend on how the data is split into calls to `update`.
+ * This detects corrupted or truncated files; it is not a cryptographic hash.
+ */
+class checksum
+{
+public:
+    void update(char const * data, size_t size)
+    {
+        size_bytes += size;
+
+        if (pending_size != 0u)
+        {
+            size_t const chunk = std::min(size, sizeof(uint64_t) - pending_size);
+            std::memcpy(pending.data() + pending_size, data, chunk);
+            pending_size += chunk;
+            data += chunk;
+            size -= chunk;
+
+            if (pending_size != sizeof(uint64_t))
+                return;
+
+            add(load(pending.data()));
+            pending_size = 0u;
+        }
+
+        for (; size >= sizeof(uint64_t); data += sizeof(uint64_t), size -= sizeof(uint64_t))
+            add(load(data));
+
+        std::memcpy(pending.data(), data, size);
+        pending_size = size;
+    }
+
+    uint64_t digest() const
+    {
+        std::array<char, sizeof(uint64_t)> tail{};
+        std::memcpy(tail.data(), pending.data(), pending_size);
+
+        uint64_t result = state ^ std::rotl(load(tail.data()) * prime_1, 31) ^ size_bytes;
+        result ^= result >> 33;
+        result *= prime_2;
+        result ^= result >> 29;
+        result *= prime_3;
+        result ^= result >> 32;
+        return result;
+    }
+
+private:
+    static constexpr uint64_t prime_1{0x9E3779B185EBCA87ULL};
+    static constexpr uint64_t prime_2{0xC2B2AE3D27D4EB4FULL};
+    static constexpr uint64_t prime_3{0x165667B19E3779F9ULL};
+
+    uint64_t state{prime_3};
+    uint64_t size_bytes{};
+    std::array<char, sizeof(uint64_t)> pending{};
+    size_t pending_size{};
+
+    static uint64_t load(char const * data)
+    {
+        uint64_t word{};
+        std::memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+    void add(uint64_t const word)
+    {
+        state = std::rotl(state ^ (word * prime_2), 31) * prime_1;
+    }
+};
+
+/*!\brief A stream buffer that computes the size and checksum of everything written to it.
+ * \details
+ * If a `sink` is given, the data is also written to it. Without a sink, the data is discarded, e.g., to determine the
+ * size and checksum of a section before it is written.
+ */
+class checksum_writer : public std::streambuf
+{
+public:
+    checksum_writer() = default;
+    checksum_writer(checksum_writer const &) = delete;
+    checksum_writer(checksum_writer &&) = delete;
+    checksum_writer & operator=(checksum_writer const &) = delete;
+    checksum_writer & operator=(checksum_writer &&) = delete;
+    ~checksum_writer() override = default;
+
+    explicit checksum_writer(std::streambuf * sink) : sink{sink}
+    {}
+
+    size_t size() const noexcept
+    {
+        return size_bytes;
+    }
+
+    uint64_t digest() const
+    {
+        return hash.digest();
+    }
+
+protected:
+    std::streamsize xsputn(char const * data, std::streamsize const size) override
+    {
+        std::streamsize const written = sink ? sink->sputn(data, size) : size;
+        hash.update(data, written);
+        size_bytes += written;
+        return written;
+    }
+
+    int_type overflow(int_type const character) override
+    {
+        if (traits_type::eq_int_type(character, traits_type::eof()))
+            return traits_type::not_eof(character);
+
+        char const value = traits_type::to_char_type(character);
+        return xsputn(&value, 1) == 1 ? character : traits_type::eof();
+    }
+
+private:
+    std::streambuf * sink{nullptr};
+    checksum hash{};
+    size_t size_bytes{};
+};
+
+/*!\brief A stream buffer that reads `size` bytes from `source` and computes their checksum.
+ * \details
+ * Reading stops after `size` bytes, even if the source contains more data. `finish()` reads the remaining bytes, such
+ * that the checksum covers all `size` bytes, no matter how much was read before.
+ */
+class checksum_reader : public std::streambuf
+{
+public:
+    checksum_reader() = delete;
+    checksum_reader(checksum_reader const &) = delete;
+    checksum_reader(checksum_reader &&) = delete;
+    checksum_reader & operator=(checksum_reader const &) = delete;
+    checksum_reader & operator=(checksum_reader &&) = delete;
+    ~checksum_reader() override = default;
+
+    checksum_reader(std::streambuf * source, uint64_t const size) : source{source}, remaining{size}
+    {}
+
+    //!\brief Reads the remaining bytes and returns the checksum.
+    uint64_t finish()
+    {
+        setg(nullptr, nullptr, nullptr);
+        while (remaining != 0u)
+            if (!fill())
+                throw std::runtime_error{"The index is truncated."};
+        return hash.digest();
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() == egptr() && !fill())
+            return traits_type::eof();
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize xsgetn(char * data, std::streamsize const size) override
+    {
+        std::streamsize read{};
+
+        // Bytes that are already buffered.
+        std::streamsize const buffered = std::min<std::streamsize>(size, egptr() - gptr());
+        if (buffered > 0)
+        {
+            std::memcpy(data, gptr(), buffered);
+            gbump(static_cast<int>(buffered));
+            read += buffered;
+        }
+
+        // Big reads bypass the buffer.
+        std::streamsize const direct = std::min<std::streamsize>(size - read, remaining);
+        if (direct >= static_cast<std::streamsize>(buffer_size))
+        {
+            std::streamsize const count = source->sgetn(data + read, direct);
+            hash.update(data + read, count);
+            remaining -= count;
+            read += count;
+        }
+
+        while (read < size && (gptr() != egptr() || fill()))
+        {
+            std::streamsize const chunk = std::min<std::streamsize>(size - read, egptr() - gptr());
+            std::memcpy(data + read, gptr(), chunk);
+            gbump(static_cast<int>(chunk));
+            read += chunk;
+        }
+
+        return read;
+    }
+
+private:
+    static constexpr size_t buffer_size{1ULL << 16};
+
+    std::streambuf * source{nullptr};
+    uint64_t remaining{};
+    checksum hash{};
+    std::vector<char> buffer{};
+
+    bool fill()
+    {
+        if (remaining == 0u)
+            return false;
+
+        buffer.resize(buffer_size);
+        std::streamsize const count = source->sgetn(buffer.data(), std::min<uint64_t>(remaining, buffer.size()));
+        if (count <= 0)
+            return false;
+
+        hash.update(buffer.data(), count);
+        remaining -= count;
+        setg(buffer.data(), buffer.data(), buffer.data() + count);
+        return true;
+    }
+};
+
+} // namespace raptor::detail
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::exact_distinct_count.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <omp.h>
+#include <string>
+#include <vector>
+
+#include <hibf/contrib/robin_hood.hpp>
+#include <hibf/misc/divide_and_ceil.hpp>
+
+namespace raptor
+{
+
+namespace detail
+{
+
+//!\brief Spreads the hashes over the partitions. Minimisers of short k-mers only differ in their lower bits.
+inline constexpr size_t count_partition(uint64_t const hash, int const shift) noexcept
+{
+    return (hash * 0x9E37'79B9'7F4A'7C15ULL) >> shift;
+}
+
+} // namespace detail
+
+/*!\brief Counts the distinct hashes in `file_names` that satisfy `predicate`.
+ * \param reader A raptor::file_reader.
+ * \param file_names The files of a user bin.
+ * \param estimate An estimate of the number of distinct hashes, e.g., from a HyperLogLog sketch.
+ * \param threads The number of threads to use.
+ * \param memory_limit The memory that may be used for counting. 0 means no limit.
+ * \param predicate Only hashes for which `predicate(hash)` is true are counted.
+ * \details
+ * The hashes are distributed to `4 * threads` partitions, each of which is counted by its own hash set. While the
+ * files are read, batches of hashes are inserted into the hash sets by OpenMP tasks.
+ * If the estimated memory exceeds `memory_limit`, the files are read multiple times (at most 64) and each pass only
+ * counts a subset of the partitions.
+ */
+template <typename reader_t, typename predicate_t>
+size_t exact_distinct_count(reader_t const & reader,
+                            std::vector<std::string> const & file_names,
+                            size_t const estimate,
+                            uint8_t const threads,
+                            size_t const memory_limit,
+                            predicate_t && predicate)
+{
+    static constexpr size_t batch_size{1ULL << 16};
+    static constexpr size_t bytes_per_hash{16u}; // robin_hood::unordered_flat_set with a load factor of 0.5
+    static constexpr size_t max_passes{64u};
+
+    size_t const partitions_per_pass = std::bit_ceil<size_t>(threads) * 4u;
+    size_t const passes =
+        memory_limit == 0u
+            ? 1u
+            : std::bit_ceil(std::clamp<size_t>(seqan::hibf::divide_and_ceil(estimate * bytes_per_hash, memory_limit),
+                                               1u,
+                                               max_passes));
+    int const shift = 64 - std::countr_zero(partitions_per_pass * passes);
+
+    size_t count{};
+    for (size_t pass = 0; pass < passes; ++pass)
+    {
+        std::vector<robin_hood::unordered_flat_set<uint64_t>> sets(partitions_per_pass);
+        std::vector<std::vector<uint64_t>> buffers(partitions_per_pass);
+        // References to deque elements stay valid on emplace_back.
+        std::deque<std::vector<uint64_t>> batches{};
+
+        auto submit = [&](size_t const local)
+        {
+            auto * const set = sets.data() + local;
+            auto * const batch = std::addressof(batches.emplace_back(std::move(buffers[local])));
+            buffers[local] = {};
+            buffers[local].reserve(batch_size);
+
+#pragma omp task firstprivate(set, batch) depend(inout : set[0])
+            {
+                set->insert(batch->begin(), batch->end());
+                *batch = {};
+            }
+        };
+
+#pragma omp parallel num_threads(threads)
+#pragma omp single
+        {
+            reader.for_each_hash(file_names,
+                                 [&](uint64_t const hash)
+                                 {
+                                     if (!predicate(hash))
+                                         return;
+
+                                     size_t const partition = detail::count_partition(hash, shift);
+                                     if (partition / partitions_per_pass != pass)
+                                         return;
+
+                                     size_t const local = partition % partitions_per_pass;
+                                     buffers[local].push_back(hash);
+                                     if (buffers[local].size() == batch_size)
+                                         submit(local);
+                                 });
+
+            for (size_t local = 0; local < partitions_per_pass; ++local)
+                if (!buffers[local].empty())
+                    submit(local);
+        } // Implicit barrier: All tasks are finished.
+
+        for (auto const & set : sets)
+            count += set.size();
+    }
+
+    return count;
+}
+
+} // namespace raptor
@@ -9,11 +9,15 @@
 
 #pragma once
 
+#include <istream>
+
 #include <seqan3/io/sequence_file/input.hpp>
 #include <seqan3/search/views/minimiser_hash.hpp>
 
 #include <raptor/adjust_seed.hpp>
 #include <raptor/dna4_traits.hpp>
+#include <raptor/minimiser_file.hpp>
+#include <raptor/record_ranges.hpp>
 
 namespace raptor
 {
@@ -88,6 +92,55 @@ public:
             std::ranges::for_each(record.sequence() | minimiser_view, callback);
     }
 
+    //!\brief Calls `callback` for each hash in a part of a file, see raptor::record_ranges.
+    void for_each_hash(record_range const & range, auto && callback) const
+    {
+        if (range.format == record_range::formats::whole_file)
+        {
+            for_each_hash(range.file_name, callback);
+            return;
+        }
+
+        detail::record_range_buffer buffer{range};
+        std::istream stream{&buffer};
+
+        auto hash_records = [&](sequence_file_t & fin)
+        {
+            for (auto && record : fin)
+                std::ranges::for_each(record.sequence() | minimiser_view, callback);
+        };
+
+        if (range.format == record_range::formats::fasta)
+        {
+            sequence_file_t fin{stream, seqan3::format_fasta{}};
+            hash_records(fin);
+        }
+        else
+        {
+            sequence_file_t fin{stream, seqan3::format_fastq{}};
+            hash_records(fin);
+        }
+    }
+
+    //!\brief Calls `callback` with blocks (`std::span<uint64_t const>`) of hashes. One block per record.
+    void for_each_block(std::vector<std::string> const & filenames, auto && callback) const
+    {
+        for (auto && filename : filenames)
+            for_each_block(filename, callback);
+    }
+
+    void for_each_block(std::string const & filename, auto && callback) const
+    {
+        sequence_file_t fin{filename};
+        std::vector<uint64_t> block{};
+        for (auto && record : fin)
+        {
+            block.clear();
+            std::ranges::copy(record.sequence() | minimiser_view, std::back_inserter(block));
+            callback(std::span<uint64_t const>{block});
+        }
+    }
+
 private:
     using sequence_file_t = seqan3::sequence_file_input<dna4_traits, seqan3::fields<seqan3::field::seq>>;
     using view_t = decltype(seqan3::views::minimiser_hash(seqan3::shape{}, seqan3::window_size{}, seqan3::seed{}));
@@ -118,13 +171,11 @@ public:
     template <std::output_iterator<uint64_t> it_t>
     void hash_into(std::string const & filename, it_t target) const
     {
-        std::ifstream fin{filename, std::ios::binary};
-        uint64_t value;
-        while (fin.read(reinterpret_cast<char *>(&value), sizeof(value)))
-        {
-            *target = value;
-            ++target;
-        }
+        for_each_minimiser_block(filename,
+                                 [&](std::span<uint64_t const> const block)
+                                 {
+                                     target = std::ranges::copy(block, target).out;
+                                 });
     }
 
     template <std::output_iterator<uint64_t> it_t>
@@ -137,14 +188,11 @@ public:
     template <std::output_iterator<uint64_t> it_t>
     void hash_into_if(std::string const & filename, it_t target, auto && pred) const
     {
-        std::ifstream fin{filename, std::ios::binary};
-        uint64_t value;
-        while (fin.read(reinterpret_cast<char *>(&value), sizeof(value)))
-            if (pred(value))
-            {
-                *target = value;
-                ++target;
-            }
+        for_each_minimiser_block(filename,
+                                 [&](std::span<uint64_t const> const block)
+                                 {
+                                     target = std::ranges::copy_if(block, target, pred).out;
+                                 });
     }
 
     void for_each_hash(std::vector<std::string> const & filenames, auto && callback) const
@@ -155,10 +203,19 @@ public:
 
     void for_each_hash(std::string const & filename, auto && callback) const
     {
-        std::ifstream fin{filename, std::ios::binary};
-        uint64_t value;
-        while (fin.read(reinterpret_cast<char *>(&value), sizeof(value)))
-            callback(value);
+        for_each_minimiser(filename, callback);
+    }
+
+    //!\brief Calls `callback` with blocks (`std::span<uint64_t const>`) of hashes.
+    void for_each_block(std::vector<std::string> const & filenames, auto && callback) const
+    {
+        for (auto && filename : filenames)
+            for_each_block(filename, callback);
+    }
+
+    void for_each_block(std::string const & filename, auto && callback) const
+    {
+        for_each_minimiser_block(filename, callback);
     }
 };
 
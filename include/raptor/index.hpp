@@ -16,6 +16,7 @@
 #include <hibf/hierarchical_interleaved_bloom_filter.hpp>
 
 #include <raptor/argument_parsing/build_arguments.hpp>
+#include <raptor/bin_path_table.hpp>
 #include <raptor/strong_types.hpp>
 
 namespace raptor
@@ -39,6 +40,7 @@ concept is_valid = is_ibf<index_t> || is_hibf<index_t>;
 } // namespace index_structure
 
 class index_upgrader;
+class sectioned_index;
 
 template <index_structure::is_valid data_t = index_structure::ibf>
 class raptor_index
@@ -46,11 +48,12 @@ class raptor_index
 private:
     template <index_structure::is_valid friend_data_t>
     friend class raptor_index;
+    friend class sectioned_index;
 
     uint64_t window_size_{};
     seqan3::shape shape_{};
     uint8_t parts_{};
-    std::vector<std::vector<std::string>> bin_path_{};
+    bin_path_table bin_path_{};
     bool is_hibf_{index_structure::is_hibf<data_t>};
     double fpr_{};
     seqan::hibf::config config_{};
@@ -83,6 +86,23 @@ public:
         ibf_{std::move(ibf)}
     {}
 
+    explicit raptor_index(window const window_size,
+                          seqan3::shape const shape,
+                          uint8_t const parts,
+                          bin_path_table && bin_path,
+                          seqan::hibf::config const & config,
+                          data_t && ibf)
+        requires index_structure::is_hibf<data_t>
+        :
+        window_size_{window_size.v},
+        shape_{shape},
+        parts_{parts},
+        bin_path_{std::move(bin_path)},
+        fpr_{config.maximum_fpr},
+        config_{config},
+        ibf_{std::move(ibf)}
+    {}
+
     explicit raptor_index(build_arguments const & arguments)
         requires index_structure::is_ibf<data_t>
         :
@@ -116,12 +136,17 @@ public:
         bin_path_.push_back(path);
     }
 
-    void replace_bin_path(std::vector<std::vector<std::string>> path)
+    void replace_bin_path(std::vector<std::vector<std::string>> const & path)
+    {
+        bin_path_ = bin_path_table{path};
+    }
+
+    void replace_bin_path(bin_path_table path)
     {
         bin_path_ = std::move(path);
     }
 
-    std::vector<std::vector<std::string>> const & bin_path() const
+    bin_path_table const & bin_path() const
     {
         return bin_path_;
     }
@@ -172,7 +197,7 @@ public:
                 archive(window_size_);
                 archive(shape_);
                 archive(parts_);
-                archive(bin_path_);
+                serialize_bin_path(archive);
                 archive(fpr_);
                 archive(is_hibf_);
                 archive(config_);
@@ -211,7 +236,7 @@ public:
                 archive(window_size_);
                 archive(shape_);
                 archive(parts_);
-                archive(bin_path_);
+                serialize_bin_path(archive);
                 archive(fpr_);
                 archive(is_hibf_);
                 archive(config_);
@@ -229,6 +254,23 @@ public:
         }
     }
     //!\endcond
+
+private:
+    //!\brief Index version 3 stores the bin paths as nested vectors.
+    template <seqan3::cereal_archive archive_t>
+    void serialize_bin_path(archive_t & archive)
+    {
+        if constexpr (seqan3::cereal_output_archive<archive_t>)
+        {
+            archive(bin_path_.to_vector());
+        }
+        else
+        {
+            std::vector<std::vector<std::string>> bin_path{};
+            archive(bin_path);
+            bin_path_ = bin_path_table{bin_path};
+        }
+    }
 };
 
 } // namespace raptor
@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::index_section_table and raptor::index_header.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sharg/exceptions.hpp>
+
+#include <raptor/checksum_buffer.hpp>
+
+namespace raptor
+{
+
+enum class section_kind : uint64_t
+{
+    parameters = 0u,
+    bin_paths = 1u, //!< Nested vectors. Written by format versions 1 to 3.
+    ibf = 2u,
+    bin_path_table = 3u, //!< A raptor::bin_path_table.
+    hibf_layout = 4u     //!< `next_ibf_id` and `ibf_bin_to_user_bin_id` of all IBFs of an HIBF.
+};
+
+enum class section_encoding : uint64_t
+{
+    none = 0u,
+    zlib = 1u //!< See raptor::detail::compressing_buffer.
+};
+
+struct index_section
+{
+    section_kind kind{};
+    uint64_t id{};
+    uint64_t offset{};
+    uint64_t size{};        //!< Size in the file.
+    uint64_t memory_size{}; //!< Size of the decoded section.
+    section_encoding encoding{};
+    uint64_t checksum{}; //!< raptor::detail::checksum of the `size` bytes in the file.
+};
+
+//!\brief The format version and sections of an index file.
+struct index_header
+{
+    uint64_t version{};
+    std::vector<index_section> sections{};
+
+    //!\brief Whether the sections have checksums. Older versions do not have checksums.
+    bool has_checksums() const noexcept
+    {
+        return version >= 4u;
+    }
+};
+
+/*!\brief The header and section directory of a raptor::sectioned_index.
+ * \details
+ * | Field             | Size (bytes) | Description                                                 |
+ * |-------------------|--------------|-------------------------------------------------------------|
+ * | magic             | 8            | `RAPTORSX`                                                  |
+ * | format version    | 8            | 4                                                           |
+ * | section count     | 8            | Number of sections `n`                                      |
+ * | alignment         | 8            | Alignment of the section offsets                            |
+ * | header checksum   | 8            | Checksum of the section directory                           |
+ * | reserved          | 24           | Zero                                                        |
+ * | section directory | 56 * n       | Kind, ID, offset, size, memory size, encoding, and checksum |
+ *
+ * The format version continues raptor::raptor_index::version: Version 3 is a raptor::raptor_index serialised with
+ * cereal. Versions 1 and 2 are earlier layouts of this header without the fixed header fields, checksums (1 and 2), and
+ * memory size and encoding (1). They are still read.
+ * This header does not depend on the index, such that, e.g., the index size can be reported without loading it.
+ */
+class index_section_table
+{
+public:
+    static constexpr std::array<char, 8> magic{'R', 'A', 'P', 'T', 'O', 'R', 'S', 'X'};
+    static constexpr uint64_t format_version{4u};
+    static constexpr uint64_t alignment{64u};
+
+    //!\brief Whether the file at `path` is a sectioned index.
+    static bool is_sectioned(std::filesystem::path const & path)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        std::array<char, 8> buffer{};
+        stream.read(buffer.data(), buffer.size());
+        return stream.gcount() == static_cast<std::streamsize>(buffer.size()) && buffer == magic;
+    }
+
+    static constexpr size_t header_size(size_t const section_count)
+    {
+        return fixed_header_size + section_count * sizeof(index_section);
+    }
+
+    static constexpr uint64_t align(uint64_t const offset)
+    {
+        return (offset + alignment - 1u) / alignment * alignment;
+    }
+
+    //!\brief Writes zeros up to the next aligned offset.
+    static void pad(std::ostream & stream)
+    {
+        uint64_t const offset = stream.tellp();
+        std::string const zeros(align(offset) - offset, '\0');
+        stream.write(zeros.data(), zeros.size());
+    }
+
+    static void write(std::ostream & stream, std::vector<index_section> const & sections)
+    {
+        std::array<uint64_t, fixed_header_size / sizeof(uint64_t) - 1u> fields{};
+        fields[0] = format_version;
+        fields[1] = sections.size();
+        fields[2] = alignment;
+        fields[3] = directory_checksum(sections);
+
+        stream.write(magic.data(), magic.size());
+        stream.write(reinterpret_cast<char const *>(fields.data()), sizeof(fields));
+        stream.write(reinterpret_cast<char const *>(sections.data()), sections.size() * sizeof(index_section));
+    }
+
+    static index_header read(std::filesystem::path const & path)
+    {
+        auto fail = [&path](std::string const & reason)
+        {
+            throw sharg::parser_error{"Cannot read index " + path.string() + ": " + reason};
+        };
+
+        if (!is_sectioned(path))
+            fail("Not a sectioned index.");
+
+        index_header result{};
+        std::ifstream stream{path, std::ios::binary};
+        stream.seekg(magic.size());
+        uint64_t section_count{};
+        stream.read(reinterpret_cast<char *>(&result.version), sizeof(result.version));
+        stream.read(reinterpret_cast<char *>(&section_count), sizeof(section_count));
+
+        if (!stream.good() || result.version == 0u || result.version == 3u || result.version > format_version)
+            fail("Unsupported format version.");
+
+        std::array<uint64_t, 2> fields{}; // Alignment and header checksum.
+        if (result.version >= 4u)
+        {
+            stream.read(reinterpret_cast<char *>(fields.data()), sizeof(fields));
+            stream.seekg(fixed_header_size);
+        }
+
+        size_t const entry_size = [&]() -> size_t
+        {
+            switch (result.version)
+            {
+            case 1u:
+                return 4u * sizeof(uint64_t);
+            case 2u:
+                return 6u * sizeof(uint64_t);
+            default:
+                return sizeof(index_section);
+            }
+        }();
+        uint64_t const file_size = std::filesystem::file_size(path);
+        if (section_count == 0u || section_count > file_size / entry_size)
+            fail("The section table is corrupted.");
+
+        result.sections.resize(section_count);
+        for (index_section & section : result.sections)
+        {
+            stream.read(reinterpret_cast<char *>(&section), entry_size);
+            if (result.version == 1u)
+                section.memory_size = section.size;
+        }
+
+        if (!stream.good())
+            fail("The section table is corrupted.");
+
+        if (result.has_checksums() && fields[1] != directory_checksum(result.sections))
+            fail("Checksum mismatch in the section table.");
+
+        for (index_section const & section : result.sections)
+            if (section.offset > file_size || section.size > file_size - section.offset)
+                fail("A section exceeds the file.");
+
+        if (result.sections[0].kind != section_kind::parameters
+            || result.sections[0].encoding != section_encoding::none)
+            fail("The first section must contain the parameters.");
+
+        return result;
+    }
+
+    //!\brief Whether any section of a sectioned index is compressed.
+    static bool is_compressed(std::filesystem::path const & path)
+    {
+        return is_sectioned(path)
+            && std::ranges::any_of(read(path).sections,
+                                   [](index_section const & section)
+                                   {
+                                       return section.encoding != section_encoding::none;
+                                   });
+    }
+
+    //!\brief The size of the index file if no section was compressed.
+    static size_t memory_size(std::filesystem::path const & path)
+    {
+        if (!is_sectioned(path))
+            return std::filesystem::file_size(path);
+
+        std::vector<index_section> const sections = read(path).sections;
+        size_t result = header_size(sections.size());
+        for (index_section const & section : sections)
+            result += section.memory_size;
+        return result;
+    }
+
+private:
+    static constexpr size_t fixed_header_size{64u};
+
+    static uint64_t directory_checksum(std::vector<index_section> const & sections)
+    {
+        detail::checksum result{};
+        result.update(reinterpret_cast<char const *>(sections.data()), sections.size() * sizeof(index_section));
+        return result.digest();
+    }
+};
+
+} // namespace raptor
@@ -0,0 +1,319 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::minimiser_container and raptor::minimiser_shard_writer.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include <raptor/minimiser_header.hpp>
+
+namespace raptor
+{
+
+/*!\brief Minimiser files that `raptor prepare --container` packed into a few shard files.
+ * \details
+ * Each thread of `raptor prepare` appends the minimiser files of its user bins to its own shard `minimiser_<i>.shard`
+ * in the output directory. After a minimiser file is complete, a line is appended to the index of the shard,
+ * `minimiser_<i>.shard_index`. The line contains the name, offset, size, shape, window size, cutoff, minimiser count,
+ * and the 64 suffix counts (see raptor::minimiser_header), separated by tabs.
+ *
+ * The `minimiser.list` still contains `<output directory>/<name>.minimiser`. These files do not exist. Instead, the
+ * name is looked up in the indices in the directory of the path. Hence, the file system only has to handle a few
+ * large files instead of two files per user bin.
+ *
+ * find() reads the indices of a directory on each call, unless a raptor::minimiser_container::cache exists.
+ */
+class minimiser_container
+{
+public:
+    //!\brief The location and header of a minimiser file within a shard.
+    struct entry
+    {
+        std::filesystem::path shard{};
+        size_t offset{};
+        size_t size{};
+        minimiser_header header{};
+    };
+
+    static constexpr std::string_view shard_extension{".shard"};
+    static constexpr std::string_view index_extension{".shard_index"};
+
+    minimiser_container() = default;
+    minimiser_container(minimiser_container const &) = default;
+    minimiser_container(minimiser_container &&) = default;
+    minimiser_container & operator=(minimiser_container const &) = default;
+    minimiser_container & operator=(minimiser_container &&) = default;
+    ~minimiser_container() = default;
+
+    //!\brief Reads all shard indices in `directory`.
+    explicit minimiser_container(std::filesystem::path const & directory)
+    {
+        std::error_code ec{};
+        for (auto const & file : std::filesystem::directory_iterator{directory, ec})
+        {
+            if (file.path().extension() != index_extension)
+                continue;
+
+            std::filesystem::path shard{file.path()};
+            shard.replace_extension(shard_extension);
+
+            std::ifstream stream{file.path()};
+            std::string line{};
+            // The last line is incomplete if it has no line break.
+            while (std::getline(stream, line) && !stream.eof())
+                if (auto parsed = parse(line))
+                {
+                    parsed->second.shard = shard;
+                    entries.insert_or_assign(std::move(parsed->first), std::move(parsed->second));
+                }
+        }
+    }
+
+    /*!\brief Prepares the shards in `directory` for appending after `raptor prepare` was interrupted.
+     * \details
+     * Incomplete index lines are removed, and each shard is truncated to the end of its last indexed minimiser file.
+     * \returns The container with all complete minimiser files.
+     */
+    static minimiser_container recover(std::filesystem::path const & directory)
+    {
+        minimiser_container result{directory};
+
+        std::unordered_map<std::string, size_t> shard_ends{};
+        std::unordered_map<std::string, std::string> index_contents{};
+        for (auto const & [name, entry] : result.entries)
+        {
+            size_t & end = shard_ends[entry.shard.string()];
+            end = std::max(end, entry.offset + entry.size);
+            index_contents[entry.shard.string()] += to_line(name, entry);
+        }
+
+        std::error_code ec{};
+        for (auto const & file : std::filesystem::directory_iterator{directory, ec})
+        {
+            if (file.path().extension() != shard_extension)
+                continue;
+
+            std::string const shard = file.path().string();
+            std::filesystem::resize_file(file.path(), shard_ends[shard]);
+            std::ofstream{std::filesystem::path{file.path()}.replace_extension(index_extension)}
+                << index_contents[shard];
+        }
+
+        return result;
+    }
+
+    /*!\brief Caches the indices that find() reads, until it is destroyed.
+     * \details
+     * A cache is created for each call of `raptor build` and `raptor update`. The indices of a directory are read on
+     * the first lookup of a path in the directory. Changes to the directory are not visible while the cache exists.
+     * For example, raptor::partition_spill completes its containers before looking up any of their paths.
+     *
+     * The cache is used by all threads. If caches are nested, the innermost one is used.
+     */
+    class cache
+    {
+    public:
+        cache(cache const &) = delete;
+        cache(cache &&) = delete;
+        cache & operator=(cache const &) = delete;
+        cache & operator=(cache &&) = delete;
+
+        cache() : previous{active}
+        {
+            active = this;
+        }
+
+        ~cache()
+        {
+            active = previous;
+        }
+
+    private:
+        friend minimiser_container;
+
+        static inline cache * active{nullptr};
+
+        cache * previous{nullptr};
+        std::mutex mutex{};
+        std::unordered_map<std::string, std::unique_ptr<minimiser_container const>> containers{};
+
+        minimiser_container const & get(std::filesystem::path const & directory)
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            auto & container = containers[std::filesystem::absolute(directory).string()];
+            if (!container)
+                container = std::make_unique<minimiser_container const>(directory);
+            return *container;
+        }
+    };
+
+    /*!\brief Returns the entry for a `.minimiser` path, or nothing if the path is not part of a container.
+     * \details
+     * The indices are only read if the file does not exist.
+     */
+    static std::optional<entry> find(std::filesystem::path const & minimiser_file)
+    {
+        if (minimiser_file.extension() != ".minimiser" || std::filesystem::exists(minimiser_file))
+            return std::nullopt;
+
+        std::filesystem::path const directory = minimiser_file.has_parent_path() ? minimiser_file.parent_path() : ".";
+        std::string const name = minimiser_file.stem().string();
+
+        auto copy = [](entry const * const result)
+        {
+            return result ? std::optional<entry>{*result} : std::nullopt;
+        };
+
+        if (cache::active)
+            return copy(cache::active->get(directory).get(name));
+
+        return copy(minimiser_container{directory}.get(name));
+    }
+
+    bool contains(std::string const & name) const
+    {
+        return entries.contains(name);
+    }
+
+    //!\brief Returns the entry with the given name, or `nullptr`.
+    entry const * get(std::string const & name) const
+    {
+        auto it = entries.find(name);
+        return it == entries.end() ? nullptr : &it->second;
+    }
+
+    void insert(std::string const & name, entry value)
+    {
+        entries.insert_or_assign(name, std::move(value));
+    }
+
+    //!\brief Calls `callback(name, entry)` for each entry.
+    void for_each(auto && callback) const
+    {
+        for (auto const & [name, entry] : entries)
+            callback(name, entry);
+    }
+
+    size_t size() const noexcept
+    {
+        return entries.size();
+    }
+
+    static std::filesystem::path shard_path(std::filesystem::path const & directory, size_t const id)
+    {
+        return directory / ("minimiser_" + std::to_string(id) + std::string{shard_extension});
+    }
+
+    static std::filesystem::path index_path(std::filesystem::path const & directory, size_t const id)
+    {
+        return directory / ("minimiser_" + std::to_string(id) + std::string{index_extension});
+    }
+
+    static std::string to_line(std::string const & name, entry const & entry)
+    {
+        std::ostringstream stream{};
+        minimiser_header const & header = entry.header;
+        stream << name << '\t' << entry.offset << '\t' << entry.size << '\t' << header.shape_string << '\t'
+               << header.window_size << '\t' << header.cutoff << '\t' << header.count;
+        if (header.suffix_counts)
+            for (uint64_t const count : *header.suffix_counts)
+                stream << '\t' << count;
+        stream << '\n';
+        return stream.str();
+    }
+
+private:
+    std::unordered_map<std::string, entry> entries{};
+
+    //!\brief Returns nothing if the line is malformed.
+    static std::optional<std::pair<std::string, entry>> parse(std::string const & line)
+    {
+        std::pair<std::string, entry> result{};
+        minimiser_header & header = result.second.header;
+        std::istringstream stream{line};
+        stream >> result.first >> result.second.offset >> result.second.size >> header.shape_string
+            >> header.window_size >> header.cutoff >> header.count;
+
+        std::array<uint64_t, minimiser_header::suffixes> counts{};
+        for (uint64_t & count : counts)
+            stream >> count;
+
+        if (!stream)
+            return std::nullopt;
+
+        header.suffix_counts = counts;
+        return result;
+    }
+};
+
+/*!\brief Appends minimiser files to a shard of a raptor::minimiser_container.
+ * \details
+ * A writer must only be used by one thread at a time. Each minimiser file is written to the stream returned by
+ * `begin()` and becomes visible in the index with `commit()`.
+ */
+class minimiser_shard_writer
+{
+public:
+    minimiser_shard_writer() = delete;
+    minimiser_shard_writer(minimiser_shard_writer const &) = delete;
+    minimiser_shard_writer(minimiser_shard_writer &&) = delete;
+    minimiser_shard_writer & operator=(minimiser_shard_writer const &) = delete;
+    minimiser_shard_writer & operator=(minimiser_shard_writer &&) = delete;
+    ~minimiser_shard_writer() = default;
+
+    minimiser_shard_writer(std::filesystem::path const & directory, size_t const id) :
+        shard{minimiser_container::shard_path(directory, id)},
+        index{minimiser_container::index_path(directory, id), std::ios::app}
+    {
+        std::ofstream{shard, std::ios::binary | std::ios::app}; // Creates the file if it does not exist.
+        stream.open(shard, std::ios::binary | std::ios::in | std::ios::out);
+    }
+
+    //!\brief Starts a new minimiser file at the end of the shard.
+    std::ostream & begin()
+    {
+        stream.seekp(0, std::ios::end);
+        offset = stream.tellp();
+        return stream;
+    }
+
+    //!\brief Completes the minimiser file that was started by `begin()`.
+    minimiser_container::entry commit(std::string const & name, minimiser_header const & header)
+    {
+        stream.seekp(0, std::ios::end);
+        stream.flush();
+        size_t const size = static_cast<size_t>(stream.tellp()) - offset;
+
+        minimiser_container::entry result{.shard = shard, .offset = offset, .size = size, .header = header};
+        index << minimiser_container::to_line(name, result);
+        index.flush();
+        return result;
+    }
+
+private:
+    std::filesystem::path shard{};
+    std::fstream stream{};
+    std::ofstream index{};
+    size_t offset{};
+};
+
+} // namespace raptor
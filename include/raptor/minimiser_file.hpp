@@ -0,0 +1,349 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides functions to read and write minimiser files.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <seqan3/search/kmer_index/shape.hpp>
+
+#include <raptor/minimiser_container.hpp>
+
+namespace raptor
+{
+
+/*!\brief The layout of a compressed minimiser file.
+ * \details
+ * Version 1 (uncompressed) is a sequence of unsorted `uint64_t` values without header. This is the format that
+ * `raptor layout` understands.
+ *
+ * Version 2 (compressed) starts with a header:
+ * | Bytes | Content                        |
+ * |-------|--------------------------------|
+ * | 8     | Magic bytes `RAPTORM2`         |
+ * | 8     | Number of minimisers           |
+ * | 8     | Shape (as bits, right to left) |
+ * | 4     | Window size                    |
+ *
+ * Afterwards, the minimisers are stored in ascending order. Each minimiser is stored as the difference to the previous
+ * one (the first one as is), encoded as a LEB128 varint: 7 bits per byte, the highest bit is set if more bytes follow.
+ * All numbers are little-endian.
+ */
+struct minimiser_file_header
+{
+    static constexpr std::array<char, 8> magic{'R', 'A', 'P', 'T', 'O', 'R', 'M', '2'};
+    static constexpr std::streamsize size{8 + 8 + 8 + 4};
+
+    uint64_t count{};
+    uint64_t shape{};
+    uint32_t window_size{};
+};
+
+namespace detail
+{
+
+//!\brief The number of bytes that are read at once.
+inline constexpr size_t minimiser_block_size{1ULL << 22};
+
+template <typename value_t>
+inline void write_little_endian(std::ostream & stream, value_t value)
+{
+    std::array<char, sizeof(value_t)> bytes{};
+    for (char & byte : bytes)
+    {
+        byte = static_cast<char>(value & 0xFFu);
+        value >>= 8;
+    }
+    stream.write(bytes.data(), bytes.size());
+}
+
+template <typename value_t>
+inline value_t read_little_endian(char const * bytes)
+{
+    value_t value{};
+    for (size_t i = sizeof(value_t); i > 0u; --i)
+        value = (value << 8) | static_cast<uint8_t>(bytes[i - 1u]);
+    return value;
+}
+
+/*!\brief Returns the header if the file is compressed (version 2).
+ * \details
+ * The header is read at the current position. If there is no header, the position is restored.
+ */
+inline std::optional<minimiser_file_header> read_minimiser_file_header(std::ifstream & stream)
+{
+    std::streampos const position = stream.tellg();
+    std::array<char, minimiser_file_header::size> bytes{};
+    stream.read(bytes.data(), bytes.size());
+
+    if (stream.gcount() == minimiser_file_header::size
+        && std::ranges::equal(std::span{bytes}.first<8>(), minimiser_file_header::magic))
+    {
+        return minimiser_file_header{.count = read_little_endian<uint64_t>(bytes.data() + 8),
+                                     .shape = read_little_endian<uint64_t>(bytes.data() + 16),
+                                     .window_size = read_little_endian<uint32_t>(bytes.data() + 24)};
+    }
+
+    stream.clear();
+    stream.seekg(position);
+    return std::nullopt;
+}
+
+} // namespace detail
+
+//!\brief A minimiser file, or a minimiser file within a shard of a raptor::minimiser_container.
+struct minimiser_location
+{
+    std::filesystem::path file{};
+    size_t begin{};
+    size_t end{};
+};
+
+//!\brief Returns the file itself or, if it does not exist, its location in the raptor::minimiser_container.
+inline minimiser_location locate_minimiser_file(std::filesystem::path const & path)
+{
+    if (std::optional<minimiser_container::entry> const entry = minimiser_container::find(path))
+        return {.file = entry->shard, .begin = entry->offset, .end = entry->offset + entry->size};
+
+    return {.file = path, .end = std::filesystem::file_size(path)};
+}
+
+/*!\brief Returns the header (`.header` file) of a minimiser file.
+ * \returns Nothing if the minimiser file is neither part of a raptor::minimiser_container nor has a `.header` file.
+ */
+inline std::optional<minimiser_header> find_minimiser_header(std::filesystem::path const & path)
+{
+    if (std::optional<minimiser_container::entry> const entry = minimiser_container::find(path))
+        return entry->header;
+
+    std::filesystem::path header_file{path};
+    header_file.replace_extension("header");
+    if (!std::filesystem::exists(header_file))
+        return std::nullopt;
+
+    return minimiser_header::read(header_file);
+}
+
+/*!\brief Writes a compressed minimiser file (version 2) from minimisers in ascending order.
+ * \details
+ * The count in the header is written when the writer is closed or destroyed.
+ * The file may also be written to a stream, e.g., a shard of a raptor::minimiser_container. The stream must support
+ * seeking and must outlive the writer.
+ */
+class compressed_minimiser_writer
+{
+public:
+    compressed_minimiser_writer() = delete;
+    compressed_minimiser_writer(compressed_minimiser_writer const &) = delete;
+    compressed_minimiser_writer(compressed_minimiser_writer &&) = delete;
+    compressed_minimiser_writer & operator=(compressed_minimiser_writer const &) = delete;
+    compressed_minimiser_writer & operator=(compressed_minimiser_writer &&) = delete;
+
+    ~compressed_minimiser_writer()
+    {
+        close();
+    }
+
+    compressed_minimiser_writer(std::filesystem::path const & path,
+                                seqan3::shape const & shape,
+                                uint32_t const window_size) :
+        file{path, std::ios::binary}
+    {
+        write_header(shape, window_size);
+    }
+
+    compressed_minimiser_writer(std::ostream & output, seqan3::shape const & shape, uint32_t const window_size) :
+        stream{&output}
+    {
+        write_header(shape, window_size);
+    }
+
+    //!\brief Appends a minimiser. Must not be smaller than the previous one.
+    void push(uint64_t const minimiser)
+    {
+        assert(count == 0u || minimiser >= previous);
+        uint64_t delta = minimiser - previous;
+        previous = minimiser;
+        ++count;
+
+        while (delta >= 0x80u)
+        {
+            buffer.push_back(static_cast<char>((delta & 0x7Fu) | 0x80u));
+            delta >>= 7;
+        }
+        buffer.push_back(static_cast<char>(delta));
+
+        if (buffer.size() >= detail::minimiser_block_size)
+        {
+            stream->write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    void close()
+    {
+        if (closed)
+            return;
+
+        stream->write(buffer.data(), buffer.size());
+        buffer.clear();
+        stream->seekp(header_position + std::streamoff{minimiser_file_header::magic.size()});
+        detail::write_little_endian<uint64_t>(*stream, count);
+        stream->seekp(0, std::ios::end);
+        closed = true;
+
+        if (file.is_open())
+            file.close();
+    }
+
+private:
+    std::ofstream file{};
+    std::ostream * stream{&file};
+    std::streampos header_position{};
+    std::vector<char> buffer{};
+    uint64_t previous{};
+    uint64_t count{};
+    bool closed{false};
+
+    void write_header(seqan3::shape const & shape, uint32_t const window_size)
+    {
+        header_position = stream->tellp();
+        stream->write(minimiser_file_header::magic.data(), minimiser_file_header::magic.size());
+        detail::write_little_endian<uint64_t>(*stream, 0u); // Count, see close()
+        detail::write_little_endian<uint64_t>(*stream, shape.to_ulong());
+        detail::write_little_endian<uint32_t>(*stream, window_size);
+        buffer.reserve(detail::minimiser_block_size + 10u);
+    }
+};
+
+/*!\brief Writes a compressed minimiser file (version 2).
+ * \param[in] path The output file.
+ * \param[in,out] minimisers The distinct minimisers. Will be sorted.
+ * \param[in] shape The shape that was used to compute the minimisers.
+ * \param[in] window_size The window size that was used to compute the minimisers.
+ */
+inline void write_compressed_minimiser_file(std::filesystem::path const & path,
+                                            std::vector<uint64_t> & minimisers,
+                                            seqan3::shape const & shape,
+                                            uint32_t const window_size)
+{
+    std::ranges::sort(minimisers);
+
+    compressed_minimiser_writer writer{path, shape, window_size};
+    for (uint64_t const minimiser : minimisers)
+        writer.push(minimiser);
+}
+
+/*!\brief Calls `callback` with blocks (`std::span<uint64_t const>`) of minimisers from a minimiser file.
+ * \details
+ * Supports version 1 and 2, and minimiser files within a raptor::minimiser_container. The file is read in blocks of
+ * 4 MiB. Uncompressed files are read directly into the block. For compressed files, the minimisers are passed in
+ * ascending order.
+ */
+inline void for_each_minimiser_block(minimiser_location const & location, auto && callback)
+{
+    std::ifstream stream{location.file, std::ios::binary};
+    stream.seekg(location.begin);
+    std::vector<uint64_t> block(detail::minimiser_block_size / sizeof(uint64_t));
+
+    size_t remaining = location.end - location.begin;
+    auto read = [&](char * const data, size_t const size) -> size_t
+    {
+        stream.read(data, std::min(size, remaining));
+        size_t const count = stream.gcount();
+        remaining -= count;
+        return count;
+    };
+
+    if (remaining >= minimiser_file_header::size && detail::read_minimiser_file_header(stream))
+    {
+        remaining -= minimiser_file_header::size;
+        std::vector<char> buffer(detail::minimiser_block_size);
+        size_t size{};
+        uint64_t previous{};
+        uint64_t delta{};
+        int shift{};
+
+        while (size_t const bytes = read(buffer.data(), buffer.size()))
+        {
+            for (char const byte : std::span{buffer.data(), bytes})
+            {
+                delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+                if (byte & 0x80)
+                {
+                    shift += 7;
+                    continue;
+                }
+
+                previous += delta;
+                block[size] = previous;
+                delta = 0u;
+                shift = 0;
+
+                if (++size == block.size())
+                {
+                    callback(std::span<uint64_t const>{block});
+                    size = 0u;
+                }
+            }
+        }
+
+        if (size > 0u)
+            callback(std::span<uint64_t const>{block.data(), size});
+    }
+    else
+    {
+        size_t const block_bytes = block.size() * sizeof(uint64_t);
+
+        while (size_t const bytes = read(reinterpret_cast<char *>(block.data()), block_bytes))
+            callback(std::span<uint64_t const>{block.data(), bytes / sizeof(uint64_t)});
+    }
+}
+
+//!\overload
+inline void for_each_minimiser_block(std::filesystem::path const & path, auto && callback)
+{
+    for_each_minimiser_block(locate_minimiser_file(path), callback);
+}
+
+//!\brief Calls `callback` for each minimiser in a minimiser file (version 1 or 2).
+inline void for_each_minimiser(std::filesystem::path const & path, auto && callback)
+{
+    for_each_minimiser_block(path,
+                             [&](std::span<uint64_t const> const block)
+                             {
+                                 for (uint64_t const value : block)
+                                     callback(value);
+                             });
+}
+
+//!\brief Returns the number of minimisers in a minimiser file (version 1 or 2) without reading the minimisers.
+inline uint64_t minimiser_count(std::filesystem::path const & path)
+{
+    minimiser_location const location = locate_minimiser_file(path);
+    std::ifstream stream{location.file, std::ios::binary};
+    stream.seekg(location.begin);
+
+    if (location.end - location.begin >= minimiser_file_header::size)
+        if (auto const header = detail::read_minimiser_file_header(stream))
+            return header->count;
+
+    return (location.end - location.begin) / sizeof(uint64_t);
+}
+
+} // namespace raptor
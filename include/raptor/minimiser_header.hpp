@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::minimiser_header.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace raptor
+{
+
+/*!\brief The content of a `.header` file written by `raptor prepare`.
+ * \details
+ * The first line contains the shape, window size, cutoff and number of minimisers, separated by tabs.
+ * The optional second line contains the number of minimisers for each suffix, i.e., `hash % suffixes`.
+ * raptor::partition_config assigns suffixes to parts. Hence, the number of minimisers per part can be computed without
+ * reading the minimisers, as long as there are at most 64 suffixes.
+ */
+struct minimiser_header
+{
+    static constexpr size_t suffixes{64u};
+
+    std::string shape_string{};
+    uint64_t window_size{};
+    uint16_t cutoff{};
+    uint64_t count{};
+    std::optional<std::array<uint64_t, suffixes>> suffix_counts{};
+
+    static constexpr size_t suffix(uint64_t const hash) noexcept
+    {
+        return hash & (suffixes - 1u);
+    }
+
+    void write(std::filesystem::path const & path) const
+    {
+        std::ofstream stream{path};
+        stream << shape_string << '\t' << window_size << '\t' << cutoff << '\t' << count << '\n';
+
+        if (suffix_counts)
+        {
+            for (size_t i = 0; i < suffixes; ++i)
+                stream << (*suffix_counts)[i] << (i + 1u == suffixes ? '\n' : '\t');
+        }
+    }
+
+    static minimiser_header read(std::filesystem::path const & path)
+    {
+        minimiser_header header{};
+        std::ifstream stream{path};
+        stream >> header.shape_string >> header.window_size >> header.cutoff >> header.count;
+
+        std::array<uint64_t, suffixes> counts{};
+        for (uint64_t & count : counts)
+            stream >> count;
+        if (stream)
+            header.suffix_counts = counts;
+
+        return header;
+    }
+};
+
+} // namespace raptor
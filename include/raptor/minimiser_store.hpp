@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::minimiser_store.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <raptor/checksum_buffer.hpp>
+#include <raptor/file_reader.hpp>
+#include <raptor/minimiser_container.hpp>
+#include <raptor/minimiser_file.hpp>
+#include <raptor/minimiser_header.hpp>
+
+namespace raptor
+{
+
+/*!\brief The sorted minimisers of each user bin, stored next to an HIBF.
+ * \details
+ * The store is a raptor::minimiser_container with a single shard in the directory `<index>.minimisers`. Each user bin
+ * is a compressed minimiser file named `<user bin ID>_<fingerprint>`. The fingerprint covers the path, size, and
+ * modification time of each file of the user bin. If a user bin ID refers to other or changed files, e.g., after
+ * building with a different layout into the same output, the minimisers are recomputed and stored under a new name.
+ * The old entry is removed by `compact()`, which is called when the store is opened and after an HIBF was built.
+ *
+ * The HIBF reads a user bin once for each merged bin it belongs to, and `raptor update` rebuilds whole subtrees. With
+ * a store, the minimisers of a user bin are only computed the first time it is read. Afterwards, they are decoded from
+ * the store. Newly computed minimisers are also decoded from the store, such that only the encoded minimisers and not
+ * all minimisers of the user bin are in memory while they are passed on.
+ *
+ * The store is safe to use from multiple threads. Entries with a different shape or window size are recomputed.
+ */
+class minimiser_store
+{
+public:
+    minimiser_store() = delete;
+    minimiser_store(minimiser_store const &) = delete;
+    minimiser_store(minimiser_store &&) = delete;
+    minimiser_store & operator=(minimiser_store const &) = delete;
+    minimiser_store & operator=(minimiser_store &&) = delete;
+    ~minimiser_store() = default;
+
+    //!\brief Opens or creates a store. An interrupted store is recovered, see raptor::minimiser_container::recover.
+    minimiser_store(std::filesystem::path const & directory, seqan3::shape const & shape, uint32_t const window_size) :
+        directory{directory},
+        shape{shape},
+        shape_string{shape.to_string()},
+        window_size{window_size},
+        container{[&]()
+                  {
+                      std::filesystem::create_directories(directory);
+                      std::filesystem::remove_all(staging_directory(directory)); // An interrupted compact().
+                      return minimiser_container::recover(directory);
+                  }()},
+        writer{std::make_unique<minimiser_shard_writer>(directory, 0u)}
+    {
+        compact();
+    }
+
+    //!\brief The directory of the store of an index.
+    static std::filesystem::path directory_of(std::filesystem::path const & index_file)
+    {
+        std::filesystem::path result{index_file};
+        result += ".minimisers";
+        return result;
+    }
+
+    //!\brief Copies the minimisers of a user bin to `target`. They are computed and stored if they are not stored yet.
+    template <std::output_iterator<uint64_t> it_t>
+    void hash_into(size_t const user_bin_id,
+                   std::vector<std::string> const & file_names,
+                   file_reader<file_types::sequence> const & reader,
+                   it_t target)
+    {
+        std::string const name = entry_name(user_bin_id, file_names);
+
+        std::optional<minimiser_location> location = find(name);
+        if (!location)
+            location = insert(name, file_names, reader);
+
+        for_each_minimiser_block(*location,
+                                 [&](std::span<uint64_t const> const block)
+                                 {
+                                     std::ranges::copy(block, target);
+                                 });
+    }
+
+    /*!\brief Removes entries that were superseded by a later entry for the same user bin ID.
+     * \details
+     * Does nothing if the shard only contains the latest entries.
+     * The remaining entries are copied to a new shard, which then replaces the old one. If this is interrupted, the
+     * store is either unchanged or empty. Must not be called while other threads use the store.
+     */
+    void compact()
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+
+        std::unordered_map<std::string, std::string> latest{}; // User bin ID -> name of the latest entry.
+        container.for_each(
+            [&](std::string const & name, minimiser_container::entry const & entry)
+            {
+                auto const [it, inserted] = latest.try_emplace(name.substr(0u, name.find('_')), name);
+                if (!inserted && container.get(it->second)->offset < entry.offset)
+                    it->second = name;
+            });
+
+        // Also covers user bins that were stored twice because two threads computed them at the same time.
+        size_t live_bytes{};
+        for (auto const & [user_bin_id, name] : latest)
+            live_bytes += container.get(name)->size;
+        if (live_bytes == std::filesystem::file_size(minimiser_container::shard_path(directory, 0u)))
+            return;
+
+        std::filesystem::path const staging = staging_directory(directory);
+        std::filesystem::create_directory(staging);
+        {
+            minimiser_shard_writer staging_writer{staging, 0u};
+            std::vector<char> buffer(detail::minimiser_block_size);
+            for (auto const & [user_bin_id, name] : latest)
+            {
+                minimiser_container::entry const & entry = *container.get(name);
+                std::ifstream shard{entry.shard, std::ios::binary};
+                shard.seekg(entry.offset);
+                std::ostream & output = staging_writer.begin();
+                for (size_t remaining = entry.size; remaining != 0u;)
+                {
+                    size_t const count = std::min(remaining, buffer.size());
+                    shard.read(buffer.data(), count);
+                    output.write(buffer.data(), count);
+                    remaining -= count;
+                }
+                if (!shard)
+                    throw std::runtime_error{"Could not read the minimiser store " + directory.string()};
+                staging_writer.commit(name, entry.header);
+            }
+        }
+
+        // Without an index, the shard is truncated when the store is opened. Hence, no entry can be read from the
+        // wrong shard.
+        writer.reset();
+        std::filesystem::remove(minimiser_container::index_path(directory, 0u));
+        std::filesystem::rename(minimiser_container::shard_path(staging, 0u),
+                                minimiser_container::shard_path(directory, 0u));
+        std::filesystem::rename(minimiser_container::index_path(staging, 0u),
+                                minimiser_container::index_path(directory, 0u));
+        std::filesystem::remove_all(staging);
+
+        container = minimiser_container{directory};
+        writer = std::make_unique<minimiser_shard_writer>(directory, 0u);
+    }
+
+private:
+    std::filesystem::path directory{};
+    seqan3::shape shape{};
+    std::string shape_string{};
+    uint32_t window_size{};
+    std::mutex mutex{};
+    minimiser_container container;
+    std::unique_ptr<minimiser_shard_writer> writer;
+
+    static std::filesystem::path staging_directory(std::filesystem::path const & directory)
+    {
+        return directory / "compact";
+    }
+
+    std::optional<minimiser_location> find(std::string const & name)
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+        minimiser_container::entry const * const entry = container.get(name);
+
+        if (entry == nullptr || entry->header.shape_string != shape_string || entry->header.window_size != window_size)
+            return std::nullopt;
+
+        return minimiser_location{.file = entry->shard, .begin = entry->offset, .end = entry->offset + entry->size};
+    }
+
+    //!\brief Computes and stores the minimisers of a user bin. Only the encoded minimisers are kept.
+    minimiser_location insert(std::string const & name,
+                              std::vector<std::string> const & file_names,
+                              file_reader<file_types::sequence> const & reader)
+    {
+        std::vector<uint64_t> hashes{};
+        reader.hash_into(file_names, std::back_inserter(hashes));
+        std::ranges::sort(hashes);
+        auto const duplicates = std::ranges::unique(hashes);
+        hashes.erase(duplicates.begin(), duplicates.end());
+
+        minimiser_header const header{.shape_string = shape_string,
+                                      .window_size = window_size,
+                                      .cutoff = 1u,
+                                      .count = hashes.size(),
+                                      .suffix_counts = suffix_counts(hashes)};
+
+        std::ostringstream encoded{};
+        {
+            compressed_minimiser_writer minimiser_writer{encoded, shape, window_size};
+            for (uint64_t const hash : hashes)
+                minimiser_writer.push(hash);
+        }
+        hashes = std::vector<uint64_t>{};
+        std::string const bytes = std::move(encoded).str();
+
+        // Only writing to the shard needs the lock.
+        std::lock_guard<std::mutex> guard{mutex};
+        writer->begin().write(bytes.data(), bytes.size());
+        minimiser_container::entry const entry = writer->commit(name, header);
+        container.insert(name, entry);
+        return {.file = entry.shard, .begin = entry.offset, .end = entry.offset + entry.size};
+    }
+
+    static std::string entry_name(size_t const user_bin_id, std::vector<std::string> const & file_names)
+    {
+        detail::checksum fingerprint{};
+        for (std::string const & file_name : file_names)
+        {
+            std::error_code ec{};
+            uint64_t const size = std::filesystem::file_size(file_name, ec);
+            auto const modified = std::filesystem::last_write_time(file_name, ec).time_since_epoch().count();
+            fingerprint.update(file_name.data(), file_name.size() + 1u); // Including the null terminator.
+            fingerprint.update(reinterpret_cast<char const *>(&size), sizeof(size));
+            fingerprint.update(reinterpret_cast<char const *>(&modified), sizeof(modified));
+        }
+
+        std::array<char, 16> buffer{};
+        auto const conv = std::to_chars(buffer.data(), buffer.data() + buffer.size(), fingerprint.digest(), 16);
+        return std::to_string(user_bin_id) + '_' + std::string{buffer.data(), conv.ptr};
+    }
+
+    static std::array<uint64_t, minimiser_header::suffixes> suffix_counts(std::vector<uint64_t> const & hashes)
+    {
+        std::array<uint64_t, minimiser_header::suffixes> result{};
+        for (uint64_t const hash : hashes)
+            ++result[minimiser_header::suffix(hash)];
+        return result;
+    }
+};
+
+} // namespace raptor
@@ -0,0 +1,292 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::minimiser_counter.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <hibf/contrib/robin_hood.hpp>
+
+#include <raptor/minimiser_file.hpp>
+
+namespace raptor
+{
+
+/*!\brief Counts how often minimisers occur, using at most `memory_limit` bytes for the hash table.
+ * \details
+ * Minimisers are counted in a hash table. If the hash table exceeds the memory limit, its content and all following
+ * minimisers are written to 64 bucket files on disk, partitioned by the 6 most significant bits of the hash.
+ * Afterwards, each bucket is counted on its own. Buckets that still exceed the memory limit are partitioned further by
+ * the next 6 bits.
+ *
+ * A minimiser that was counted `c` times before spilling is written `min(c, cutoff)` times. Hence, the set of
+ * minimisers that occur at least `cutoff` times is the same as without memory limit.
+ */
+class minimiser_counter
+{
+public:
+    minimiser_counter() = delete;
+    minimiser_counter(minimiser_counter const &) = delete;
+    minimiser_counter(minimiser_counter &&) = delete;
+    minimiser_counter & operator=(minimiser_counter const &) = delete;
+    minimiser_counter & operator=(minimiser_counter &&) = delete;
+
+    ~minimiser_counter()
+    {
+        buckets.clear();
+        std::error_code ec{};
+        for (auto const & file : bucket_files)
+            std::filesystem::remove(file, ec);
+    }
+
+    /*!\brief Constructs a counter.
+     * \param cutoff Only minimisers with at least (>=) `cutoff` occurrences are reported.
+     * \param memory_limit The memory that may be used for counting. 0 means no limit.
+     * \param bucket_prefix Bucket files are named `<bucket_prefix>_<bucket>`.
+     * \param hash_bits The number of bits that the hashes use, i.e., two times the number of 1s in the shape.
+     */
+    minimiser_counter(uint8_t const cutoff,
+                      size_t const memory_limit,
+                      std::filesystem::path bucket_prefix,
+                      int const hash_bits) :
+        cutoff{cutoff},
+        max_entries{max_entries_for(memory_limit)},
+        bucket_prefix{std::move(bucket_prefix)},
+        hash_bits{hash_bits}
+    {}
+
+    void insert(uint64_t const hash)
+    {
+        if (!buckets.empty())
+        {
+            buckets[bucket_of(hash, 0)].push(hash);
+            return;
+        }
+
+        // It does not matter whether a minimiser appears 50 times or 2000 times, it is stored regardless because the
+        // biggest cutoff value is 50. Hence, the hash table stores only values up to 254 to save memory.
+        uint8_t & count = table[hash];
+        count = std::min<uint8_t>(254u, count + 1);
+
+        if (table.size() > max_entries && can_split(0))
+            spill();
+    }
+
+    //!\brief Whether the minimisers were written to disk.
+    bool spilled() const noexcept
+    {
+        return !bucket_files.empty();
+    }
+
+    //!\brief The number of distinct minimisers. Only available after `emit()` if the minimisers were spilled.
+    size_t distinct() const noexcept
+    {
+        return spilled() ? distinct_count : table.size();
+    }
+
+    /*!\brief Calls `callback` for each minimiser with at least `cutoff` occurrences.
+     * \param sorted Whether the minimisers are passed in ascending order.
+     * \param callback Invoked with each minimiser.
+     */
+    void emit(bool const sorted, auto && callback)
+    {
+        if (!spilled())
+        {
+            emit_table(sorted, callback);
+            return;
+        }
+
+        std::vector<std::filesystem::path> files{};
+        for (auto & bucket : buckets)
+            files.push_back(bucket.close());
+        buckets.clear();
+
+        for (auto const & file : files)
+            count_bucket(file, 1, sorted, callback);
+    }
+
+private:
+    //!\brief robin_hood stores 17 bytes per slot; the load factor is between 0.4 and 0.8, and rehashing needs both.
+    static constexpr size_t bytes_per_entry{64u};
+    static constexpr int bucket_bits{6};
+    static constexpr size_t bucket_count{1ULL << bucket_bits};
+    static constexpr size_t bucket_buffer_size{1ULL << 13};
+    static constexpr size_t buffer_memory{bucket_count * bucket_buffer_size * sizeof(uint64_t)};
+    static constexpr size_t min_entries{1ULL << 16}; // Avoids splitting buckets into many tiny files.
+
+    class bucket
+    {
+    public:
+        bucket() = delete;
+        bucket(bucket const &) = delete;
+        bucket(bucket &&) = default;
+        bucket & operator=(bucket const &) = delete;
+        bucket & operator=(bucket &&) = default;
+        ~bucket() = default;
+
+        explicit bucket(std::filesystem::path file) : path{std::move(file)}, stream{path, std::ios::binary}
+        {
+            buffer.reserve(bucket_buffer_size);
+        }
+
+        void push(uint64_t const hash)
+        {
+            buffer.push_back(hash);
+            if (buffer.size() == bucket_buffer_size)
+                flush();
+        }
+
+        std::filesystem::path close()
+        {
+            flush();
+            stream.close();
+            return path;
+        }
+
+    private:
+        std::filesystem::path path;
+        std::ofstream stream;
+        std::vector<uint64_t> buffer{};
+
+        void flush()
+        {
+            stream.write(reinterpret_cast<char const *>(buffer.data()), buffer.size() * sizeof(uint64_t));
+            buffer.clear();
+        }
+    };
+
+    uint8_t cutoff{};
+    size_t max_entries{};
+    std::filesystem::path bucket_prefix{};
+    int hash_bits{};
+
+    robin_hood::unordered_map<uint64_t, uint8_t> table{};
+    std::vector<bucket> buckets{};
+    std::vector<std::filesystem::path> bucket_files{};
+    size_t distinct_count{};
+
+    static constexpr size_t max_entries_for(size_t const memory_limit) noexcept
+    {
+        if (memory_limit == 0u)
+            return std::numeric_limits<size_t>::max();
+
+        size_t const table_memory = memory_limit - std::min(memory_limit, buffer_memory);
+        return std::max(min_entries, table_memory / bytes_per_entry);
+    }
+
+    bool can_split(int const level) const noexcept
+    {
+        return hash_bits >= bucket_bits * (level + 1);
+    }
+
+    size_t bucket_of(uint64_t const hash, int const level) const noexcept
+    {
+        return (hash >> (hash_bits - bucket_bits * (level + 1))) & (bucket_count - 1u);
+    }
+
+    std::vector<bucket> open_buckets(std::filesystem::path const & prefix)
+    {
+        std::vector<bucket> result{};
+        result.reserve(bucket_count);
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            std::filesystem::path file{prefix};
+            file += "_" + std::to_string(i);
+            bucket_files.push_back(file);
+            result.emplace_back(std::move(file));
+        }
+        return result;
+    }
+
+    void spill()
+    {
+        buckets = open_buckets(bucket_prefix);
+
+        for (auto && [hash, count] : table)
+            for (uint8_t i = 0; i < std::min(count, cutoff); ++i)
+                buckets[bucket_of(hash, 0)].push(hash);
+
+        table = {}; // Release the memory.
+    }
+
+    void emit_table(bool const sorted, auto && callback)
+    {
+        if (!sorted)
+        {
+            for (auto && [hash, count] : table)
+                if (count >= cutoff)
+                    callback(hash);
+            return;
+        }
+
+        std::vector<uint64_t> hashes{};
+        for (auto && [hash, count] : table)
+            if (count >= cutoff)
+                hashes.push_back(hash);
+        std::ranges::sort(hashes);
+
+        for (uint64_t const hash : hashes)
+            callback(hash);
+    }
+
+    void count_bucket(std::filesystem::path const & file, int const level, bool const sorted, auto && callback)
+    {
+        bool too_big{false};
+        table.clear();
+
+        for_each_minimiser_block(file,
+                                 [&](std::span<uint64_t const> const block)
+                                 {
+                                     if (too_big)
+                                         return;
+
+                                     for (uint64_t const hash : block)
+                                     {
+                                         uint8_t & count = table[hash];
+                                         count = std::min<uint8_t>(254u, count + 1);
+                                     }
+
+                                     too_big = table.size() > max_entries && can_split(level);
+                                 });
+
+        if (!too_big)
+        {
+            distinct_count += table.size();
+            emit_table(sorted, callback);
+            table.clear();
+            std::filesystem::remove(file);
+            return;
+        }
+
+        table = {};
+        std::vector<bucket> sub_buckets = open_buckets(file);
+        for_each_minimiser(file,
+                           [&](uint64_t const hash)
+                           {
+                               sub_buckets[bucket_of(hash, level)].push(hash);
+                           });
+        std::filesystem::remove(file);
+
+        std::vector<std::filesystem::path> files{};
+        for (auto & sub_bucket : sub_buckets)
+            files.push_back(sub_bucket.close());
+        sub_buckets.clear();
+
+        for (auto const & sub_file : files)
+            count_bucket(sub_file, level + 1, sorted, callback);
+    }
+};
+
+} // namespace raptor
@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::record_range and raptor::record_ranges.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace raptor
+{
+
+//!\brief The size of the parts that large user bins are split into.
+inline constexpr size_t record_chunk_size{1ULL << 24};
+
+//!\brief A part of a sequence file that starts and ends at record boundaries.
+struct record_range
+{
+    enum class formats : uint8_t
+    {
+        whole_file, //!< The file cannot be split, e.g., because it is compressed.
+        fasta,
+        fastq
+    };
+
+    std::string file_name{};
+    size_t begin{};
+    size_t end{};
+    formats format{formats::whole_file};
+};
+
+namespace detail
+{
+
+/*!\brief Determines the format of an uncompressed file from its first character.
+ * \details
+ * Compressed files are never split. A BGZF file could be split at block boundaries, but each range would still have
+ * to be decompressed from its first block to find the first record.
+ */
+inline record_range::formats splittable_format(std::filesystem::path const & file_name)
+{
+    std::filesystem::path const extension = file_name.extension();
+    if (extension == ".gz" || extension == ".bgzf" || extension == ".bz2")
+        return record_range::formats::whole_file;
+
+    std::ifstream stream{file_name, std::ios::binary};
+    switch (stream.get())
+    {
+    case '>':
+        return record_range::formats::fasta;
+    case '@':
+        return record_range::formats::fastq;
+    default:
+        return record_range::formats::whole_file;
+    }
+}
+
+/*!\brief Returns the position of the first record that starts at or after `position`.
+ * \details
+ * FASTA records start with a line beginning with `>`.
+ * FASTQ records start with a line beginning with `@`, followed by a sequence line and a line beginning with `+`. The
+ * second condition is needed because quality lines may also begin with `@`.
+ */
+inline size_t next_record_start(std::ifstream & stream, size_t const position, record_range::formats const format)
+{
+    stream.clear();
+    stream.seekg(position - 1u);
+
+    std::string line{};
+    std::getline(stream, line); // The rest of the line that contains position - 1.
+
+    std::array<std::string, 3> lines{};
+    std::array<size_t, 3> starts{};
+
+    auto read_line = [&](size_t const i)
+    {
+        starts[i] = stream.tellg();
+        if (!std::getline(stream, lines[i]))
+            starts[i] = std::string::npos;
+    };
+
+    for (size_t i = 0; i < lines.size(); ++i)
+        read_line(i);
+
+    while (starts[0] != std::string::npos)
+    {
+        if (format == record_range::formats::fasta && lines[0].starts_with('>'))
+            return starts[0];
+
+        if (format == record_range::formats::fastq && lines[0].starts_with('@') && starts[2] != std::string::npos
+            && lines[2].starts_with('+'))
+            return starts[0];
+
+        std::ranges::rotate(lines, lines.begin() + 1);
+        std::ranges::rotate(starts, starts.begin() + 1);
+        read_line(2);
+    }
+
+    return std::string::npos;
+}
+
+/*!\brief A stream buffer that reads the part of a file that a raptor::record_range refers to.
+ * \details
+ * At most `buffer_size` bytes are in memory at once, no matter how big the range is.
+ * The buffer is only refilled when it is exhausted, such that characters that were just read can be put back.
+ */
+class record_range_buffer : public std::streambuf
+{
+public:
+    record_range_buffer() = delete;
+    record_range_buffer(record_range_buffer const &) = delete;
+    record_range_buffer(record_range_buffer &&) = delete;
+    record_range_buffer & operator=(record_range_buffer const &) = delete;
+    record_range_buffer & operator=(record_range_buffer &&) = delete;
+    ~record_range_buffer() override = default;
+
+    explicit record_range_buffer(record_range const & range, size_t const buffer_size = 1ULL << 16) :
+        file{range.file_name, std::ios::binary},
+        remaining{range.end - range.begin},
+        buffer(buffer_size)
+    {
+        file.seekg(range.begin);
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+        std::streamsize const count = std::min(buffer.size(), remaining);
+        std::streamsize const read = count == 0 ? 0 : file.rdbuf()->sgetn(buffer.data(), count);
+        if (read <= 0)
+            return traits_type::eof();
+
+        remaining -= read;
+        setg(buffer.data(), buffer.data(), buffer.data() + read);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    std::ifstream file;
+    size_t remaining{};
+    std::vector<char> buffer{};
+};
+
+} // namespace detail
+
+/*!\brief Splits uncompressed FASTA and FASTQ files into ranges of about `chunk_size` bytes.
+ * \details
+ * Each range starts and ends at record boundaries. Files that cannot be split are returned as a single range of format
+ * raptor::record_range::formats::whole_file.
+ */
+inline std::vector<record_range> record_ranges(std::vector<std::string> const & file_names, size_t const chunk_size)
+{
+    std::vector<record_range> result{};
+
+    for (auto const & file_name : file_names)
+    {
+        record_range::formats const format = detail::splittable_format(file_name);
+        size_t const file_size = std::filesystem::file_size(file_name);
+
+        if (format == record_range::formats::whole_file)
+        {
+            result.push_back(record_range{.file_name = file_name, .end = file_size, .format = format});
+            continue;
+        }
+
+        std::ifstream stream{file_name, std::ios::binary};
+        size_t begin{};
+        while (begin < file_size)
+        {
+            size_t end = begin + chunk_size < file_size ? detail::next_record_start(stream, begin + chunk_size, format)
+                                                        : file_size;
+            end = std::min(end, file_size);
+            result.push_back(record_range{.file_name = file_name, .begin = begin, .end = end, .format = format});
+            begin = end;
+        }
+    }
+
+    return result;
+}
+
+/*!\brief Returns for each user bin whether its files should be hashed by multiple threads.
+ * \details
+ * A user bin is split if it is bigger than the average amount of input per thread. Otherwise, a single thread would
+ * still be busy when all other threads are done. A user bin that raptor::record_ranges cannot split into more than
+ * one range, e.g., a single compressed file, is not split.
+ */
+inline std::vector<bool> large_user_bins(std::vector<std::vector<std::string>> const & bin_path,
+                                         uint8_t const threads,
+                                         size_t const chunk_size)
+{
+    std::vector<size_t> sizes(bin_path.size());
+    for (size_t i = 0; i < bin_path.size(); ++i)
+        for (auto const & file_name : bin_path[i])
+            sizes[i] += std::filesystem::file_size(file_name);
+
+    size_t const total = std::reduce(sizes.begin(), sizes.end());
+    std::vector<bool> result(bin_path.size());
+
+    if (threads > 1u)
+        for (size_t i = 0; i < bin_path.size(); ++i)
+            result[i] = sizes[i] > total / threads && sizes[i] > chunk_size
+                     && record_ranges(bin_path[i], chunk_size).size() > 1u;
+
+    return result;
+}
+
+} // namespace raptor
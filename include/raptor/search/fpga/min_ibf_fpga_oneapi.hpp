@@ -17,6 +17,7 @@
 #include <cereal/archives/binary.hpp>
 
 #include <raptor/index.hpp>
+#include <raptor/sectioned_index.hpp>
 
 #include <min_ibf_fpga/backend_sycl/exception_handler.hpp>
 #include <min_ibf_fpga/backend_sycl/shared.hpp>
@@ -146,6 +147,11 @@ public:
         if constexpr (profile)
             start = std::chrono::steady_clock::now();
 
+        if (sectioned_index::is_sectioned(index_path))
+        {
+            sectioned_index::load(index_path, index, 1u);
+        }
+        else
         {
             std::ifstream archiveStream{index_path, std::ios::binary};
             cereal::BinaryInputArchive archive{archiveStream};
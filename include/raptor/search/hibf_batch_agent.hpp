@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::hibf_batch_agent.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <raptor/argument_parsing/hibf_level_statistics.hpp>
+#include <raptor/index.hpp>
+#include <raptor/search/lazy_hibf.hpp>
+
+namespace raptor
+{
+
+/*!\brief Queries a batch of reads against an HIBF, one level at a time.
+ * \tparam hibf_t raptor::index_structure::hibf or raptor::lazy_hibf.
+ * \details
+ * The membership agent of seqan::hibf::hierarchical_interleaved_bloom_filter traverses the HIBF depth-first for each
+ * read. Consecutive reads usually visit different child IBFs, such that each read brings other IBFs into the cache.
+ *
+ * This agent queries all reads of a batch against the root IBF first. Each read that reaches a merged bin is queued
+ * for the child IBF. Then, each queued IBF is queried with all of its reads, and so on, until no IBF has reads
+ * left. Each IBF is visited at most once per batch, and a raptor::lazy_hibf loads each IBF at most once per batch.
+ *
+ * The results are the same as the ones of the per-read traversal: For each read, the sorted IDs of all user bins
+ * that contain at least `threshold` of its values.
+ */
+template <typename hibf_t>
+class hibf_batch_agent
+{
+public:
+    hibf_batch_agent() = default;
+    hibf_batch_agent(hibf_batch_agent const &) = default;
+    hibf_batch_agent(hibf_batch_agent &&) = default;
+    hibf_batch_agent & operator=(hibf_batch_agent const &) = default;
+    hibf_batch_agent & operator=(hibf_batch_agent &&) = default;
+    ~hibf_batch_agent() = default;
+
+    /*!\brief Constructs the agent.
+     * \param[in] hibf The HIBF to query.
+     * \param[in] selected_bins If not empty, only the selected bins of each IBF are reported or traversed;
+     *                          see select_bins().
+     */
+    explicit hibf_batch_agent(hibf_t const & hibf, std::span<std::vector<bool> const> const selected_bins = {}) :
+        hibf_ptr{&hibf},
+        selected_bins{selected_bins},
+        pending(next_ibf_id(hibf).size())
+    {
+        if constexpr (is_lazy)
+            counts.resize(hibf.levels());
+    }
+
+    /*!\brief Queries all reads of a batch.
+     * \param[in] values The values, e.g., minimisers, of each read.
+     * \param[in] thresholds The threshold of each read.
+     * \returns The sorted user bin IDs of each read. Valid until the next call.
+     */
+    std::vector<std::vector<uint64_t>> const & membership_for(std::span<std::vector<uint64_t> const> const values,
+                                                              std::span<size_t const> const thresholds)
+    {
+        assert(values.size() == thresholds.size());
+
+        results.resize(values.size());
+        for (std::vector<uint64_t> & result : results)
+            result.clear();
+
+        if (values.empty())
+            return results;
+
+        current_level.assign(1u, 0u);
+        pending[0].resize(values.size());
+        for (size_t read = 0; read < values.size(); ++read)
+            pending[0][read] = read;
+
+        while (!current_level.empty())
+        {
+            next_level.clear();
+            // Child IBFs are usually stored in the order of their IDs.
+            std::ranges::sort(current_level);
+            for (size_t const ibf_id : current_level)
+                query_ibf(ibf_id, values, thresholds);
+            std::swap(current_level, next_level);
+        }
+
+        for (std::vector<uint64_t> & result : results)
+            std::ranges::sort(result);
+
+        return results;
+    }
+
+    /*!\brief Selects the bins of each IBF that are or contain one of the selected user bins.
+     * \details
+     * A merged bin is selected if its subtree contains a selected user bin. Reads are neither queued for the child
+     * IBFs of merged bins that are not selected, nor reported for user bins that are not selected. Searching a
+     * small subset of the user bins hence only queries the IBFs on the paths to these user bins.
+     */
+    static std::vector<std::vector<bool>> select_bins(hibf_t const & hibf, std::vector<bool> const & selected_user_bins)
+    {
+        std::vector<std::vector<bool>> result(next_ibf_id(hibf).size());
+        select_subtree(hibf, 0u, selected_user_bins, result);
+        return result;
+    }
+
+    //!\brief How often the IBFs of each level were queried and loaded. Only counted for a raptor::lazy_hibf.
+    std::vector<hibf_level_counts> const & level_counts() const noexcept
+    {
+        return counts;
+    }
+
+private:
+    static constexpr bool is_lazy = std::same_as<hibf_t, lazy_hibf>;
+
+    hibf_t const * hibf_ptr{nullptr};
+    std::span<std::vector<bool> const> selected_bins{};
+    std::vector<std::vector<uint64_t>> results{};
+
+    // The reads that are queued for each IBF.
+    std::vector<std::vector<size_t>> pending{};
+    std::vector<size_t> current_level{};
+    std::vector<size_t> next_level{};
+    std::vector<size_t> reads{};
+
+    std::vector<hibf_level_counts> counts{};
+
+    static std::vector<std::vector<uint64_t>> const & next_ibf_id(hibf_t const & hibf) noexcept
+    {
+        if constexpr (is_lazy)
+            return hibf.next_ibf_id();
+        else
+            return hibf.next_ibf_id;
+    }
+
+    static std::vector<std::vector<uint64_t>> const & ibf_bin_to_user_bin_id(hibf_t const & hibf) noexcept
+    {
+        if constexpr (is_lazy)
+            return hibf.ibf_bin_to_user_bin_id();
+        else
+            return hibf.ibf_bin_to_user_bin_id;
+    }
+
+    // Returns whether the subtree of `ibf_id` contains a selected user bin.
+    static bool select_subtree(hibf_t const & hibf,
+                               size_t const ibf_id,
+                               std::vector<bool> const & selected_user_bins,
+                               std::vector<std::vector<bool>> & result)
+    {
+        std::vector<bool> & bins = result[ibf_id];
+        auto const & user_bin_ids = ibf_bin_to_user_bin_id(hibf)[ibf_id];
+        auto const & children = next_ibf_id(hibf)[ibf_id];
+        bins.resize(user_bin_ids.size());
+
+        bool any_selected{false};
+        for (size_t bin = 0; bin < user_bin_ids.size(); ++bin)
+        {
+            uint64_t const user_bin_id = user_bin_ids[bin];
+            if (user_bin_id == seqan::hibf::bin_kind::merged)
+                bins[bin] = select_subtree(hibf, children[bin], selected_user_bins, result);
+            else
+                bins[bin] = user_bin_id < selected_user_bins.size() && selected_user_bins[user_bin_id];
+            any_selected |= bins[bin];
+        }
+
+        return any_selected;
+    }
+
+    void query_ibf(size_t const ibf_id,
+                   std::span<std::vector<uint64_t> const> const values,
+                   std::span<size_t const> const thresholds)
+    {
+        // Swapping keeps the capacity of both vectors.
+        reads.clear();
+        std::swap(reads, pending[ibf_id]);
+
+        if constexpr (is_lazy)
+        {
+            bool loaded{};
+            auto const ibf = hibf_ptr->ibf(ibf_id, loaded);
+            hibf_level_counts & level = counts[hibf_ptr->level(ibf_id)];
+            ++level.queries;
+            level.loads += loaded;
+            query_ibf(*ibf, ibf_id, values, thresholds);
+        }
+        else
+        {
+            query_ibf(hibf_ptr->ibf_vector[ibf_id], ibf_id, values, thresholds);
+        }
+    }
+
+    void query_ibf(index_structure::ibf const & ibf,
+                   size_t const ibf_id,
+                   std::span<std::vector<uint64_t> const> const values,
+                   std::span<size_t const> const thresholds)
+    {
+        auto agent = ibf.template counting_agent<uint16_t>();
+        auto const & user_bin_ids = ibf_bin_to_user_bin_id(*hibf_ptr)[ibf_id];
+        auto const & children = next_ibf_id(*hibf_ptr)[ibf_id];
+        std::vector<bool> const * const selected = selected_bins.empty() ? nullptr : &selected_bins[ibf_id];
+
+        for (size_t const read : reads)
+        {
+            auto & result = agent.bulk_count(values[read]);
+            size_t const threshold = thresholds[read];
+
+            size_t sum{};
+            for (size_t bin = 0; bin < result.size(); ++bin)
+            {
+                sum += result[bin];
+                uint64_t const user_bin_id = user_bin_ids[bin];
+
+                if (user_bin_id == seqan::hibf::bin_kind::merged)
+                {
+                    if (sum >= threshold && (!selected || (*selected)[bin]))
+                    {
+                        std::vector<size_t> & queue = pending[children[bin]];
+                        if (queue.empty())
+                            next_level.push_back(children[bin]);
+                        queue.push_back(read);
+                    }
+                    sum = 0u;
+                }
+                else if (bin + 1u == result.size() || user_bin_id != user_bin_ids[bin + 1u]) // Last bin of a split bin.
+                {
+                    // Like the membership agent of the HIBF, deleted bins are not skipped. They are empty after
+                    // `raptor update --delete`, i.e., only reported if the threshold is 0.
+                    if (sum >= threshold && (!selected || (*selected)[bin]))
+                        results[read].push_back(user_bin_id);
+                    sum = 0u;
+                }
+            }
+        }
+    }
+};
+
+} // namespace raptor
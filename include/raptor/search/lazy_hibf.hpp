@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::lazy_hibf.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <raptor/argument_parsing/hibf_level_statistics.hpp>
+#include <raptor/argument_parsing/search_arguments.hpp>
+#include <raptor/index.hpp>
+#include <raptor/sectioned_index.hpp>
+
+namespace raptor
+{
+
+/*!\brief An HIBF whose lower levels are loaded on first access.
+ * \details
+ * Only the layout of the HIBF (`next_ibf_id` and `ibf_bin_to_user_bin_id`) and the IBFs of the first
+ * `resident_levels` levels are loaded up front. All other IBFs are loaded from their section of the
+ * raptor::sectioned_index when a query reaches them, and are kept in a least recently used cache of
+ * `cache_size` bytes. A child IBF is always used after its parent, hence the IBFs of a subtree that is no longer
+ * queried are evicted before its root.
+ *
+ * `cache_size` is not a hard bound: An IBF that is being queried is not evicted, and it counts towards the cache until
+ * the query releases it. Each thread queries one IBF at a time, hence the cache exceeds `cache_size` by at most one
+ * IBF per thread.
+ *
+ * The HIBF is queried with raptor::hibf_batch_agent.
+ */
+class lazy_hibf
+{
+public:
+    lazy_hibf() = default;
+    lazy_hibf(lazy_hibf const &) = delete;
+    lazy_hibf(lazy_hibf &&) = delete;
+    lazy_hibf & operator=(lazy_hibf const &) = delete;
+    lazy_hibf & operator=(lazy_hibf &&) = delete;
+    ~lazy_hibf() = default;
+
+    void load(std::filesystem::path const & path,
+              size_t const resident_levels,
+              uint64_t const cache_size,
+              uint8_t const threads)
+    {
+        path_ = path;
+        header_ = index_section_table::read(path);
+        cache_capacity_ = cache_size;
+
+        raptor_index<index_structure::hibf> index{};
+        ibf_sections_ = sectioned_index::load_layout(path, header_, index, threads);
+        next_ibf_id_ = std::move(index.ibf().next_ibf_id);
+        ibf_bin_to_user_bin_id_ = std::move(index.ibf().ibf_bin_to_user_bin_id);
+
+        if (ibf_sections_.empty())
+            throw sharg::parser_error{"Cannot read index: The HIBF has no IBFs."};
+
+        compute_levels();
+
+        entries_.clear();
+        entries_.resize(ibf_sections_.size());
+        lru_.clear();
+
+        std::vector<size_t> resident{};
+        for (size_t ibf_id = 0; ibf_id < ibf_sections_.size(); ++ibf_id)
+            if (level_[ibf_id] < std::max<size_t>(1u, resident_levels))
+                resident.push_back(ibf_id);
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (size_t i = 0; i < resident.size(); ++i)
+        {
+            auto ibf = std::make_shared<index_structure::ibf>();
+            sectioned_index::load_ibf(path_, header_, ibf_sections_[resident[i]], *ibf);
+            entries_[resident[i]].ibf = std::move(ibf);
+            entries_[resident[i]].is_resident = true;
+        }
+    }
+
+    size_t hash_function_count() const
+    {
+        return entries_[0].ibf->hash_function_count();
+    }
+
+    //!\brief The number of levels of the HIBF.
+    size_t levels() const noexcept
+    {
+        return level_count_;
+    }
+
+    //!\brief The bytes used by IBFs that were loaded on demand, i.e., cached IBFs and IBFs that are being queried.
+    uint64_t cache_size() const noexcept
+    {
+        return cache_size_.load(std::memory_order_relaxed);
+    }
+
+    //!\brief The level of the IBF `ibf_id`. The root is on level 0.
+    size_t level(size_t const ibf_id) const noexcept
+    {
+        return level_[ibf_id];
+    }
+
+    std::vector<std::vector<uint64_t>> const & next_ibf_id() const noexcept
+    {
+        return next_ibf_id_;
+    }
+
+    std::vector<std::vector<uint64_t>> const & ibf_bin_to_user_bin_id() const noexcept
+    {
+        return ibf_bin_to_user_bin_id_;
+    }
+
+    /*!\brief Returns the IBF `ibf_id`, loading it if it is not cached. `loaded` is set if the IBF was loaded.
+     * \details
+     * The IBF is loaded without holding the lock. If two threads load the same IBF, the first one is kept.
+     * The returned pointer pins the IBF: It is not evicted while the pointer exists.
+     */
+    std::shared_ptr<index_structure::ibf const> ibf(size_t const ibf_id, bool & loaded) const
+    {
+        loaded = false;
+        {
+            std::lock_guard<std::mutex> guard{mutex_};
+            cache_entry & entry = entries_[ibf_id];
+            if (entry.is_resident)
+                return entry.ibf;
+            if (entry.ibf)
+            {
+                lru_.splice(lru_.begin(), lru_, entry.position);
+                return entry.ibf;
+            }
+        }
+
+        // The bytes are charged until the last pointer to the IBF is released.
+        uint64_t const ibf_size = ibf_sections_[ibf_id].memory_size;
+        cache_size_.fetch_add(ibf_size, std::memory_order_relaxed);
+        std::shared_ptr<index_structure::ibf> ibf{new index_structure::ibf{},
+                                                  [this, ibf_size](index_structure::ibf * const ptr)
+                                                  {
+                                                      delete ptr;
+                                                      cache_size_.fetch_sub(ibf_size, std::memory_order_relaxed);
+                                                  }};
+        sectioned_index::load_ibf(path_, header_, ibf_sections_[ibf_id], *ibf);
+        loaded = true;
+
+        std::lock_guard<std::mutex> guard{mutex_};
+        cache_entry & entry = entries_[ibf_id];
+        if (entry.ibf)
+            return entry.ibf;
+
+        entry.ibf = std::move(ibf);
+        lru_.push_front(ibf_id);
+        entry.position = lru_.begin();
+        std::shared_ptr<index_structure::ibf const> result = entry.ibf;
+
+        // Evict the least recently used IBFs that are not pinned. Pointers are only copied while holding the lock,
+        // hence an IBF whose only owner is the cache cannot be pinned concurrently.
+        for (auto it = lru_.end(); it != lru_.begin() && cache_size() > cache_capacity_;)
+        {
+            --it;
+            cache_entry & evicted = entries_[*it];
+            if (evicted.ibf.use_count() > 1)
+                continue;
+            evicted.ibf.reset();
+            it = lru_.erase(it);
+        }
+
+        return result;
+    }
+
+private:
+    struct cache_entry
+    {
+        std::shared_ptr<index_structure::ibf const> ibf{};
+        std::list<size_t>::iterator position{};
+        bool is_resident{false};
+    };
+
+    std::filesystem::path path_{};
+    index_header header_{};
+    std::vector<index_section> ibf_sections_{};
+    std::vector<std::vector<uint64_t>> next_ibf_id_{};
+    std::vector<std::vector<uint64_t>> ibf_bin_to_user_bin_id_{};
+    std::vector<size_t> level_{};
+    size_t level_count_{};
+
+    // Declared before the entries, because releasing an IBF updates the cache size.
+    mutable std::atomic<uint64_t> cache_size_{};
+    mutable std::mutex mutex_{};
+    mutable std::vector<cache_entry> entries_{};
+    mutable std::list<size_t> lru_{}; // Most recently used first.
+    uint64_t cache_capacity_{};
+
+    void compute_levels()
+    {
+        level_.assign(ibf_sections_.size(), 0u);
+        level_count_ = 1u;
+
+        std::vector<size_t> current{0u};
+        std::vector<size_t> next{};
+        while (!current.empty())
+        {
+            next.clear();
+            for (size_t const ibf_id : current)
+            {
+                for (size_t bin = 0; bin < ibf_bin_to_user_bin_id_[ibf_id].size(); ++bin)
+                {
+                    if (ibf_bin_to_user_bin_id_[ibf_id][bin] != seqan::hibf::bin_kind::merged)
+                        continue;
+
+                    size_t const child = next_ibf_id_[ibf_id][bin];
+                    // Each child IBF belongs to exactly one merged bin.
+                    if (child >= level_.size() || child == 0u || level_[child] != 0u)
+                        throw sharg::parser_error{"Cannot read index: Invalid HIBF layout section."};
+                    level_[child] = level_[ibf_id] + 1u;
+                    level_count_ = std::max(level_count_, level_[child] + 1u);
+                    next.push_back(child);
+                }
+            }
+            std::swap(current, next);
+        }
+    }
+};
+
+//!\brief Loads the layout and the resident levels of a raptor::lazy_hibf.
+inline void load_index(lazy_hibf & index, search_arguments const & arguments)
+{
+    auto span = arguments.trace.scoped("Load index", "io");
+    arguments.load_index_timer.start();
+    index.load(arguments.index_file,
+               arguments.hibf_resident_levels,
+               arguments.hibf_cache_size * 1024ULL * 1024ULL,
+               arguments.threads);
+    arguments.load_index_timer.stop();
+}
+
+} // namespace raptor
@@ -14,6 +14,7 @@
 
 #include <raptor/argument_parsing/search_arguments.hpp>
 #include <raptor/index.hpp>
+#include <raptor/sectioned_index.hpp>
 
 namespace raptor
 {
@@ -21,9 +22,16 @@ namespace raptor
 namespace detail
 {
 
+//!\brief Loads an index. A raptor::sectioned_index is loaded with `threads` threads.
 template <typename index_t>
-void load_index(index_t & index, std::filesystem::path const & path)
+void load_index(index_t & index, std::filesystem::path const & path, uint8_t const threads = 1u)
 {
+    if (sectioned_index::is_sectioned(path))
+    {
+        sectioned_index::load(path, index, threads);
+        return;
+    }
+
     std::ifstream is{path, std::ios::binary};
     cereal::BinaryInputArchive iarchive{is};
 
@@ -37,6 +45,8 @@ void load_index(index_t & index, search_arguments const & arguments, size_t cons
 {
     std::filesystem::path index_file{arguments.index_file};
     index_file += "_" + std::to_string(part);
+    auto span = arguments.trace.scoped("Load index", "io");
+    span.add_arg("part", part);
     arguments.load_index_timer.start();
     detail::load_index(index, index_file);
     arguments.load_index_timer.stop();
@@ -45,8 +55,9 @@ void load_index(index_t & index, search_arguments const & arguments, size_t cons
 template <typename index_t>
 void load_index(index_t & index, search_arguments const & arguments)
 {
+    auto span = arguments.trace.scoped("Load index", "io");
     arguments.load_index_timer.start();
-    detail::load_index(index, arguments.index_file);
+    detail::load_index(index, arguments.index_file, arguments.threads);
     arguments.load_index_timer.stop();
 }
 
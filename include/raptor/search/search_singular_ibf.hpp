@@ -9,8 +9,12 @@
 
 #pragma once
 
+#include <chrono>
 #include <future>
 #include <random>
+#include <ranges>
+#include <span>
+#include <string_view>
 
 #include <seqan3/search/views/minimiser_hash.hpp>
 
@@ -19,6 +23,8 @@
 #include <raptor/adjust_seed.hpp>
 #include <raptor/dna4_traits.hpp>
 #include <raptor/search/do_parallel.hpp>
+#include <raptor/search/hibf_batch_agent.hpp>
+#include <raptor/search/lazy_hibf.hpp>
 #include <raptor/search/load_index.hpp>
 #include <raptor/search/sync_out.hpp>
 #include <raptor/threshold/threshold.hpp>
@@ -29,12 +35,30 @@ namespace raptor
 template <typename index_t>
 void search_singular_ibf(search_arguments const & arguments, index_t && index)
 {
-    constexpr bool is_ibf = std::same_as<index_t, raptor_index<index_structure::ibf>>;
+    constexpr bool is_ibf = std::same_as<std::remove_cvref_t<index_t>, raptor_index<index_structure::ibf>>;
+    constexpr bool is_lazy = std::same_as<std::remove_cvref_t<index_t>, lazy_hibf>;
+
+    // The HIBF that is traversed by raptor::hibf_batch_agent.
+    auto hibf = [&]() -> auto const &
+    {
+        if constexpr (is_lazy)
+            return index;
+        else
+            return index.ibf();
+    };
+    using hibf_agent_t = hibf_batch_agent<std::remove_cvref_t<decltype(hibf())>>;
+    std::vector<std::vector<bool>> selected_hibf_bins{};
 
     auto cereal_future = std::async(std::launch::async,
                                     [&]()
                                     {
                                         load_index(index, arguments);
+                                        if constexpr (!is_ibf)
+                                        {
+                                            if (!arguments.selected_bins.empty())
+                                                selected_hibf_bins =
+                                                    hibf_agent_t::select_bins(hibf(), arguments.selected_bins);
+                                        }
                                     });
 
     seqan3::sequence_file_input<dna4_traits, seqan3::fields<seqan3::field::id, seqan3::field::seq>> fin{
@@ -48,38 +72,38 @@ void search_singular_ibf(search_arguments const & arguments, index_t && index)
 
     auto worker = [&](size_t const start, size_t const extent)
     {
+        using clock = std::chrono::steady_clock;
+
+        auto span = arguments.trace.scoped("Search", "search");
         seqan::hibf::serial_timer local_compute_minimiser_timer{};
         seqan::hibf::serial_timer local_query_ibf_timer{};
         seqan::hibf::serial_timer local_generate_results_timer{};
+        perf_counter_group const perf_group{arguments.perf_counters};
+        serial_perf_counter local_compute_minimiser_perf{perf_group};
+        serial_perf_counter local_query_ibf_perf{perf_group};
+        serial_perf_counter local_generate_results_perf{perf_group};
+        latency_histogram local_compute_minimiser_latency{};
+        latency_histogram local_threshold_latency{};
+        latency_histogram local_query_ibf_latency{};
+        latency_histogram local_generate_results_latency{};
+        latency_histogram local_query_hibf_batch_latency{};
+        uint64_t local_minimiser_count{};
 
-        auto agent = index.ibf().membership_agent();
+        // The timestamps for the latency histograms are only taken if requested.
+        auto timestamp = [&arguments]()
+        {
+            return arguments.latency ? clock::now() : clock::time_point{};
+        };
 
         std::string result_string{};
         std::array<char, std::numeric_limits<uint64_t>::digits10 + 1> buffer{};
-        std::vector<uint64_t> minimiser;
 
-        auto hash_adaptor = seqan3::views::minimiser_hash(arguments.shape,
-                                                          seqan3::window_size{arguments.window_size},
-                                                          seqan3::seed{adjust_seed(arguments.shape_weight)});
-
-        for (auto && [id, seq] : std::span{records.data() + start, extent})
+        auto write_result = [&](std::string_view const id, auto && user_bin_ids)
         {
             result_string.clear();
             result_string += id;
             result_string += '\t';
 
-            auto minimiser_view = seq | hash_adaptor | std::views::common;
-            local_compute_minimiser_timer.start();
-            minimiser.assign(minimiser_view.begin(), minimiser_view.end());
-            local_compute_minimiser_timer.stop();
-
-            size_t const minimiser_count{minimiser.size()};
-            size_t const threshold = thresholder.get(minimiser_count);
-
-            local_query_ibf_timer.start();
-            auto & user_bin_ids = agent.membership_for(minimiser, threshold);
-            local_query_ibf_timer.stop();
-            local_generate_results_timer.start();
             for (auto && user_bin : user_bin_ids)
             {
                 auto conv = std::to_chars(buffer.data(), buffer.data() + buffer.size(), user_bin);
@@ -95,17 +119,149 @@ void search_singular_ibf(search_arguments const & arguments, index_t && index)
                 result_string += '\n';
 
             synced_out.write(result_string);
-            local_generate_results_timer.stop();
+        };
+
+        auto hash_adaptor = seqan3::views::minimiser_hash(arguments.shape,
+                                                          seqan3::window_size{arguments.window_size},
+                                                          seqan3::seed{adjust_seed(arguments.shape_weight)});
+
+        if constexpr (is_ibf)
+        {
+            auto agent = index.ibf().membership_agent();
+            std::vector<uint64_t> minimiser;
+            auto is_selected = [&arguments](uint64_t const user_bin)
+            {
+                return arguments.is_selected(user_bin);
+            };
+
+            for (auto && [id, seq] : std::span{records.data() + start, extent})
+            {
+                auto minimiser_view = seq | hash_adaptor | std::views::common;
+                clock::time_point const hash_start = timestamp();
+                local_compute_minimiser_timer.start();
+                local_compute_minimiser_perf.start();
+                minimiser.assign(minimiser_view.begin(), minimiser_view.end());
+                local_compute_minimiser_perf.stop();
+                local_compute_minimiser_timer.stop();
+                clock::time_point const threshold_start = timestamp();
+
+                size_t const minimiser_count{minimiser.size()};
+                size_t const threshold = thresholder.get(minimiser_count);
+                local_minimiser_count += minimiser_count;
+
+                clock::time_point const query_start = timestamp();
+                local_query_ibf_timer.start();
+                local_query_ibf_perf.start();
+                auto & user_bin_ids = agent.membership_for(minimiser, threshold);
+                local_query_ibf_perf.stop();
+                local_query_ibf_timer.stop();
+                clock::time_point const results_start = timestamp();
+                local_generate_results_timer.start();
+                local_generate_results_perf.start();
+                write_result(id, user_bin_ids | std::views::filter(is_selected));
+                local_generate_results_perf.stop();
+                local_generate_results_timer.stop();
+
+                if (arguments.latency)
+                {
+                    local_compute_minimiser_latency.record(threshold_start - hash_start);
+                    local_threshold_latency.record(query_start - threshold_start);
+                    local_query_ibf_latency.record(results_start - query_start);
+                    local_generate_results_latency.record(clock::now() - results_start);
+                }
+            }
+        }
+        else
+        {
+            // The reads of a batch traverse the HIBF together; see raptor::hibf_batch_agent.
+            hibf_agent_t agent{hibf(), selected_hibf_bins};
+            std::vector<std::vector<uint64_t>> minimisers{};
+            std::vector<size_t> thresholds{};
+            size_t const batch_size = arguments.hibf_batch_size;
+
+            for (size_t batch_start = start; batch_start < start + extent; batch_start += batch_size)
+            {
+                std::span const batch{records.data() + batch_start, std::min(batch_size, start + extent - batch_start)};
+                minimisers.resize(batch.size());
+                thresholds.resize(batch.size());
+
+                // As for an IBF, the threshold is not part of computing the minimisers. The query is timed per batch.
+                for (size_t i = 0; i < batch.size(); ++i)
+                {
+                    auto minimiser_view = batch[i].sequence() | hash_adaptor | std::views::common;
+                    clock::time_point const hash_start = timestamp();
+                    local_compute_minimiser_timer.start();
+                    local_compute_minimiser_perf.start();
+                    minimisers[i].assign(minimiser_view.begin(), minimiser_view.end());
+                    local_compute_minimiser_perf.stop();
+                    local_compute_minimiser_timer.stop();
+                    clock::time_point const threshold_start = timestamp();
+
+                    thresholds[i] = thresholder.get(minimisers[i].size());
+                    local_minimiser_count += minimisers[i].size();
+
+                    if (arguments.latency)
+                    {
+                        local_compute_minimiser_latency.record(threshold_start - hash_start);
+                        local_threshold_latency.record(clock::now() - threshold_start);
+                    }
+                }
+
+                clock::time_point const query_start = timestamp();
+                local_query_ibf_timer.start();
+                local_query_ibf_perf.start();
+                auto & user_bin_ids = agent.membership_for(minimisers, thresholds);
+                local_query_ibf_perf.stop();
+                local_query_ibf_timer.stop();
+                clock::time_point results_start = timestamp();
+                if (arguments.latency)
+                    local_query_hibf_batch_latency.record(results_start - query_start);
+
+                local_generate_results_timer.start();
+                local_generate_results_perf.start();
+                for (size_t i = 0; i < batch.size(); ++i)
+                {
+                    write_result(batch[i].id(), user_bin_ids[i]);
+                    if (arguments.latency)
+                    {
+                        clock::time_point const results_end = clock::now();
+                        local_generate_results_latency.record(results_end - results_start);
+                        results_start = results_end;
+                    }
+                }
+                local_generate_results_perf.stop();
+                local_generate_results_timer.stop();
+            }
+
+            if constexpr (is_lazy)
+                arguments.hibf_level_statistics += agent.level_counts();
         }
 
         arguments.compute_minimiser_timer += local_compute_minimiser_timer;
+        arguments.compute_minimiser_perf += local_compute_minimiser_perf;
         arguments.query_ibf_timer += local_query_ibf_timer;
+        arguments.query_ibf_perf += local_query_ibf_perf;
         arguments.generate_results_timer += local_generate_results_timer;
+        arguments.generate_results_perf += local_generate_results_perf;
+        arguments.compute_minimiser_latency += local_compute_minimiser_latency;
+        arguments.threshold_latency += local_threshold_latency;
+        arguments.query_ibf_latency += local_query_ibf_latency;
+        arguments.generate_results_latency += local_generate_results_latency;
+        arguments.query_hibf_batch_latency += local_query_hibf_batch_latency;
+        arguments.query_counter += extent;
+        arguments.minimiser_counter += local_minimiser_count;
+
+        span.add_arg("reads", extent);
+        span.add_arg("compute_minimiser_in_seconds", local_compute_minimiser_timer.in_seconds());
+        span.add_arg("query_ibf_in_seconds", local_query_ibf_timer.in_seconds());
+        span.add_arg("generate_results_in_seconds", local_generate_results_timer.in_seconds());
     };
 
     auto write_header = [&]()
     {
-        if constexpr (is_ibf)
+        if constexpr (is_lazy)
+            return synced_out.write_header(arguments, index.hash_function_count());
+        else if constexpr (is_ibf)
             return synced_out.write_header(arguments, index.ibf().hash_function_count());
         else
             return synced_out.write_header(arguments, index.ibf().ibf_vector[0].hash_function_count());
@@ -114,11 +270,15 @@ void search_singular_ibf(search_arguments const & arguments, index_t && index)
     for (auto && chunked_records : fin | seqan::stl::views::chunk((1ULL << 20) * 10))
     {
         records.clear();
-        arguments.query_file_io_timer.start();
-        std::ranges::move(chunked_records, std::back_inserter(records));
-        // Very fast, improves parallel processing when chunks of the query belong to the same bin.
-        std::ranges::shuffle(records, std::mt19937_64{0u});
-        arguments.query_file_io_timer.stop();
+        {
+            auto span = arguments.trace.scoped("Query file I/O", "io");
+            arguments.query_file_io_timer.start();
+            std::ranges::move(chunked_records, std::back_inserter(records));
+            // Very fast, improves parallel processing when chunks of the query belong to the same bin.
+            std::ranges::shuffle(records, std::mt19937_64{0u});
+            arguments.query_file_io_timer.stop();
+            span.add_arg("reads", records.size());
+        }
 
         cereal_future.get();
         [[maybe_unused]] static bool header_written = write_header(); // called exactly once
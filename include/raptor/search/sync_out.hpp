@@ -9,11 +9,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
-
-#include <hibf/contrib/std/join_with_view.hpp>
+#include <string_view>
+#include <utility>
 
 #include <raptor/argument_parsing/search_arguments.hpp>
 
@@ -57,6 +58,8 @@ public:
         file << "## Percentage threshold = " << arguments.threshold << '\n';
         file << "## Errors = " << static_cast<uint16_t>(arguments.errors) << '\n';
         file << "## Cache thresholds = " << std::boolalpha << arguments.cache_thresholds << '\n';
+        if (!arguments.selected_bins.empty())
+            file << "## Selected user bins = " << std::ranges::count(arguments.selected_bins, true) << '\n';
         file << "### Index parameters\n";
         file << "## Index = " << arguments.index_file << '\n';
         file << "## Index hashes = " << hash_function_count << '\n';
@@ -64,14 +67,25 @@ public:
         file << "## False positive rate = " << arguments.fpr << '\n';
         file << "## Index is HIBF = " << std::boolalpha << arguments.is_hibf << '\n';
 
-        size_t user_bin_id{};
-        for (auto const & file_list : arguments.bin_path)
+        if (arguments.compact_header)
+        {
+            file << "## User bins = " << arguments.bin_path.size() << '\n';
+        }
+        else
         {
-            file << '#' << user_bin_id << '\t';
-            for (auto const elem : seqan::stl::views::join_with(file_list, ','))
-                file << elem;
-            file << '\n';
-            ++user_bin_id;
+            for (size_t user_bin_id = 0; user_bin_id < arguments.bin_path.size(); ++user_bin_id)
+            {
+                file << '#' << user_bin_id << '\t';
+                bool first{true};
+                arguments.bin_path.for_each_file(user_bin_id,
+                                                 [&](std::string_view const file_name)
+                                                 {
+                                                     if (!std::exchange(first, false))
+                                                         file << ',';
+                                                     file << file_name;
+                                                 });
+                file << '\n';
+            }
         }
 
         file << "#QUERY_NAME\tUSER_BINS\n";
@@ -0,0 +1,619 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::sectioned_index.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <omp.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <sharg/exceptions.hpp>
+
+#include <raptor/bin_path_table.hpp>
+#include <raptor/block_compression.hpp>
+#include <raptor/checksum_buffer.hpp>
+#include <raptor/index.hpp>
+#include <raptor/index_sections.hpp>
+
+namespace raptor
+{
+
+/*!\brief Stores and loads an index in sections that are written and read by multiple threads.
+ * \details
+ * Serialising a raptor::raptor_index with cereal is a single stream. For an HIBF with thousands of IBFs, storing and
+ * loading is limited by one thread, and the bin paths have to be read to get to any data. In a sectioned index, the
+ * IBFs and bin paths are independent sections, see raptor::index_section_table for the header. Each section is a
+ * cereal binary archive.
+ *
+ * The first section contains the raptor::raptor_index without the bin paths and without the IBFs, `next_ibf_id`, and
+ * `ibf_bin_to_user_bin_id` of the HIBF. This is the same data that raptor::raptor_index::load_parameters reads.
+ * A bin path section contains a raptor::bin_path_table with up to `bin_path_chunk_size` user bins, starting with the
+ * user bin `ID`. The tables of all sections are concatenated without decoding them.
+ * An IBF section contains the IBF `ID`. For the HIBF, the layout section contains `next_ibf_id` and
+ * `ibf_bin_to_user_bin_id` of all IBFs, such that the structure of the HIBF is known without reading any IBF, see
+ * raptor::lazy_hibf. Older files store `next_ibf_id` and `ibf_bin_to_user_bin_id` after the IBF in each IBF section.
+ *
+ * Uncompressed sections are written to and read from their offsets in any order, with one file stream per thread.
+ * Compressed sections (raptor::detail::compressing_buffer) are written one after another, and each section is
+ * compressed by all threads. When loading, sections that are bigger than their share of the index are decompressed by
+ * all threads, and all other sections are decompressed in parallel.
+ * The checksum of each section is verified by the thread that reads it.
+ */
+class sectioned_index
+{
+public:
+    static constexpr size_t bin_path_chunk_size{4096u};
+
+    //!\brief Whether the file at `path` is a sectioned index.
+    static bool is_sectioned(std::filesystem::path const & path)
+    {
+        return index_section_table::is_sectioned(path);
+    }
+
+    template <index_structure::is_valid data_t>
+    static void store(std::filesystem::path const & path,
+                      raptor_index<data_t> && index,
+                      uint8_t const threads,
+                      bool const compress)
+    {
+        std::vector<index_structure::ibf> ibf_vector{};
+        std::vector<std::vector<uint64_t>> next_ibf_id{};
+        std::vector<std::vector<uint64_t>> ibf_bin_to_user_bin_id{};
+        bin_path_table bin_path = std::move(index.bin_path_);
+        index.bin_path_ = bin_path_table{};
+
+        if constexpr (index_structure::is_hibf<data_t>)
+        {
+            auto & hibf = index.ibf_;
+            ibf_vector = std::move(hibf.ibf_vector);
+            next_ibf_id = std::move(hibf.next_ibf_id);
+            ibf_bin_to_user_bin_id = std::move(hibf.ibf_bin_to_user_bin_id);
+            hibf.ibf_vector.clear();
+            hibf.next_ibf_id.clear();
+            hibf.ibf_bin_to_user_bin_id.clear();
+        }
+        else
+        {
+            ibf_vector.push_back(std::move(index.ibf_));
+            index.ibf_ = index_structure::ibf{};
+        }
+
+        std::string const parameters = [&]()
+        {
+            std::ostringstream stream{};
+            cereal::BinaryOutputArchive archive{stream};
+            archive(index);
+            return std::move(stream).str();
+        }();
+
+        auto write_section = [&](std::ostream & stream, index_section const & current)
+        {
+            cereal::BinaryOutputArchive archive{stream};
+            switch (current.kind)
+            {
+            case section_kind::parameters:
+                break; // Already serialised.
+            case section_kind::bin_paths:
+                break; // Only read.
+            case section_kind::bin_path_table:
+                archive(bin_path.subtable(current.id, std::min(bin_path_chunk_size, bin_path.size() - current.id)));
+                break;
+            case section_kind::hibf_layout:
+                archive(next_ibf_id);
+                archive(ibf_bin_to_user_bin_id);
+                break;
+            case section_kind::ibf:
+                archive(ibf_vector[current.id]);
+            }
+        };
+
+        std::vector<index_section> sections{};
+        sections.push_back({.kind = section_kind::parameters,
+                            .size = parameters.size(),
+                            .memory_size = parameters.size(),
+                            .checksum = [&]()
+                            {
+                                detail::checksum result{};
+                                result.update(parameters.data(), parameters.size());
+                                return result.digest();
+                            }()});
+        for (size_t i = 0; i < bin_path.size(); i += bin_path_chunk_size)
+            sections.push_back({.kind = section_kind::bin_path_table, .id = i});
+        if constexpr (index_structure::is_hibf<data_t>)
+            sections.push_back({.kind = section_kind::hibf_layout});
+        for (size_t i = 0; i < ibf_vector.size(); ++i)
+            sections.push_back({.kind = section_kind::ibf, .id = i});
+        sections[0].offset = index_section_table::align(index_section_table::header_size(sections.size()));
+
+        if (compress)
+            store_compressed(path, sections, parameters, threads, write_section);
+        else
+            store_uncompressed(path, sections, parameters, threads, write_section);
+    }
+
+    template <index_structure::is_valid data_t>
+    static void load(std::filesystem::path const & path, raptor_index<data_t> & index, uint8_t const threads)
+    {
+        index_header const header = index_section_table::read(path);
+        std::vector<index_section> const & sections = header.sections;
+
+        {
+            std::ifstream stream{path, std::ios::binary};
+            read_section(stream,
+                         sections[0],
+                         1u,
+                         header.has_checksums(),
+                         [&](std::istream & section_stream, index_section const &)
+                         {
+                             cereal::BinaryInputArchive archive{section_stream};
+                             archive(index);
+                         });
+        }
+
+        size_t const ibf_count = std::ranges::count(sections, section_kind::ibf, &index_section::kind);
+        if constexpr (index_structure::is_hibf<data_t>)
+        {
+            index.ibf_.ibf_vector.resize(ibf_count);
+            index.ibf_.next_ibf_id.resize(ibf_count);
+            index.ibf_.ibf_bin_to_user_bin_id.resize(ibf_count);
+        }
+        else if (ibf_count != 1u)
+        {
+            throw sharg::parser_error{"Cannot read index: An IBF index must have one IBF section."};
+        }
+
+        std::vector<bin_path_table> bin_path_chunks(bin_path_chunk_count(sections));
+        bool const has_layout = std::ranges::contains(sections, section_kind::hibf_layout, &index_section::kind);
+
+        read_sections(path,
+                      header,
+                      threads,
+                      [](index_section const & current)
+                      {
+                          return current.kind != section_kind::parameters;
+                      },
+                      [&](std::istream & stream, index_section const & current)
+                      {
+                          cereal::BinaryInputArchive archive{stream};
+
+                          if (is_bin_path_section(current))
+                          {
+                              read_bin_paths(archive, current, bin_path_chunks);
+                          }
+                          else if (current.kind == section_kind::hibf_layout)
+                          {
+                              if constexpr (index_structure::is_hibf<data_t>)
+                                  read_layout(archive,
+                                              ibf_count,
+                                              index.ibf_.next_ibf_id,
+                                              index.ibf_.ibf_bin_to_user_bin_id);
+                          }
+                          else if (current.kind == section_kind::ibf)
+                          {
+                              if (current.id >= ibf_count)
+                                  throw sharg::parser_error{"Cannot read index: Invalid IBF section."};
+
+                              if constexpr (index_structure::is_hibf<data_t>)
+                              {
+                                  archive(index.ibf_.ibf_vector[current.id]);
+                                  if (!has_layout)
+                                  {
+                                      archive(index.ibf_.next_ibf_id[current.id]);
+                                      archive(index.ibf_.ibf_bin_to_user_bin_id[current.id]);
+                                  }
+                              }
+                              else
+                              {
+                                  archive(index.ibf_);
+                              }
+                          }
+                      });
+
+        index.bin_path_ = join(bin_path_chunks);
+    }
+
+    /*!\brief Loads the parameters and the layout of an HIBF, but none of its IBFs.
+     * \details
+     * `ibf_vector` is left empty; the IBFs can be loaded one at a time with load_ibf. The sections of the IBFs are
+     * returned, ordered by IBF ID.
+     * For files without a layout section, every IBF section is read once to get the layout.
+     */
+    static std::vector<index_section> load_layout(std::filesystem::path const & path,
+                                                  index_header const & header,
+                                                  raptor_index<index_structure::hibf> & index,
+                                                  uint8_t const threads)
+    {
+        load_parameters(path, index);
+
+        std::vector<index_section> ibf_sections{};
+        for (index_section const & current : header.sections)
+        {
+            if (current.kind != section_kind::ibf)
+                continue;
+            if (current.id != ibf_sections.size())
+                throw sharg::parser_error{"Cannot read index: Invalid IBF section."};
+            ibf_sections.push_back(current);
+        }
+
+        auto & hibf = index.ibf_;
+        hibf.ibf_vector.clear();
+        hibf.next_ibf_id.resize(ibf_sections.size());
+        hibf.ibf_bin_to_user_bin_id.resize(ibf_sections.size());
+        bool const has_layout =
+            std::ranges::contains(header.sections, section_kind::hibf_layout, &index_section::kind);
+
+        read_sections(path,
+                      header,
+                      threads,
+                      [has_layout](index_section const & current)
+                      {
+                          return current.kind == (has_layout ? section_kind::hibf_layout : section_kind::ibf);
+                      },
+                      [&](std::istream & stream, index_section const & current)
+                      {
+                          cereal::BinaryInputArchive archive{stream};
+                          if (has_layout)
+                          {
+                              read_layout(archive, ibf_sections.size(), hibf.next_ibf_id, hibf.ibf_bin_to_user_bin_id);
+                          }
+                          else
+                          {
+                              index_structure::ibf skipped{};
+                              archive(skipped);
+                              archive(hibf.next_ibf_id[current.id]);
+                              archive(hibf.ibf_bin_to_user_bin_id[current.id]);
+                          }
+                      });
+
+        return ibf_sections;
+    }
+
+    //!\brief Loads the IBF stored in `section`, see load_layout.
+    static void load_ibf(std::filesystem::path const & path,
+                         index_header const & header,
+                         index_section const & section,
+                         index_structure::ibf & ibf)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        read_section(stream,
+                     section,
+                     1u,
+                     header.has_checksums(),
+                     [&](std::istream & section_stream, index_section const &)
+                     {
+                         cereal::BinaryInputArchive archive{section_stream};
+                         archive(ibf);
+                     });
+    }
+
+    /*!\brief Like raptor::raptor_index::load_parameters, but does not load the bin paths.
+     * \details
+     * Only the header and the parameter section are read, no matter how many user bins there are.
+     * Use load_bin_paths to load the bin paths.
+     */
+    template <index_structure::is_valid data_t>
+    static void load_parameters(std::filesystem::path const & path, raptor_index<data_t> & index)
+    {
+        index_header const header = index_section_table::read(path);
+        std::ifstream stream{path, std::ios::binary};
+
+        read_section(stream,
+                     header.sections[0],
+                     1u,
+                     header.has_checksums(),
+                     [&](std::istream & section_stream, index_section const &)
+                     {
+                         cereal::BinaryInputArchive archive{section_stream};
+                         index.load_parameters(archive);
+                     });
+    }
+
+    //!\brief Loads only the bin paths, using `threads` threads.
+    static bin_path_table load_bin_paths(std::filesystem::path const & path, uint8_t const threads = 1u)
+    {
+        index_header const header = index_section_table::read(path);
+        std::vector<bin_path_table> bin_path_chunks(bin_path_chunk_count(header.sections));
+
+        read_sections(path,
+                      header,
+                      threads,
+                      [](index_section const & current)
+                      {
+                          return is_bin_path_section(current);
+                      },
+                      [&](std::istream & stream, index_section const & current)
+                      {
+                          cereal::BinaryInputArchive archive{stream};
+                          read_bin_paths(archive, current, bin_path_chunks);
+                      });
+
+        return join(bin_path_chunks);
+    }
+
+private:
+    static void store_uncompressed(std::filesystem::path const & path,
+                                   std::vector<index_section> & sections,
+                                   std::string const & parameters,
+                                   uint8_t const threads,
+                                   auto && write_section)
+    {
+        // The sizes are needed for the offsets. Counting the bytes does not copy any data.
+        for_each_section(sections.size(),
+                         threads,
+                         [&](size_t const i)
+                         {
+                             if (sections[i].kind == section_kind::parameters)
+                                 return;
+
+                             detail::checksum_writer counter{};
+                             std::ostream stream{&counter};
+                             write_section(stream, sections[i]);
+                             sections[i].size = counter.size();
+                             sections[i].memory_size = counter.size();
+                             sections[i].checksum = counter.digest();
+                         });
+
+        uint64_t offset = sections[0].offset;
+        uint64_t end{};
+        for (index_section & current : sections)
+        {
+            current.offset = index_section_table::align(offset);
+            offset = current.offset + current.size;
+            end = offset;
+        }
+
+        {
+            std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+            index_section_table::write(stream, sections);
+            index_section_table::pad(stream);
+            stream.write(parameters.data(), parameters.size());
+        }
+        std::filesystem::resize_file(path, end);
+
+        std::vector<std::fstream> streams(threads);
+        for_each_section(sections.size(),
+                         threads,
+                         [&](size_t const i)
+                         {
+                             if (sections[i].kind == section_kind::parameters)
+                                 return;
+
+                             std::fstream & stream = streams[omp_get_thread_num()];
+                             if (!stream.is_open())
+                                 stream.open(path, std::ios::binary | std::ios::in | std::ios::out);
+                             stream.seekp(sections[i].offset);
+                             write_section(stream, sections[i]);
+                             stream.flush();
+                             if (!stream.good())
+                                 throw std::runtime_error{"Could not write index " + path.string()};
+                         });
+    }
+
+    static void store_compressed(std::filesystem::path const & path,
+                                 std::vector<index_section> & sections,
+                                 std::string const & parameters,
+                                 uint8_t const threads,
+                                 auto && write_section)
+    {
+        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+        index_section_table::write(stream, sections); // Written again once the sizes are known.
+        index_section_table::pad(stream);
+        stream.write(parameters.data(), parameters.size());
+
+        for (index_section & current : sections)
+        {
+            if (current.kind == section_kind::parameters)
+                continue;
+
+            index_section_table::pad(stream);
+            current.offset = stream.tellp();
+            detail::checksum_writer checked{stream.rdbuf()};
+            std::ostream checked_stream{&checked};
+            detail::compressing_buffer buffer{checked_stream, threads};
+            {
+                std::ostream compressed{&buffer};
+                write_section(compressed, current);
+            }
+            buffer.finish();
+            current.size = buffer.compressed_size();
+            current.memory_size = buffer.raw_size();
+            current.encoding = section_encoding::zlib;
+            current.checksum = checked.digest();
+        }
+
+        stream.seekp(0);
+        index_section_table::write(stream, sections);
+        stream.flush();
+        if (!stream.good())
+            throw std::runtime_error{"Could not write index " + path.string()};
+    }
+
+    /*!\brief Calls `reader(stream, section)` for all sections for which `filter(section)` is true.
+     * \details
+     * Big compressed sections are read one after another, with `threads` threads each. All other sections are read in
+     * parallel.
+     */
+    static void read_sections(std::filesystem::path const & path,
+                              index_header const & header,
+                              uint8_t const threads,
+                              auto && filter,
+                              auto && reader)
+    {
+        std::vector<index_section> const & sections = header.sections;
+
+        // A big compressed section would keep one thread busy while the others are idle.
+        size_t memory_size{};
+        for (index_section const & current : sections)
+            if (filter(current))
+                memory_size += current.memory_size;
+
+        auto is_big = [&](index_section const & current)
+        {
+            return current.encoding != section_encoding::none && current.memory_size * threads > memory_size;
+        };
+
+        {
+            std::ifstream stream{path, std::ios::binary};
+            for (index_section const & current : sections)
+                if (filter(current) && is_big(current))
+                    read_section(stream, current, threads, header.has_checksums(), reader);
+        }
+
+        std::vector<std::ifstream> streams(threads);
+        for_each_section(sections.size(),
+                         threads,
+                         [&](size_t const i)
+                         {
+                             index_section const & current = sections[i];
+                             if (!filter(current) || is_big(current))
+                                 return;
+
+                             std::ifstream & stream = streams[omp_get_thread_num()];
+                             if (!stream.is_open())
+                                 stream.open(path, std::ios::binary);
+                             read_section(stream, current, 1u, header.has_checksums(), reader);
+                         });
+    }
+
+    /*!\brief Calls `reader(stream, section)` with a stream that contains the decoded section.
+     * \details
+     * If `verify` is true, the checksum of the section is compared after reading it. If `reader` throws, e.g., because
+     * cereal cannot read a corrupted section, a checksum mismatch is reported instead.
+     */
+    static void read_section(std::istream & stream,
+                             index_section const & section,
+                             uint8_t const threads,
+                             bool const verify,
+                             auto && reader)
+    {
+        stream.seekg(section.offset);
+        detail::checksum_reader checked{stream.rdbuf(), section.size};
+        std::istream checked_stream{&checked};
+
+        auto is_corrupted = [&]()
+        {
+            return verify && checked.finish() != section.checksum;
+        };
+
+        try
+        {
+            switch (section.encoding)
+            {
+            case section_encoding::none:
+                reader(checked_stream, section);
+                break;
+            case section_encoding::zlib:
+            {
+                detail::decompressing_buffer buffer{checked_stream, section.size, threads};
+                std::istream decompressed{&buffer};
+                reader(decompressed, section);
+                break;
+            }
+            default:
+                throw sharg::parser_error{"Cannot read index: Unknown section encoding."};
+            }
+        }
+        catch (std::exception const &)
+        {
+            if (is_corrupted())
+                throw sharg::parser_error{"Cannot read index: Checksum mismatch. The index is corrupted."};
+            throw;
+        }
+
+        if (is_corrupted())
+            throw sharg::parser_error{"Cannot read index: Checksum mismatch. The index is corrupted."};
+    }
+
+    static bool is_bin_path_section(index_section const & section) noexcept
+    {
+        return section.kind == section_kind::bin_paths || section.kind == section_kind::bin_path_table;
+    }
+
+    static size_t bin_path_chunk_count(std::vector<index_section> const & sections)
+    {
+        return std::ranges::count_if(sections, &is_bin_path_section);
+    }
+
+    static void read_bin_paths(cereal::BinaryInputArchive & archive,
+                               index_section const & section,
+                               std::vector<bin_path_table> & chunks)
+    {
+        if (section.id % bin_path_chunk_size != 0u || section.id / bin_path_chunk_size >= chunks.size())
+            throw sharg::parser_error{"Cannot read index: Invalid bin path section."};
+
+        bin_path_table & chunk = chunks[section.id / bin_path_chunk_size];
+        if (section.kind == section_kind::bin_path_table)
+        {
+            archive(chunk);
+        }
+        else
+        {
+            std::vector<std::vector<std::string>> bin_path{};
+            archive(bin_path);
+            chunk = bin_path_table{bin_path};
+        }
+    }
+
+    static void read_layout(cereal::BinaryInputArchive & archive,
+                            size_t const ibf_count,
+                            std::vector<std::vector<uint64_t>> & next_ibf_id,
+                            std::vector<std::vector<uint64_t>> & ibf_bin_to_user_bin_id)
+    {
+        archive(next_ibf_id);
+        archive(ibf_bin_to_user_bin_id);
+        if (next_ibf_id.size() != ibf_count || ibf_bin_to_user_bin_id.size() != ibf_count)
+            throw sharg::parser_error{"Cannot read index: Invalid HIBF layout section."};
+    }
+
+    static bin_path_table join(std::vector<bin_path_table> const & chunks)
+    {
+        bin_path_table result{};
+        for (bin_path_table const & chunk : chunks)
+            result.append(chunk);
+        return result;
+    }
+
+    //!\brief Calls `worker(i)` for all sections in parallel. The first exception is rethrown.
+    static void for_each_section(size_t const section_count, uint8_t const threads, auto && worker)
+    {
+        std::exception_ptr exception{};
+        std::mutex exception_mutex{};
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (size_t i = 0; i < section_count; ++i)
+        {
+            try
+            {
+                worker(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard{exception_mutex};
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+};
+
+} // namespace raptor
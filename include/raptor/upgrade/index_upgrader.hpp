@@ -3,14 +3,16 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 /*!\file
- * \brief Provides raptor::index_upgrader.
+ * \brief Provides raptor::index_upgrader and raptor::sectioned_index_upgrader.
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
 #pragma once
 
 #include <raptor/argument_parsing/upgrade_arguments.hpp>
+#include <raptor/build/store_index.hpp>
 #include <raptor/index.hpp>
+#include <raptor/search/load_index.hpp>
 
 namespace raptor
 {
@@ -63,4 +65,42 @@ namespace raptor
 //     }
 // };
 
+/*!\brief Converts an index of Raptor 4.0 or newer to the current format of raptor::sectioned_index.
+ * \details
+ * The input may be a raptor::raptor_index serialised with cereal (index version 3) or any version of a sectioned
+ * index. The index itself does not change.
+ */
+class sectioned_index_upgrader
+{
+public:
+    sectioned_index_upgrader() = delete;
+    sectioned_index_upgrader(sectioned_index_upgrader const &) = delete;
+    sectioned_index_upgrader(sectioned_index_upgrader &&) = delete;
+    sectioned_index_upgrader & operator=(sectioned_index_upgrader const &) = delete;
+    sectioned_index_upgrader & operator=(sectioned_index_upgrader &&) = delete;
+    ~sectioned_index_upgrader() = default;
+
+    explicit sectioned_index_upgrader(upgrade_arguments const & arguments) : arguments{std::addressof(arguments)}
+    {}
+
+    void upgrade(std::filesystem::path const & index_file, std::filesystem::path const & output_file) const
+    {
+        if (arguments->is_hibf)
+            upgrade<index_structure::hibf>(index_file, output_file);
+        else
+            upgrade<index_structure::ibf>(index_file, output_file);
+    }
+
+private:
+    upgrade_arguments const * arguments{nullptr};
+
+    template <index_structure::is_valid data_t>
+    void upgrade(std::filesystem::path const & index_file, std::filesystem::path const & output_file) const
+    {
+        raptor_index<data_t> index{};
+        detail::load_index(index, index_file, arguments->threads);
+        store_index(output_file, std::move(index), arguments->threads, arguments->compress);
+    }
+};
+
 } // namespace raptor
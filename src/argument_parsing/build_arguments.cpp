@@ -65,6 +65,10 @@ void build_arguments::print_timings() const
     std::cerr << "│   ├── Max [s]: " << fill_ibf_timer.max_in_seconds() << '\n';
     std::cerr << "│   └── Avg [s]: " << fill_ibf_timer.avg_in_seconds() << '\n';
     std::cerr << "└── Store index [s]: " << store_index_timer.in_seconds() << '\n';
+
+    // The HIBF fills its IBFs internally; the counters are only recorded for the IBF.
+    if (perf_counters && !is_hibf)
+        detail::print_perf_counters({{"Fill IBF", "fill_ibf", fill_ibf_perf}});
 }
 
 void build_arguments::write_timings_to_file() const
@@ -73,6 +77,7 @@ void build_arguments::write_timings_to_file() const
     output_stream << std::fixed << std::setprecision(2);
     output_stream << "peak_memory_usage_in_kibibytes\t"
                   << "index_size_in_kibibytes\t"
+                  << "index_memory_size_in_kibibytes\t"
                   << "configured_threads\t"
                   << "wall_clock_time_in_seconds\t"
                   << "user_time_in_seconds\t"
@@ -86,7 +91,9 @@ void build_arguments::write_timings_to_file() const
                   << "merge_kmer_sets_avg_in_seconds\t"
                   << "fill_ibf_max_in_seconds\t"
                   << "fill_ibf_avg_in_seconds\t"
-                  << "store_index_in_seconds\n";
+                  << "store_index_in_seconds";
+    detail::write_perf_counter_header(output_stream, "fill_ibf");
+    output_stream << '\n';
 
     if (long const peak_ram_KiB = peak_ram_in_KiB(); peak_ram_KiB != -1L)
         output_stream << peak_ram_KiB << '\t';
@@ -94,6 +101,7 @@ void build_arguments::write_timings_to_file() const
         output_stream << "NA\t"; // GCOVR_EXCL_LINE
 
     output_stream << index_size_in_KiB(out_path, parts) << '\t';
+    output_stream << index_memory_size_in_KiB(out_path, parts) << '\t';
     output_stream << static_cast<size_t>(threads) << '\t';
     output_stream << wall_clock_timer.in_seconds() << '\t';
 
@@ -132,7 +140,9 @@ void build_arguments::write_timings_to_file() const
 
     output_stream << fill_ibf_timer.max_in_seconds() << '\t';
     output_stream << fill_ibf_timer.avg_in_seconds() << '\t';
-    output_stream << store_index_timer.in_seconds() << '\n';
+    output_stream << store_index_timer.in_seconds();
+    detail::write_perf_counter_values(output_stream, fill_ibf_perf);
+    output_stream << '\n';
 }
 
 } // namespace raptor
@@ -19,8 +19,12 @@
 #include <raptor/argument_parsing/compute_bin_size.hpp>
 #include <raptor/argument_parsing/parse_bin_path.hpp>
 #include <raptor/argument_parsing/shared.hpp>
+#include <raptor/argument_parsing/to_bytes.hpp>
 #include <raptor/argument_parsing/validators.hpp>
+#include <raptor/block_compression.hpp>
 #include <raptor/build/raptor_build.hpp>
+#include <raptor/minimiser_container.hpp>
+#include <raptor/minimiser_file.hpp>
 
 namespace raptor
 {
@@ -77,11 +81,9 @@ inline void parse_shape_from_minimiser(sharg::parser & parser, build_arguments &
     if (parser.is_option_set("window"))
         throw sharg::parser_error{"You cannot set --window when using minimiser files as input."};
 
-    std::filesystem::path header_file_path = arguments.bin_path[0][0];
-    header_file_path.replace_extension("header");
-    std::ifstream file_stream{header_file_path};
-    std::string shape_string{};
-    file_stream >> shape_string >> arguments.window_size;
+    minimiser_header const header = find_minimiser_header(arguments.bin_path[0][0]).value_or(minimiser_header{});
+    std::string const & shape_string = header.shape_string;
+    arguments.window_size = static_cast<uint32_t>(header.window_size);
 
     uint64_t tmp{};
     std::from_chars(shape_string.data(), shape_string.data() + shape_string.size(), tmp, 2);
@@ -89,6 +91,18 @@ inline void parse_shape_from_minimiser(sharg::parser & parser, build_arguments &
     arguments.shape = seqan3::shape{seqan3::bin_literal{tmp}};
 }
 
+inline size_t parse_memory(std::string_view const option, std::string const & value)
+{
+    try
+    {
+        return to_bytes(value);
+    }
+    catch (std::exception const & exception)
+    {
+        throw sharg::parser_error{"--" + std::string{option} + ": " + exception.what()};
+    }
+}
+
 void init_build_parser(sharg::parser & parser, build_arguments & arguments)
 {
     parser.info.short_description = "Constructs a Raptor index";
@@ -125,7 +139,10 @@ void init_build_parser(sharg::parser & parser, build_arguments & arguments)
     parser.add_option(arguments.threads,
                       sharg::config{.short_id = '\0',
                                     .long_id = "threads",
-                                    .description = "The number of threads to use.",
+                                    .description = "The number of threads to use. For the IBF, a big user bin of "
+                                                   "uncompressed FASTA or FASTQ files is split into parts that are "
+                                                   "hashed by all threads. Compressed files (.gz, .bgzf, .bz2) are "
+                                                   "not split; each is read by a single thread.",
                                     .validator = positive_integer_validator{}});
     parser.add_flag(arguments.quiet,
                     sharg::config{.short_id = '\0',
@@ -136,6 +153,18 @@ void init_build_parser(sharg::parser & parser, build_arguments & arguments)
                                     .long_id = "timing-output",
                                     .description = "Write time and memory usage to specified file (TSV format).",
                                     .validator = output_file_validator{}});
+    parser.add_option(arguments.trace_out,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "trace",
+                                    .description = "Write a timeline of the execution to the specified file (Chrome "
+                                                   "trace event format, e.g., for https://ui.perfetto.dev).",
+                                    .validator = output_file_validator{}});
+    parser.add_flag(arguments.perf_counters,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "perf-counters",
+                                  .description = "Record hardware performance counters (cycles, instructions, cache "
+                                                 "and TLB misses) per phase. Requires Linux and access to "
+                                                 "perf_event_open. Unavailable counters are reported as NA."});
 
     parser.add_subsection("k-mer options");
     parser.add_option(
@@ -178,6 +207,58 @@ void init_build_parser(sharg::parser & parser, build_arguments & arguments)
                                     .long_id = "parts",
                                     .description = "Splits the index in this many parts. Not available for the HIBF.",
                                     .validator = power_of_two_validator{}});
+    parser.add_flag(arguments.single_pass,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "single-pass",
+                                  .description = "Only with --parts. Reads each input file only once and writes the "
+                                                 "minimisers of each part to temporary files in <output>.spill. "
+                                                 "Requires temporary disk space of about 8 bytes per distinct "
+                                                 "minimiser of each user bin."});
+    parser.add_option(arguments.store_memory_string,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "store-memory",
+                                    .description = "Only with --parts. Parts are written to disk while the next part "
+                                                   "is built. Limits the memory of parts that are waiting to be "
+                                                   "written, e.g., 16G or 64Gi. At least one part is always written "
+                                                   "in the background.",
+                                    .default_message = "one part"});
+    parser.add_option(arguments.count_memory_string,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "count-memory",
+                                    .description = "Limits the memory used to count the minimisers of the biggest "
+                                                   "user bin, e.g., 16G or 64Gi. If the limit is exceeded, the user "
+                                                   "bin is read multiple times. Not used for the HIBF.",
+                                    .default_message = "no limit"});
+    parser.add_option(arguments.index_memory_string,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "index-memory",
+                                    .description = "Not with --parts. Limits the memory of the index, e.g., 16G or "
+                                                   "64Gi. A bigger index is built in slices that are written to the "
+                                                   "output one after another. The index does not change, but the "
+                                                   "build is slower: The input is read and hashed once per slice, so "
+                                                   "n slices take about n times as long as reading the input once. "
+                                                   "Use minimiser files from \\fBraptor prepare\\fP to avoid "
+                                                   "computing the minimisers multiple times. In addition, each hash "
+                                                   "sets its bit with an atomic operation instead of the buffered "
+                                                   "insertion of a build in memory. Not available for the HIBF.",
+                                    .default_message = "no limit"});
+    parser.add_flag(arguments.minimiser_store,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "minimiser-store",
+                                  .description = "Only for the HIBF. Stores the minimisers of each user bin in "
+                                                 "<output>.minimisers. Each user bin is only read once, even if it "
+                                                 "is part of merged bins. If the build is interrupted and run again, "
+                                                 "the user bins that were already stored are not read again; the HIBF "
+                                                 "itself is constructed again. \\fBraptor update\\fP uses the "
+                                                 "stored minimisers instead of reading the user bins again. Has no "
+                                                 "effect for minimiser files as input."});
+    parser.add_flag(arguments.compress,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "compress",
+                                  .description = "Compresses the index in blocks with zlib. Blocks are compressed "
+                                                 "and decompressed with multiple threads. Loading a compressed index "
+                                                 "takes longer if the threads are faster than the file system. Not "
+                                                 "with --index-memory."});
 
     // GCOVR_EXCL_START
     // Adding additional cwl information that currently aren't supported by sharg and tdl.
@@ -242,10 +323,14 @@ void build_parsing(sharg::parser & parser)
 {
     build_arguments arguments{};
     arguments.wall_clock_timer.start();
+    minimiser_container::cache const container_cache{};
 
     init_build_parser(parser, arguments);
     parser.parse();
 
+    if (parser.is_option_set("trace"))
+        arguments.trace.enable();
+
     if (std::filesystem::is_empty(arguments.bin_file))
         throw sharg::parser_error{"The input file is empty."};
 
@@ -254,6 +339,38 @@ void build_parsing(sharg::parser & parser)
     if (arguments.is_hibf && arguments.parts != 1u)
         throw sharg::parser_error{"The HIBF cannot yet be partitioned."};
 
+    if (arguments.single_pass && arguments.parts == 1u)
+        throw sharg::parser_error{"--single-pass requires --parts."};
+
+    if (parser.is_option_set("store-memory"))
+    {
+        if (arguments.parts == 1u)
+            throw sharg::parser_error{"--store-memory requires --parts."};
+
+        arguments.store_memory = parse_memory("store-memory", arguments.store_memory_string);
+    }
+
+    if (parser.is_option_set("count-memory"))
+        arguments.count_memory = parse_memory("count-memory", arguments.count_memory_string);
+
+    if (arguments.minimiser_store && !arguments.is_hibf)
+        throw sharg::parser_error{"--minimiser-store is only available for the HIBF."};
+
+    if (arguments.compress && !detail::has_block_compression)
+        throw sharg::parser_error{"--compress is not available. Raptor was built without zlib."};
+
+    if (parser.is_option_set("index-memory"))
+    {
+        if (arguments.compress)
+            throw sharg::parser_error{"--index-memory cannot be used with --compress."};
+        if (arguments.parts != 1u)
+            throw sharg::parser_error{"--index-memory cannot be used with --parts."};
+        if (arguments.is_hibf)
+            throw sharg::parser_error{"--index-memory is not available for the HIBF."};
+
+        arguments.index_memory = parse_memory("index-memory", arguments.index_memory_string);
+    }
+
     parse_bin_path(arguments);
 
     if (arguments.is_hibf)
@@ -265,7 +382,10 @@ void build_parsing(sharg::parser & parser)
         parse_shape_from_minimiser(parser, arguments);
 
     if (!arguments.is_hibf && arguments.parts == 1u)
+    {
+        auto span = arguments.trace.scoped("Compute bin size", "build");
         arguments.bits = compute_bin_size(arguments);
+    }
 
     raptor_build(arguments);
 
@@ -274,6 +394,8 @@ void build_parsing(sharg::parser & parser)
         arguments.print_timings();
     if (parser.is_option_set("timing-output"))
         arguments.write_timings_to_file();
+    if (parser.is_option_set("trace"))
+        arguments.trace.write(arguments.trace_out);
 }
 
 } // namespace raptor
@@ -10,14 +10,16 @@
 #include <seqan3/search/views/minimiser_hash.hpp>
 
 #include <hibf/build/bin_size_in_bits.hpp>
-#include <hibf/contrib/robin_hood.hpp>
 #include <hibf/sketch/hyperloglog.hpp>
 
 #include <raptor/adjust_seed.hpp>
 #include <raptor/argument_parsing/compute_bin_size.hpp>
 #include <raptor/call_parallel_on_bins.hpp>
 #include <raptor/dna4_traits.hpp>
+#include <raptor/exact_distinct_count.hpp>
 #include <raptor/file_reader.hpp>
+#include <raptor/minimiser_file.hpp>
+#include <raptor/minimiser_header.hpp>
 
 namespace raptor
 {
@@ -52,7 +54,7 @@ size_t kmer_count_from_minimiser_files(std::vector<std::vector<std::string>> con
             for (auto && file_name : file_names)
             {
                 minimiser_file = file_name;
-                size_t const size = std::filesystem::file_size(minimiser_file);
+                size_t const size = minimiser_count(minimiser_file);
                 if (size > max_filesize)
                 {
                     max_filesize = size;
@@ -66,22 +68,14 @@ size_t kmer_count_from_minimiser_files(std::vector<std::vector<std::string>> con
 
     call_parallel_on_bins(worker, bin_path, threads);
 
-    std::string shape_string{};
-    uint64_t window_size{};
-    uint16_t cutoff{};
-    size_t max_count{};
-
-    biggest_file.replace_extension("header");
-    std::ifstream file_stream{biggest_file};
-    file_stream >> shape_string >> window_size >> cutoff >> max_count;
-
-    return max_count;
+    return find_minimiser_header(biggest_file).value_or(minimiser_header{}).count;
 }
 
 size_t kmer_count_from_sequence_files(std::vector<std::vector<std::string>> const & bin_path,
                                       uint8_t const threads,
                                       seqan3::shape const & shape,
-                                      uint32_t const window_size)
+                                      uint32_t const window_size,
+                                      size_t const memory_limit)
 {
     size_t max_count{};
     size_t max_bin_id{};
@@ -118,11 +112,15 @@ size_t kmer_count_from_sequence_files(std::vector<std::vector<std::string>> cons
     call_parallel_on_bins(worker, bin_path, threads);
 
     // Get exact count for biggest bin. Sketch estimate's accuracy depends on sketch_bits (here: 15).
-    robin_hood::unordered_flat_set<uint64_t> kmers{};
-    auto insert_it = std::inserter(kmers, kmers.end());
-    reader.hash_into(bin_path[max_bin_id], insert_it);
-
-    return kmers.size();
+    return exact_distinct_count(reader,
+                                bin_path[max_bin_id],
+                                max_count,
+                                threads,
+                                memory_limit,
+                                [](uint64_t const)
+                                {
+                                    return true;
+                                });
 }
 
 } // namespace detail
@@ -135,7 +133,8 @@ size_t compute_bin_size(build_arguments const & arguments)
                                : detail::kmer_count_from_sequence_files(arguments.bin_path,
                                                                         arguments.threads,
                                                                         arguments.shape,
-                                                                        arguments.window_size);
+                                                                        arguments.window_size,
+                                                                        arguments.count_memory);
     arguments.bin_size_timer.stop();
 
     assert(max_count > 0u);
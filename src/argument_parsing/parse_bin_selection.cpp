@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Implements raptor::parse_bin_selection.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <string>
+
+#include <sharg/exceptions.hpp>
+
+#include <raptor/argument_parsing/parse_bin_selection.hpp>
+
+namespace raptor
+{
+
+namespace detail
+{
+
+bool matches_pattern(std::string_view const pattern, std::string_view const text)
+{
+    size_t pattern_pos{};
+    size_t text_pos{};
+    // Position of the last `*` in the pattern, and of the text that it currently matches up to.
+    size_t star_pos{std::string_view::npos};
+    size_t star_text_pos{};
+
+    while (text_pos < text.size())
+    {
+        if (pattern_pos < pattern.size() && (pattern[pattern_pos] == '?' || pattern[pattern_pos] == text[text_pos]))
+        {
+            ++pattern_pos;
+            ++text_pos;
+        }
+        else if (pattern_pos < pattern.size() && pattern[pattern_pos] == '*')
+        {
+            star_pos = pattern_pos++;
+            star_text_pos = text_pos;
+        }
+        else if (star_pos != std::string_view::npos)
+        {
+            // Let the last `*` match one more character.
+            pattern_pos = star_pos + 1u;
+            text_pos = ++star_text_pos;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (pattern_pos < pattern.size() && pattern[pattern_pos] == '*')
+        ++pattern_pos;
+
+    return pattern_pos == pattern.size();
+}
+
+std::vector<std::string> read_bin_selection(std::string const & bins)
+{
+    std::vector<std::string> entries{};
+    auto add_entry = [&entries](std::string_view entry)
+    {
+        while (!entry.empty() && std::isspace(static_cast<unsigned char>(entry.front())))
+            entry.remove_prefix(1u);
+        while (!entry.empty() && std::isspace(static_cast<unsigned char>(entry.back())))
+            entry.remove_suffix(1u);
+        if (!entry.empty())
+            entries.emplace_back(entry);
+    };
+
+    if (bins.starts_with('@'))
+    {
+        std::filesystem::path const file{bins.substr(1u)};
+        if (!std::filesystem::is_regular_file(file))
+            throw sharg::parser_error{"--bins: The file " + file.string() + " does not exist."};
+
+        std::ifstream istrm{file};
+        std::string line{};
+        while (std::getline(istrm, line))
+            if (!line.starts_with('#'))
+                add_entry(line);
+    }
+    else
+    {
+        for (auto && entry : std::views::split(bins, ','))
+            add_entry(std::string_view{entry});
+    }
+
+    return entries;
+}
+
+// Parses `<id>` and `<first>-<last>`. Returns false for anything else, e.g., a pattern.
+bool parse_user_bin_range(std::string_view const entry, uint64_t & first, uint64_t & last)
+{
+    auto parse = [](std::string_view const number, uint64_t & value)
+    {
+        auto const [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), value);
+        return !number.empty() && ec == std::errc{} && ptr == number.data() + number.size();
+    };
+
+    size_t const dash = entry.find('-');
+    if (dash == std::string_view::npos)
+    {
+        if (!parse(entry, first))
+            return false;
+        last = first;
+        return true;
+    }
+
+    return parse(entry.substr(0u, dash), first) && parse(entry.substr(dash + 1u), last);
+}
+
+} // namespace detail
+
+void parse_bin_selection(search_arguments & arguments)
+{
+    size_t const user_bins = arguments.bin_path.size();
+    std::vector<bool> & selected = arguments.selected_bins;
+    selected.assign(user_bins, false);
+
+    std::vector<std::string> patterns{};
+    for (std::string const & entry : detail::read_bin_selection(arguments.bins))
+    {
+        uint64_t first{};
+        uint64_t last{};
+        if (!detail::parse_user_bin_range(entry, first, last))
+        {
+            patterns.push_back(entry);
+            continue;
+        }
+
+        if (first > last || last >= user_bins)
+        {
+            throw sharg::parser_error{"--bins: The user bin ID " + entry + " is invalid. The index has "
+                                      + std::to_string(user_bins) + " user bins."};
+        }
+
+        std::fill(selected.begin() + first, selected.begin() + last + 1u, true);
+    }
+
+    if (!patterns.empty())
+    {
+        std::vector<bool> pattern_matched(patterns.size(), false);
+        size_t user_bin_id{};
+        auto match_file = [&](std::string_view const file_name)
+        {
+            std::string_view const base_name = file_name.substr(file_name.rfind('/') + 1u);
+            for (size_t i = 0; i < patterns.size(); ++i)
+            {
+                bool const has_directory = patterns[i].contains('/');
+                if (detail::matches_pattern(patterns[i], has_directory ? file_name : base_name))
+                {
+                    selected[user_bin_id] = true;
+                    pattern_matched[i] = true;
+                }
+            }
+        };
+
+        for (; user_bin_id < user_bins; ++user_bin_id)
+            arguments.bin_path.for_each_file(user_bin_id, match_file);
+
+        for (size_t i = 0; i < patterns.size(); ++i)
+        {
+            if (pattern_matched[i])
+                continue;
+
+            std::string message{"--bins: No user bin matches " + patterns[i] + '.'};
+            if (std::filesystem::is_regular_file(patterns[i]))
+                message += " Use --bins @" + patterns[i] + " to read the user bins from this file.";
+            throw sharg::parser_error{message};
+        }
+    }
+
+    if (std::ranges::find(selected, true) == selected.end())
+        throw sharg::parser_error{"--bins does not select any user bin."};
+}
+
+} // namespace raptor
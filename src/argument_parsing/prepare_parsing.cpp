@@ -11,6 +11,7 @@
 #include <raptor/argument_parsing/prepare_arguments.hpp>
 #include <raptor/argument_parsing/prepare_parsing.hpp>
 #include <raptor/argument_parsing/shared.hpp>
+#include <raptor/argument_parsing/to_bytes.hpp>
 #include <raptor/argument_parsing/validators.hpp>
 #include <raptor/prepare/compute_minimiser.hpp>
 
@@ -29,7 +30,8 @@ void init_prepare_parser(sharg::parser & parser, prepare_arguments & arguments)
                                       "--use-filesize-dependent-cutoff");
     parser.info.synopsis.emplace_back(
         "raptor prepare --input <file> --output <directory> [--threads <number>] [--quiet] [--kmer <number>|--shape "
-        "<01-pattern>] [--window <number>] [--kmer-count-cutoff <number>|--use-filesize-dependent-cutoff]");
+        "<01-pattern>] [--window <number>] [--kmer-count-cutoff <number>|--use-filesize-dependent-cutoff] "
+        "[--compress] [--memory <size>] [--container]");
 
     parser.add_subsection("General options");
     parser.add_option(
@@ -52,19 +54,36 @@ void init_prepare_parser(sharg::parser & parser, prepare_arguments & arguments)
                          "\\fBWhen you manually delete a .in_progress file, also delete the corresponding .header and "
                          ".minimiser file!\\fP");
     parser.add_list_item("", "Created output files for each file:");
-    parser.add_list_item("", "\\fB*.header\\fP: Contains the shape, window size, cutoff and minimiser count.");
+    parser.add_list_item("",
+                         "\\fB*.header\\fP: Contains the shape, window size, cutoff and minimiser count. The second "
+                         "line contains the minimiser counts per suffix, which \\fBraptor build --parts\\fP uses.");
     parser.add_list_item("", "\\fB*.minimiser\\fP: Contains binary minimiser values, one minimiser per line.");
     parser.add_list_item(
         "",
         "\\fB*.in_progress\\fP: Temporary file to track process. Deleted after finishing computation.");
+    parser.add_list_item("",
+                         "\\fB*.bucket_*\\fP: Temporary files if \\fB--memory\\fP is exceeded. Deleted after "
+                         "finishing computation.");
+    parser.add_list_item("",
+                         "\\fBminimiser_*.shard\\fP, \\fBminimiser_*.shard_index\\fP: Replace the .minimiser and "
+                         ".header files if \\fB--container\\fP is set.");
     parser.add_option(arguments.threads,
                       sharg::config{.short_id = '\0',
                                     .long_id = "threads",
-                                    .description = "The number of threads to use.",
+                                    .description = "The number of threads to use. A big user bin of "
+                                                   "uncompressed FASTA or FASTQ files is split into parts that are "
+                                                   "hashed by all threads. Compressed files (.gz, .bgzf, .bz2) are "
+                                                   "not split; each is read by a single thread.",
                                     .validator = positive_integer_validator{}});
     parser.add_flag(
         arguments.quiet,
         sharg::config{.short_id = '\0', .long_id = "quiet", .description = "Do not print time and memory usage."});
+    parser.add_option(arguments.trace_out,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "trace",
+                                    .description = "Write a timeline of the execution to the specified file (Chrome "
+                                                   "trace event format, e.g., for https://ui.perfetto.dev).",
+                                    .validator = output_file_validator{}});
 
     parser.add_subsection("k-mer options");
     parser.add_option(arguments.kmer_size,
@@ -99,6 +118,27 @@ void init_prepare_parser(sharg::parser & parser, prepare_arguments & arguments)
                                   .long_id = "use-filesize-dependent-cutoff",
                                   .description = "Apply cutoffs from Mantis(Pandey et al., 2018). "
                                                  "Mutually exclusive with --kmer-count-cutoff."});
+    parser.add_flag(arguments.compress,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "compress",
+                                  .description = "Store the minimisers sorted and delta-encoded. Usually several "
+                                                 "times smaller. The compressed files can be used with \\fBraptor "
+                                                 "build\\fP, but not with \\fBraptor layout\\fP."});
+    parser.add_option(arguments.memory_string,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "memory",
+                                    .description = "Limits the memory used to count the minimisers, e.g., 16G or 64Gi. "
+                                                   "The limit is shared by all threads. If the minimisers of a file "
+                                                   "do not fit, they are counted in buckets on disk in the output "
+                                                   "directory. The result does not change.",
+                                    .default_message = "no limit"});
+    parser.add_flag(arguments.container,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "container",
+                                  .description = "Append the minimisers of all files to a few shard files, one per "
+                                                 "thread, instead of writing two files per input file. The "
+                                                 "minimiser.list can be used with \\fBraptor build\\fP, but not with "
+                                                 "\\fBraptor layout\\fP."});
 }
 
 void prepare_parsing(sharg::parser & parser)
@@ -109,9 +149,24 @@ void prepare_parsing(sharg::parser & parser)
     init_prepare_parser(parser, arguments);
     parser.parse();
 
+    if (parser.is_option_set("trace"))
+        arguments.trace.enable();
+
     if (parser.is_option_set("kmer-count-cutoff") && parser.is_option_set("use-filesize-dependent-cutoff"))
         throw sharg::parser_error{"You cannot use both --kmer-count-cutoff and --use-filesize-dependent-cutoff."};
 
+    if (parser.is_option_set("memory"))
+    {
+        try
+        {
+            arguments.memory = to_bytes(arguments.memory_string);
+        }
+        catch (std::exception const & exception)
+        {
+            throw sharg::parser_error{std::string{"--memory: "} + exception.what()};
+        }
+    }
+
     validate_shape(parser, arguments);
 
     parse_bin_path(arguments);
@@ -120,6 +175,8 @@ void prepare_parsing(sharg::parser & parser)
 
     arguments.wall_clock_timer.stop();
     arguments.print_timings();
+    if (parser.is_option_set("trace"))
+        arguments.trace.write(arguments.trace_out);
 }
 
 } // namespace raptor
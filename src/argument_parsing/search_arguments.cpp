@@ -8,6 +8,9 @@
  */
 
 #include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <raptor/argument_parsing/cpu_time.hpp>
 #include <raptor/argument_parsing/formatted_index_size.hpp>
@@ -17,6 +20,49 @@
 namespace raptor
 {
 
+namespace detail
+{
+
+inline double per_second(uint64_t const count, double const seconds)
+{
+    return seconds > 0.0 ? count / seconds : 0.0;
+}
+
+inline void print_latency(std::string_view const prefix, concurrent_latency_histogram const & histogram)
+{
+    std::cerr << prefix << "├── p50 [us]: " << histogram.percentile_in_microseconds(50.0) << '\n';
+    std::cerr << prefix << "├── p95 [us]: " << histogram.percentile_in_microseconds(95.0) << '\n';
+    std::cerr << prefix << "├── p99 [us]: " << histogram.percentile_in_microseconds(99.0) << '\n';
+    std::cerr << prefix << "└── Max [us]: " << histogram.max_in_microseconds() << '\n';
+}
+
+inline void write_latency(std::ostream & output_stream, concurrent_latency_histogram const & histogram)
+{
+    if (histogram.count() == 0u)
+    {
+        output_stream << "NA\tNA\tNA\tNA";
+        return;
+    }
+
+    output_stream << histogram.percentile_in_microseconds(50.0) << '\t';
+    output_stream << histogram.percentile_in_microseconds(95.0) << '\t';
+    output_stream << histogram.percentile_in_microseconds(99.0) << '\t';
+    output_stream << histogram.max_in_microseconds();
+}
+
+inline void print_hibf_levels(std::vector<hibf_level_counts> const & levels)
+{
+    std::cerr << "HIBF levels loaded on demand\n";
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        std::cerr << (level + 1u == levels.size() ? "└── " : "├── ") << "Level " << level
+                  << ": Queried IBFs: " << levels[level].queries << ", Loaded IBFs: " << levels[level].loads
+                  << ", Hit rate [%]: " << levels[level].hit_rate_in_percent() << '\n';
+    }
+}
+
+} // namespace detail
+
 void search_arguments::print_timings() const
 {
     std::cerr << std::fixed << std::setprecision(2) << "============= Timings =============\n";
@@ -63,9 +109,51 @@ void search_arguments::print_timings() const
     std::cerr << "        ├── Query IBF\n";
     std::cerr << "        │   ├── Max [s]: " << query_ibf_timer.max_in_seconds() * threads << '\n';
     std::cerr << "        │   └── Avg [s]: " << query_ibf_timer.avg_in_seconds() * threads << '\n';
-    std::cerr << "        └── Generate results\n";
-    std::cerr << "            ├── Max [s]: " << generate_results_timer.max_in_seconds() * threads << '\n';
-    std::cerr << "            └── Avg [s]: " << generate_results_timer.avg_in_seconds() * threads << '\n';
+    std::cerr << "        ├── Generate results\n";
+    std::cerr << "        │   ├── Max [s]: " << generate_results_timer.max_in_seconds() * threads << '\n';
+    std::cerr << "        │   └── Avg [s]: " << generate_results_timer.avg_in_seconds() * threads << '\n';
+
+    double const search_time = parallel_search_timer.in_seconds();
+    std::cerr << (latency ? "        ├── " : "        └── ") << "Throughput\n";
+    std::string const throughput{latency ? "        │   " : "            "};
+    std::cerr << throughput << "├── Reads/s: " << detail::per_second(query_counter.value(), search_time) << '\n';
+    std::cerr << throughput << "└── Minimisers/s: " << detail::per_second(minimiser_counter.value(), search_time)
+              << '\n';
+
+    if (latency)
+    {
+        // For an HIBF, the query is timed per batch of reads.
+        bool const has_batches = query_hibf_batch_latency.count() != 0u;
+        std::string const per_read{has_batches ? "        │   " : "            "};
+        std::cerr << (has_batches ? "        ├── " : "        └── ") << "Per-read latency\n";
+        std::cerr << per_read << "├── Compute minimiser\n";
+        detail::print_latency(per_read + "│   ", compute_minimiser_latency);
+        std::cerr << per_read << "├── Threshold\n";
+        detail::print_latency(per_read + "│   ", threshold_latency);
+        if (query_ibf_latency.count() != 0u)
+        {
+            std::cerr << per_read << "├── Query IBF\n";
+            detail::print_latency(per_read + "│   ", query_ibf_latency);
+        }
+        std::cerr << per_read << "└── Generate results\n";
+        detail::print_latency(per_read + "    ", generate_results_latency);
+        if (has_batches)
+        {
+            std::cerr << "        └── Per-batch latency (" << hibf_batch_size << " reads)\n";
+            std::cerr << "            └── Query HIBF\n";
+            detail::print_latency("                ", query_hibf_batch_latency);
+        }
+    }
+
+    if (!hibf_level_statistics.empty())
+        detail::print_hibf_levels(hibf_level_statistics.value());
+
+    if (perf_counters)
+    {
+        detail::print_perf_counters({{"Compute minimiser", "compute_minimiser", compute_minimiser_perf},
+                                     {"Query IBF", "query_ibf", query_ibf_perf},
+                                     {"Generate results", "generate_results", generate_results_perf}});
+    }
 }
 
 void search_arguments::write_timings_to_file() const
@@ -74,6 +162,7 @@ void search_arguments::write_timings_to_file() const
     output_stream << std::fixed << std::setprecision(2);
     output_stream << "peak_memory_usage_in_kibibytes\t"
                   << "index_size_in_kibibytes\t"
+                  << "index_memory_size_in_kibibytes\t"
                   << "configured_threads\t"
                   << "wall_clock_time_in_seconds\t"
                   << "user_time_in_seconds\t"
@@ -90,7 +179,40 @@ void search_arguments::write_timings_to_file() const
                   << "query_ibf_max_in_seconds\t"
                   << "query_ibf_avg_in_seconds\t"
                   << "generate_results_max_in_seconds\t"
-                  << "generate_results_avg_in_seconds\n";
+                  << "generate_results_avg_in_seconds\t"
+                  << "reads_per_second\t"
+                  << "minimisers_per_second\t"
+                  << "compute_minimiser_p50_in_microseconds\t"
+                  << "compute_minimiser_p95_in_microseconds\t"
+                  << "compute_minimiser_p99_in_microseconds\t"
+                  << "compute_minimiser_max_in_microseconds\t"
+                  << "threshold_p50_in_microseconds\t"
+                  << "threshold_p95_in_microseconds\t"
+                  << "threshold_p99_in_microseconds\t"
+                  << "threshold_max_in_microseconds\t"
+                  << "query_ibf_p50_in_microseconds\t"
+                  << "query_ibf_p95_in_microseconds\t"
+                  << "query_ibf_p99_in_microseconds\t"
+                  << "query_ibf_max_in_microseconds\t"
+                  << "generate_results_p50_in_microseconds\t"
+                  << "generate_results_p95_in_microseconds\t"
+                  << "generate_results_p99_in_microseconds\t"
+                  << "generate_results_max_in_microseconds\t"
+                  << "query_hibf_batch_p50_in_microseconds\t"
+                  << "query_hibf_batch_p95_in_microseconds\t"
+                  << "query_hibf_batch_p99_in_microseconds\t"
+                  << "query_hibf_batch_max_in_microseconds";
+    detail::write_perf_counter_header(output_stream, "compute_minimiser");
+    detail::write_perf_counter_header(output_stream, "query_ibf");
+    detail::write_perf_counter_header(output_stream, "generate_results");
+    std::vector<hibf_level_counts> const hibf_levels = hibf_level_statistics.value();
+    for (size_t level = 0; level < hibf_levels.size(); ++level)
+    {
+        output_stream << "\thibf_level_" << level << "_queries"
+                      << "\thibf_level_" << level << "_loads"
+                      << "\thibf_level_" << level << "_hit_rate_in_percent";
+    }
+    output_stream << '\n';
 
     if (long const peak_ram_KiB = peak_ram_in_KiB(); peak_ram_KiB != -1L)
         output_stream << peak_ram_KiB << '\t';
@@ -98,6 +220,7 @@ void search_arguments::write_timings_to_file() const
         output_stream << "NA\t"; // GCOVR_EXCL_LINE
 
     output_stream << index_size_in_KiB(index_file, parts) << '\t';
+    output_stream << index_memory_size_in_KiB(index_file, parts) << '\t';
     output_stream << static_cast<size_t>(threads) << '\t';
     output_stream << wall_clock_timer.in_seconds() << '\t';
 
@@ -137,7 +260,26 @@ void search_arguments::write_timings_to_file() const
     output_stream << query_ibf_timer.max_in_seconds() * threads << '\t';
     output_stream << query_ibf_timer.avg_in_seconds() * threads << '\t';
     output_stream << generate_results_timer.max_in_seconds() * threads << '\t';
-    output_stream << generate_results_timer.avg_in_seconds() * threads << '\n';
+    output_stream << generate_results_timer.avg_in_seconds() * threads << '\t';
+
+    double const search_time = parallel_search_timer.in_seconds();
+    output_stream << detail::per_second(query_counter.value(), search_time) << '\t';
+    output_stream << detail::per_second(minimiser_counter.value(), search_time) << '\t';
+    detail::write_latency(output_stream, compute_minimiser_latency);
+    output_stream << '\t';
+    detail::write_latency(output_stream, threshold_latency);
+    output_stream << '\t';
+    detail::write_latency(output_stream, query_ibf_latency);
+    output_stream << '\t';
+    detail::write_latency(output_stream, generate_results_latency);
+    output_stream << '\t';
+    detail::write_latency(output_stream, query_hibf_batch_latency);
+    detail::write_perf_counter_values(output_stream, compute_minimiser_perf);
+    detail::write_perf_counter_values(output_stream, query_ibf_perf);
+    detail::write_perf_counter_values(output_stream, generate_results_perf);
+    for (hibf_level_counts const & level : hibf_levels)
+        output_stream << '\t' << level.queries << '\t' << level.loads << '\t' << level.hit_rate_in_percent();
+    output_stream << '\n';
 }
 
 } // namespace raptor
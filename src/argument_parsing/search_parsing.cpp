@@ -9,10 +9,12 @@
 
 #include <seqan3/io/views/async_input_buffer.hpp>
 
+#include <raptor/argument_parsing/parse_bin_selection.hpp>
 #include <raptor/argument_parsing/search_parsing.hpp>
 #include <raptor/argument_parsing/validators.hpp>
 #include <raptor/dna4_traits.hpp>
 #include <raptor/index.hpp>
+#include <raptor/sectioned_index.hpp>
 #include <raptor/search/search.hpp>
 
 namespace raptor
@@ -73,6 +75,9 @@ void fpga_checks(search_arguments const & arguments, size_t const max_query_leng
     if (arguments.is_hibf)
         throw sharg::parser_error{"The HIBF index is not supported."};
 
+    if (!arguments.selected_bins.empty())
+        throw sharg::parser_error{"Restricting the search with --bins is not supported."};
+
     if (max_query_length > 250u)
         throw sharg::parser_error{"The query length is too long. The maximum is 250."};
 
@@ -131,6 +136,23 @@ void init_search_parser(sharg::parser & parser, search_arguments & arguments)
                                     .long_id = "threads",
                                     .description = "The number of threads to use.",
                                     .validator = positive_integer_validator{}});
+    parser.add_option(arguments.bins,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "bins",
+                                    .description = "Only search these user bins. Either a comma-separated list or "
+                                                   "@<file> for a file with one entry per line. An entry is a user bin "
+                                                   "ID (3), a range of IDs (3-7), or a pattern for the file names of a "
+                                                   "user bin (*/ecoli/*.fa). * matches any characters and ? any "
+                                                   "character. A pattern without / only has to match the file name "
+                                                   "without its directory. For an HIBF, only the IBFs on the paths to "
+                                                   "the selected user bins are queried. For an IBF, the selection only "
+                                                   "filters the results and does not speed up the search.",
+                                    .default_message = "all user bins"});
+    parser.add_flag(arguments.compact_header,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "compact-header",
+                                  .description = "Only write the number of user bins to the header of the output "
+                                                 "file instead of the file names of each user bin."});
     parser.add_flag(arguments.quiet,
                     sharg::config{.short_id = '\0',
                                   .long_id = "quiet",
@@ -140,6 +162,44 @@ void init_search_parser(sharg::parser & parser, search_arguments & arguments)
                                     .long_id = "timing-output",
                                     .description = "Write time and memory usage to specified file (TSV format).",
                                     .validator = output_file_validator{}});
+    parser.add_option(arguments.trace_out,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "trace",
+                                    .description = "Write a timeline of the execution to the specified file (Chrome "
+                                                   "trace event format, e.g., for https://ui.perfetto.dev).",
+                                    .validator = output_file_validator{}});
+    parser.add_flag(arguments.perf_counters,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "perf-counters",
+                                  .description = "Record hardware performance counters (cycles, instructions, cache "
+                                                 "and TLB misses) per phase. Requires Linux and access to "
+                                                 "perf_event_open. Unavailable counters are reported as NA."});
+    parser.add_flag(arguments.latency,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "latency",
+                                  .description = "Record the latency of each phase per read and report percentiles. "
+                                                 "Takes additional timestamps for each read. Not recorded latencies "
+                                                 "are reported as NA."});
+    parser.add_option(arguments.hibf_batch_size,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "hibf-batch-size",
+                                    .description = "The number of reads that traverse an HIBF level by level together. "
+                                                   "Larger batches access each IBF less often.",
+                                    .validator = positive_integer_validator{}});
+    parser.add_option(arguments.hibf_cache_size,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "hibf-cache-size",
+                                    .description = "Load the lower levels of an HIBF on demand and cache this many "
+                                                   "MiB of them. IBFs that are being queried are not evicted, hence "
+                                                   "up to one IBF per thread may exceed the cache size. 0 loads the "
+                                                   "whole HIBF. Requires an index in the current format, see raptor "
+                                                   "upgrade."});
+    parser.add_option(arguments.hibf_resident_levels,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "hibf-resident-levels",
+                                    .description = "The number of HIBF levels that are always in memory. Only used "
+                                                   "with --hibf-cache-size.",
+                                    .validator = positive_integer_validator{}});
 #if RAPTOR_FPGA
     init_fpga_parser(parser, arguments);
 #endif
@@ -204,6 +264,9 @@ void search_parsing(sharg::parser & parser)
     init_search_parser(parser, arguments);
     parser.parse();
 
+    if (parser.is_option_set("trace"))
+        arguments.trace.enable();
+
     // ==========================================
     // Various checks.
     // ==========================================
@@ -244,6 +307,7 @@ void search_parsing(sharg::parser & parser)
 
     if (!parser.is_option_set("query_length"))
     {
+        auto span = arguments.trace.scoped("Determine query length", "io");
         arguments.query_length_timer.start();
         std::vector<uint64_t> sequence_lengths{};
         seqan3::sequence_file_input<dna4_traits, seqan3::fields<seqan3::field::seq>> query_in{arguments.query_file};
@@ -279,20 +343,39 @@ void search_parsing(sharg::parser & parser)
     // Read window and kmer size, and the bin paths.
     // ==========================================
     {
-        std::ifstream is{index_is_partitioned ? partitioned_index_file : arguments.index_file, std::ios::binary};
-        cereal::BinaryInputArchive iarchive{is};
+        std::filesystem::path const index_file = index_is_partitioned ? partitioned_index_file : arguments.index_file;
         raptor_index<> tmp{};
-        tmp.load_parameters(iarchive);
+        if (sectioned_index::is_sectioned(index_file))
+        {
+            sectioned_index::load_parameters(index_file, tmp);
+            arguments.bin_path = sectioned_index::load_bin_paths(index_file, arguments.threads);
+        }
+        else
+        {
+            std::ifstream is{index_file, std::ios::binary};
+            cereal::BinaryInputArchive iarchive{is};
+            tmp.load_parameters(iarchive);
+            arguments.bin_path = tmp.bin_path();
+        }
         arguments.shape = tmp.shape();
         arguments.shape_size = arguments.shape.size();
         arguments.shape_weight = arguments.shape.count();
         arguments.window_size = tmp.window_size();
         arguments.parts = tmp.parts();
-        arguments.bin_path = tmp.bin_path();
         arguments.fpr = tmp.fpr();
         arguments.is_hibf = tmp.is_hibf();
     }
 
+    if (parser.is_option_set("bins"))
+        parse_bin_selection(arguments);
+
+    if (arguments.hibf_cache_size != 0u
+        && (!arguments.is_hibf || index_is_partitioned || !sectioned_index::is_sectioned(arguments.index_file)))
+    {
+        throw sharg::parser_error{"--hibf-cache-size can only be used with an HIBF index in the current format. Use "
+                                  "raptor upgrade to convert older indexes."};
+    }
+
     if (min_query_length < arguments.window_size)
         throw sharg::parser_error{sharg::detail::to_string("The (minimal) query length (",
                                                            min_query_length,
@@ -332,6 +415,8 @@ void search_parsing(sharg::parser & parser)
         arguments.print_timings();
     if (parser.is_option_set("timing-output"))
         arguments.write_timings_to_file();
+    if (parser.is_option_set("trace"))
+        arguments.trace.write(arguments.trace_out);
 }
 
 } // namespace raptor
@@ -11,6 +11,8 @@
 #include <raptor/argument_parsing/update_parsing.hpp>
 #include <raptor/argument_parsing/validators.hpp>
 #include <raptor/index.hpp>
+#include <raptor/minimiser_container.hpp>
+#include <raptor/sectioned_index.hpp>
 #include <raptor/update/update.hpp>
 
 namespace raptor
@@ -38,6 +40,12 @@ void init_update_parser(sharg::parser & parser, update_arguments & arguments)
                                     .long_id = "threads",
                                     .description = "The number of threads to use.",
                                     .validator = positive_integer_validator{}});
+    parser.add_option(arguments.trace_out,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "trace",
+                                    .description = "Write a timeline of the execution to the specified file (Chrome "
+                                                   "trace event format, e.g., for https://ui.perfetto.dev).",
+                                    .validator = output_file_validator{}});
 }
 
 void init_delete_parser(sharg::parser & parser, update_arguments & arguments)
@@ -87,6 +95,7 @@ bool is_sequence_file(std::filesystem::path const & file_path)
 
 void update_parsing(sharg::parser & parser)
 {
+    minimiser_container::cache const container_cache{};
     parser.info.short_description = "Updates a Raptor index";
     parser.info.description.emplace_back("Updates a Raptor index.");
     parser.add_subcommands({"delete", "insert"});
@@ -102,6 +111,9 @@ void update_parsing(sharg::parser & parser)
 
     sub_parser.parse();
 
+    if (sub_parser.is_option_set("trace"))
+        arguments.trace.enable();
+
     if (sub_parser.info.app_name == std::string_view{"Raptor-update-insert"})
     {
         if (std::filesystem::is_empty(arguments.bin_file))
@@ -121,10 +133,17 @@ void update_parsing(sharg::parser & parser)
     // Read window and kmer size, and the bin paths.
     // ==========================================
     {
-        std::ifstream is{arguments.index_file, std::ios::binary};
-        cereal::BinaryInputArchive iarchive{is};
         raptor_index<> tmp{};
-        tmp.load_parameters(iarchive);
+        if (sectioned_index::is_sectioned(arguments.index_file))
+        {
+            sectioned_index::load_parameters(arguments.index_file, tmp);
+        }
+        else
+        {
+            std::ifstream is{arguments.index_file, std::ios::binary};
+            cereal::BinaryInputArchive iarchive{is};
+            tmp.load_parameters(iarchive);
+        }
         arguments.shape = tmp.shape();
         arguments.shape_size = arguments.shape.size();
         arguments.shape_weight = arguments.shape.count();
@@ -136,6 +155,9 @@ void update_parsing(sharg::parser & parser)
     }
 
     raptor_update(arguments);
+
+    if (sub_parser.is_option_set("trace"))
+        arguments.trace.write(arguments.trace_out);
 }
 
 } // namespace raptor
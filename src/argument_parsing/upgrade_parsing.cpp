@@ -10,14 +10,79 @@
 #include <raptor/argument_parsing/parse_bin_path.hpp>
 #include <raptor/argument_parsing/upgrade_parsing.hpp>
 #include <raptor/argument_parsing/validators.hpp>
+#include <raptor/block_compression.hpp>
 #include <raptor/build/partition_config.hpp>
 #include <raptor/index.hpp>
+#include <raptor/sectioned_index.hpp>
 #include <raptor/upgrade/upgrade.hpp>
 
 namespace raptor
 {
 
-void init_upgrade_parser(sharg::parser & /* parser */, upgrade_arguments & /* arguments */) // GCOVR_EXCL_LINE
+// Reads the number of parts and the index type for raptor upgrade --sectioned.
+inline void parse_sectioned(sharg::parser & parser, upgrade_arguments & arguments)
+{
+    if (!parser.is_option_set("input") || !parser.is_option_set("output"))
+        throw sharg::parser_error{"--sectioned requires --input and --output."};
+
+    if (arguments.compress && !detail::has_block_compression)
+        throw sharg::parser_error{"--compress is not available. Raptor was built without zlib."};
+
+    std::filesystem::path const partitioned_index_file = arguments.index_file.string() + "_0";
+    bool const index_is_monolithic = std::filesystem::exists(arguments.index_file);
+    bool const index_is_partitioned = std::filesystem::exists(partitioned_index_file);
+    sharg::input_file_validator const index_validator{};
+
+    if (index_is_monolithic && index_is_partitioned)
+    {
+        throw sharg::validation_error{sharg::detail::to_string("Ambiguous index. Both monolithic (",
+                                                               arguments.index_file.c_str(),
+                                                               ") and partitioned index (",
+                                                               partitioned_index_file.c_str(),
+                                                               ") exist. Please rename the monolithic index.")};
+    }
+    else if (index_is_partitioned)
+    {
+        index_validator(partitioned_index_file);
+    }
+    else
+    {
+        index_validator(arguments.index_file);
+    }
+
+    {
+        std::filesystem::path const index_file = index_is_partitioned ? partitioned_index_file : arguments.index_file;
+        raptor_index<> tmp{};
+        if (sectioned_index::is_sectioned(index_file))
+        {
+            sectioned_index::load_parameters(index_file, tmp);
+        }
+        else
+        {
+            std::ifstream is{index_file, std::ios::binary};
+            uint32_t version{};
+            is.read(reinterpret_cast<char *>(&version), sizeof(version));
+            if (version != raptor_index<>::version)
+                throw sharg::parser_error{"Cannot convert index version " + std::to_string(version)
+                                          + ". Only indexes of Raptor 4.0 and newer can be converted."};
+
+            is.seekg(0);
+            cereal::BinaryInputArchive iarchive{is};
+            tmp.load_parameters(iarchive);
+        }
+        arguments.parts = tmp.parts();
+        arguments.is_hibf = tmp.is_hibf();
+    }
+
+    if (index_is_partitioned)
+    {
+        std::string const index_path_base = arguments.index_file.string() + '_';
+        for (size_t part{1u}; part < arguments.parts; ++part)
+            index_validator(index_path_base + std::to_string(part));
+    }
+}
+
+void init_upgrade_parser(sharg::parser & parser, upgrade_arguments & arguments)
 {
     // parser.info.short_description = "Upgrades a Raptor index created with Raptor 3.0 to be compatible with Raptor 4.0";
     // parser.info.description.emplace_back("Upgrades a Raptor index created with Raptor 3.0 to be"
@@ -50,21 +115,61 @@ void init_upgrade_parser(sharg::parser & /* parser */, upgrade_arguments & /* ar
     //                   .default_message = "None",
     //                   .required = false,
     //                   .validator = sharg::input_file_validator{}});
-    // parser.add_option(arguments.index_file,
-    //                   sharg::config{.short_id = '\0',
-    //                                 .long_id = "input",
-    //                                 .description = "The index to upgrade. Parts: Without suffix _0",
-    //                                 .required = true});
-    // parser.add_option(
-    //     arguments.output_file,
-    //     sharg::config{.short_id = '\0', .long_id = "output", .description = "Path to new index.", .required = true});
+
+    parser.info.short_description = "Upgrades a Raptor index";
+    parser.info.description.emplace_back("Upgrading an index created with Raptor 3.0 is not yet implemented for "
+                                         "Raptor 4.0.");
+    parser.info.description.emplace_back("With \\fB--sectioned\\fP, an index created with Raptor 4.0 or newer is "
+                                         "converted to the sectioned index format (version 4). The index itself does "
+                                         "not change. The sectioned format has a section table with checksums. The "
+                                         "parameters can be read without reading the bin paths, and the index can be "
+                                         "loaded and verified with multiple threads. An index that already has the "
+                                         "sectioned format is stored again, e.g., to compress it.");
+    parser.info.examples.emplace_back("raptor upgrade --sectioned --input old.index --output new.index");
+    parser.info.examples.emplace_back("raptor upgrade --sectioned --input old.index --output new.index --threads 4 "
+                                      "--compress");
+    parser.info.synopsis.emplace_back("raptor upgrade --sectioned --input <file> --output <file> "
+                                      "[--threads <number>] [--compress]");
+
+    parser.add_flag(arguments.sectioned,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "sectioned",
+                                  .description = "Converts an index of Raptor 4.0 or newer to the sectioned index "
+                                                 "format."});
+    parser.add_option(arguments.index_file,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "input",
+                                    .description = "The index to upgrade. Parts: Without suffix _0"});
+    parser.add_option(arguments.output_file,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "output",
+                                    .description = "Path to new index. Parts: Without suffix _0",
+                                    .validator = output_file_validator{sharg::output_file_open_options::create_new}});
+    parser.add_option(arguments.threads,
+                      sharg::config{.short_id = '\0',
+                                    .long_id = "threads",
+                                    .description = "The number of threads to use. Only for --sectioned.",
+                                    .validator = positive_integer_validator{}});
+    parser.add_flag(arguments.compress,
+                    sharg::config{.short_id = '\0',
+                                  .long_id = "compress",
+                                  .description = "Compresses the index in blocks with zlib. See "
+                                                 "\\fBraptor build\\fP. Only for --sectioned."});
 }
 
-void upgrade_parsing(sharg::parser & /* parser */)
+void upgrade_parsing(sharg::parser & parser)
 {
-    // upgrade_arguments arguments{};
-    // init_upgrade_parser(parser, arguments);
-    // parser.parse();
+    upgrade_arguments arguments{};
+    init_upgrade_parser(parser, arguments);
+    parser.parse();
+
+    if (arguments.sectioned)
+    {
+        parse_sectioned(parser, arguments);
+        raptor_upgrade(arguments);
+        return;
+    }
+
     throw sharg::parser_error{"Upgrade not yet implemented for Raptor 4.0."};
 
     // if (parser.is_option_set("fpr") && parser.is_option_set("bins"))
@@ -7,11 +7,14 @@
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
+#include <memory>
+
 #include <hibf/hierarchical_interleaved_bloom_filter.hpp>
 
 #include <raptor/build/build_hibf.hpp>
 #include <raptor/build/store_index.hpp>
 #include <raptor/file_reader.hpp>
+#include <raptor/minimiser_store.hpp>
 
 namespace raptor
 {
@@ -24,8 +27,28 @@ void build_hibf(build_arguments const & arguments)
     else
         reader = file_reader<file_types::sequence>{arguments.shape, arguments.window_size};
 
-    auto input_lambda = [&arguments, &reader](size_t const user_bin_id, seqan::hibf::insert_iterator it)
+    // Minimiser files do not need to be stored again.
+    bool const use_store = arguments.minimiser_store && !arguments.input_is_minimiser;
+    std::unique_ptr<minimiser_store> store{};
+    if (use_store)
+        store = std::make_unique<minimiser_store>(minimiser_store::directory_of(arguments.out_path),
+                                                  arguments.shape,
+                                                  arguments.window_size);
+
+    auto input_lambda = [&](size_t const user_bin_id, seqan::hibf::insert_iterator it)
     {
+        auto span = arguments.trace.scoped("Read user bin", "build");
+        span.add_arg("user_bin", user_bin_id);
+
+        if (use_store)
+        {
+            store->hash_into(user_bin_id,
+                             arguments.bin_path[user_bin_id],
+                             std::get<file_reader<file_types::sequence>>(reader),
+                             it);
+            return;
+        }
+
         std::visit(
             [&](auto const & reader)
             {
@@ -49,7 +72,14 @@ void build_hibf(build_arguments const & arguments)
     config.threads = arguments.threads;
 
     // Call ctor
+    auto construct_span = arguments.trace.scoped("Construct HIBF", "build");
     seqan::hibf::hierarchical_interleaved_bloom_filter hibf{config, layout};
+    // The HIBF only exposes accumulated timers; they are attached to the span.
+    construct_span.add_arg("index_allocation_in_seconds", hibf.index_allocation_timer.in_seconds());
+    construct_span.add_arg("user_bin_io_in_seconds", hibf.user_bin_io_timer.in_seconds());
+    construct_span.add_arg("merge_kmers_in_seconds", hibf.merge_kmers_timer.in_seconds());
+    construct_span.add_arg("fill_ibf_in_seconds", hibf.fill_ibf_timer.in_seconds());
+    construct_span.stop();
 
     arguments.index_allocation_timer = std::move(hibf.index_allocation_timer);
     arguments.user_bin_io_timer = std::move(hibf.user_bin_io_timer);
@@ -65,9 +95,14 @@ void build_hibf(build_arguments const & arguments)
                                               std::move(hibf)};
     arguments.index_allocation_timer.stop();
 
+    auto span = arguments.trace.scoped("Store index", "io");
     arguments.store_index_timer.start();
-    store_index(arguments.out_path, std::move(index));
+    store_index(arguments.out_path, std::move(index), arguments.threads, arguments.compress);
     arguments.store_index_timer.stop();
+
+    // Removes the minimisers of user bins whose files changed, e.g., because another layout was built before.
+    if (store)
+        store->compact();
 }
 
 } // namespace raptor
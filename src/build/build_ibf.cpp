@@ -7,50 +7,182 @@
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
 #include <hibf/build/bin_size_in_bits.hpp>
 
+#include <raptor/build/async_part_store.hpp>
 #include <raptor/build/index_factory.hpp>
 #include <raptor/build/max_count_per_partition.hpp>
 #include <raptor/build/partition_config.hpp>
+#include <raptor/build/partition_spill.hpp>
+#include <raptor/build/sliced_index_writer.hpp>
 #include <raptor/build/store_index.hpp>
 
 namespace raptor
 {
 
+namespace detail
+{
+
+inline std::filesystem::path part_path(std::filesystem::path const & out_path, size_t const part)
+{
+    std::filesystem::path result{out_path};
+#if HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wrestrict"
+#endif // HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
+    result += "_" + std::to_string(part);
+#if HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
+#    pragma GCC diagnostic pop
+#endif // HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
+    return result;
+}
+
+/*!\brief Builds the index in slices of rows and writes each slice to the index file.
+ * \details
+ * Each slice is at most `--index-memory` big. For each slice, all user bins are read and only the bits within the
+ * slice are set. Hence, the input is read once per slice.
+ * \returns `false` if the index fits into `--index-memory`.
+ */
+bool build_ibf_in_slices(build_arguments const & arguments)
+{
+    size_t const bin_size = arguments.bits / arguments.parts;
+    size_t const row_words = seqan::hibf::divide_and_ceil(arguments.bins, 64u);
+    size_t const index_bytes = bin_size * row_words * sizeof(uint64_t);
+
+    if (index_bytes <= arguments.index_memory)
+        return false;
+
+    detail::ibf_positions const positions{seqan::hibf::bin_count{arguments.bins},
+                                          seqan::hibf::bin_size{bin_size},
+                                          seqan::hibf::hash_function_count{arguments.hash}};
+
+    std::variant<file_reader<file_types::sequence>, file_reader<file_types::minimiser>> reader{};
+    if (arguments.input_is_minimiser)
+        reader = file_reader<file_types::minimiser>{};
+    else
+        reader = file_reader<file_types::sequence>{arguments.shape, arguments.window_size};
+
+    size_t const slice_rows = std::max<size_t>(1u, arguments.index_memory / (row_words * sizeof(uint64_t)));
+    size_t const slices = seqan::hibf::divide_and_ceil(bin_size, slice_rows);
+    std::vector<uint64_t> slice(slice_rows * row_words);
+
+    std::ofstream stream{arguments.out_path, std::ios::binary};
+    sliced_index_writer writer{stream, arguments};
+
+    for (size_t i = 0; i < slices; ++i)
+    {
+        size_t const begin = i * slice_rows * row_words;
+        size_t const end = std::min(begin + slice.size(), writer.words());
+        std::ranges::fill(slice, 0u);
+
+        auto span = arguments.trace.scoped("Fill slice", "build");
+        span.add_arg("slice", i);
+
+        auto worker = [&](auto && zipped_view)
+        {
+            seqan::hibf::serial_timer local_timer{};
+            local_timer.start();
+            for (auto && zipped : zipped_view)
+            {
+                std::visit(
+                    [&](auto const & reader)
+                    {
+                        auto && [file_names, bin_number] = zipped;
+                        size_t const column = bin_number / 64u;
+                        uint64_t const mask = 1ULL << (bin_number % 64u);
+
+                        reader.for_each_block(
+                            file_names,
+                            [&](std::span<uint64_t const> const block)
+                            {
+                                for (uint64_t const value : block)
+                                    for (size_t h = 0; h < positions.hash_function_count(); ++h)
+                                        if (size_t const word = positions.word(value, h); word >= begin && word < end)
+                                            std::atomic_ref<uint64_t>{slice[word - begin + column]}.fetch_or(
+                                                mask,
+                                                std::memory_order_relaxed);
+                            });
+                    },
+                    reader);
+            }
+            local_timer.stop();
+            arguments.user_bin_io_timer += local_timer;
+            arguments.fill_ibf_timer += local_timer;
+        };
+
+        call_parallel_on_bins(worker, arguments.bin_path, arguments.threads);
+
+        arguments.store_index_timer.start();
+        writer.write(std::span<uint64_t const>{slice.data(), end - begin});
+        arguments.store_index_timer.stop();
+    }
+
+    writer.finish();
+    if (!stream.good())
+        throw std::runtime_error{"Could not write index " + arguments.out_path.string()};
+    return true;
+}
+
+} // namespace detail
+
 void build_ibf(build_arguments const & arguments)
 {
     if (arguments.parts == 1u)
     {
+        if (arguments.index_memory != 0u && detail::build_ibf_in_slices(arguments))
+            return;
+
         index_factory factory{arguments};
         auto index = factory();
+        auto span = arguments.trace.scoped("Store index", "io");
         arguments.store_index_timer.start();
-        store_index(arguments.out_path, std::move(index));
+        store_index(arguments.out_path, std::move(index), arguments.threads, arguments.compress);
         arguments.store_index_timer.stop();
     }
+    else if (arguments.single_pass)
+    {
+        partition_config const cfg{arguments.parts};
+        async_part_store store{arguments};
+        partition_spill const spill = [&]()
+        {
+            auto span = arguments.trace.scoped("Spill partitions", "build");
+            return partition_spill{cfg, arguments};
+        }();
+
+        for (size_t part = 0; part < arguments.parts; ++part)
+        {
+            arguments.bits = seqan::hibf::build::bin_size_in_bits(
+                {.fpr = arguments.fpr, .hash_count = arguments.hash, .elements = spill.max_count(part)});
+            index_factory factory{arguments, spill.bin_path(part)};
+            store.push(detail::part_path(arguments.out_path, part), factory(part), part);
+            spill.remove(part);
+        }
+        store.wait();
+    }
     else
     {
         partition_config const cfg{arguments.parts};
         index_factory factory{arguments, cfg};
-        std::vector<size_t> const kmers_per_partition = max_count_per_partition(cfg, arguments);
+        async_part_store store{arguments};
+        std::vector<size_t> const kmers_per_partition = [&]()
+        {
+            auto span = arguments.trace.scoped("Count k-mers per partition", "build");
+            return max_count_per_partition(cfg, arguments);
+        }();
 
         for (size_t part = 0; part < arguments.parts; ++part)
         {
             arguments.bits = seqan::hibf::build::bin_size_in_bits(
                 {.fpr = arguments.fpr, .hash_count = arguments.hash, .elements = kmers_per_partition[part]});
-            auto index = factory(part);
-            std::filesystem::path out_path{arguments.out_path};
-#if HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
-#    pragma GCC diagnostic push
-#    pragma GCC diagnostic ignored "-Wrestrict"
-#endif // HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
-            out_path += "_" + std::to_string(part);
-#if HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
-#    pragma GCC diagnostic pop
-#endif // HIBF_WORKAROUND_GCC_BOGUS_MEMCPY
-            arguments.store_index_timer.start();
-            store_index(out_path, std::move(index));
-            arguments.store_index_timer.stop();
+            store.push(detail::part_path(arguments.out_path, part), factory(part), part);
         }
+        store.wait();
     }
 }
 
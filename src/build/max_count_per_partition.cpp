@@ -8,14 +8,21 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
+#include <limits>
+#include <optional>
+#include <utility>
 
-#include <hibf/contrib/robin_hood.hpp>
 #include <hibf/sketch/hyperloglog.hpp>
 
 #include <raptor/build/max_count_per_partition.hpp>
 #include <raptor/call_parallel_on_bins.hpp>
+#include <raptor/exact_distinct_count.hpp>
 #include <raptor/file_reader.hpp>
+#include <raptor/minimiser_file.hpp>
+#include <raptor/minimiser_header.hpp>
 
 namespace raptor
 {
@@ -28,7 +35,8 @@ std::vector<size_t> max_count_per_partition(partition_config const & cfg,
                                             std::vector<std::vector<std::string>> const & bin_path,
                                             uint8_t const threads,
                                             seqan3::shape const & shape,
-                                            uint32_t const window_size)
+                                            uint32_t const window_size,
+                                            size_t const memory_limit)
 {
     std::vector<size_t> kmers_per_partition(cfg.partitions);
     std::vector<size_t> bin_per_partition(cfg.partitions);
@@ -79,41 +87,188 @@ std::vector<size_t> max_count_per_partition(partition_config const & cfg,
     call_parallel_on_bins(worker, bin_path, threads);
 
     // Get exact count for biggest bin. Sketch estimate's accuracy depends on sketch_bits (here: 15).
-    robin_hood::unordered_flat_set<uint64_t> kmers{};
-#pragma omp parallel for schedule(dynamic) num_threads(threads) private(kmers)
     for (size_t i = 0; i < cfg.partitions; ++i)
     {
-        kmers.clear();
-        auto insert_it = std::inserter(kmers, kmers.end());
-        reader.hash_into_if(bin_path[bin_per_partition[i]],
-                            insert_it,
-                            [&](uint64_t const hash)
-                            {
-                                return cfg.hash_partition(hash) == i;
-                            });
-        kmers_per_partition[i] = kmers.size();
+        kmers_per_partition[i] = exact_distinct_count(reader,
+                                                      bin_path[bin_per_partition[i]],
+                                                      kmers_per_partition[i],
+                                                      threads,
+                                                      memory_limit,
+                                                      [&](uint64_t const hash)
+                                                      {
+                                                          return cfg.hash_partition(hash) == i;
+                                                      });
     }
 
     return kmers_per_partition;
 }
 
+/*!\brief Bounds of the number of minimisers per partition of a user bin, using the minimiser counts per suffix that
+ *        `raptor prepare` writes to the `.header` files or shard indices.
+ * \details
+ * The counts of multiple files cannot be added: The files may share minimisers. The lower bound is the largest count
+ * of a single file, the upper bound is the sum of the counts. Without suffix counts, the upper bound is unbounded.
+ */
+struct partition_count_bounds
+{
+    std::vector<size_t> lower{};
+    std::vector<size_t> upper{};
+    bool exact{};
+
+    partition_count_bounds(partition_config const & cfg, std::vector<std::string> const & file_names) :
+        lower(cfg.partitions),
+        upper(cfg.partitions)
+    {
+        bool bounded{true};
+        std::vector<size_t> kmer_counts(cfg.partitions);
+
+        for (auto const & file_name : file_names)
+        {
+            std::optional<minimiser_header> const header = find_minimiser_header(file_name);
+            if (!header || !header->suffix_counts)
+            {
+                bounded = false;
+                continue;
+            }
+
+            std::ranges::fill(kmer_counts, 0u);
+            for (size_t suffix = 0; suffix < minimiser_header::suffixes; ++suffix)
+                kmer_counts[cfg.hash_partition(suffix)] += (*header->suffix_counts)[suffix];
+
+            for (size_t i = 0; i < cfg.partitions; ++i)
+            {
+                lower[i] = std::max(lower[i], kmer_counts[i]);
+                upper[i] += kmer_counts[i];
+            }
+        }
+
+        exact = bounded && file_names.size() == 1u;
+        if (!bounded)
+            std::ranges::fill(upper, std::numeric_limits<size_t>::max());
+    }
+};
+
+/*!\brief The largest lower bound per partition of all user bins.
+ * \returns The lower bounds, and whether they are the exact maximum counts, i.e., every user bin is a single file with
+ *          suffix counts.
+ */
+std::pair<std::vector<size_t>, bool>
+max_lower_count_from_headers(partition_config const & cfg,
+                             std::vector<std::vector<std::string>> const & bin_path,
+                             uint8_t const threads)
+{
+    std::vector<size_t> kmers_per_partition(cfg.partitions);
+    std::atomic<bool> exact{true};
+    std::mutex callback_mutex{};
+
+    auto worker = [&](auto && zipped_view)
+    {
+        std::vector<size_t> max_kmer_counts(cfg.partitions);
+
+        for (auto && [file_names, bin_number] : zipped_view)
+        {
+            partition_count_bounds const bounds{cfg, file_names};
+            if (!bounds.exact)
+                exact = false;
+
+            for (size_t i = 0; i < cfg.partitions; ++i)
+                max_kmer_counts[i] = std::max(max_kmer_counts[i], bounds.lower[i]);
+        }
+
+        std::lock_guard<std::mutex> guard{callback_mutex};
+        for (size_t i = 0; i < cfg.partitions; ++i)
+            kmers_per_partition[i] = std::max(kmers_per_partition[i], max_kmer_counts[i]);
+    };
+
+    call_parallel_on_bins(worker, bin_path, threads);
+
+    return {std::move(kmers_per_partition), exact.load()};
+}
+
+/*!\brief The user bins that may have the most minimisers in a partition.
+ * \details
+ * A user bin whose upper bound is below `max_lower` in every partition cannot have the most minimisers in any
+ * partition and does not need to be read.
+ */
+std::vector<std::vector<std::string>>
+candidate_bins_from_headers(partition_config const & cfg,
+                            std::vector<std::vector<std::string>> const & bin_path,
+                            std::vector<size_t> const & max_lower,
+                            uint8_t const threads)
+{
+    std::vector<size_t> candidates{};
+    std::mutex callback_mutex{};
+
+    auto worker = [&](auto && zipped_view)
+    {
+        std::vector<size_t> local_candidates{};
+
+        for (auto && [file_names, bin_number] : zipped_view)
+        {
+            partition_count_bounds const bounds{cfg, file_names};
+            for (size_t i = 0; i < cfg.partitions; ++i)
+            {
+                if (bounds.upper[i] >= max_lower[i])
+                {
+                    local_candidates.push_back(bin_number);
+                    break;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> guard{callback_mutex};
+        candidates.insert(candidates.end(), local_candidates.begin(), local_candidates.end());
+    };
+
+    call_parallel_on_bins(worker, bin_path, threads);
+
+    std::ranges::sort(candidates);
+    std::vector<std::vector<std::string>> result{};
+    result.reserve(candidates.size());
+    for (size_t const bin_number : candidates)
+        result.push_back(bin_path[bin_number]);
+
+    return result;
+}
+
 } // namespace detail
 
 std::vector<size_t> max_count_per_partition(partition_config const & cfg, build_arguments const & arguments)
 {
     arguments.bin_size_timer.start();
+
+    // Only the user bins that may have the most minimisers in a partition are read.
+    if (arguments.input_is_minimiser && cfg.mask < minimiser_header::suffixes)
+    {
+        auto const [max_lower, exact] =
+            detail::max_lower_count_from_headers(cfg, arguments.bin_path, arguments.threads);
+        std::vector<size_t> result =
+            exact ? max_lower
+                  : detail::max_count_per_partition<file_types::minimiser>(
+                        cfg,
+                        detail::candidate_bins_from_headers(cfg, arguments.bin_path, max_lower, arguments.threads),
+                        arguments.threads,
+                        arguments.shape,
+                        arguments.window_size,
+                        arguments.count_memory);
+        arguments.bin_size_timer.stop();
+        return result;
+    }
+
     // GCOVR_EXCL_START
     std::vector<size_t> result = arguments.input_is_minimiser
                                    ? detail::max_count_per_partition<file_types::minimiser>(cfg,
                                                                                             arguments.bin_path,
                                                                                             arguments.threads,
                                                                                             arguments.shape,
-                                                                                            arguments.window_size)
+                                                                                            arguments.window_size,
+                                                                                            arguments.count_memory)
                                    : detail::max_count_per_partition<file_types::sequence>(cfg,
                                                                                            arguments.bin_path,
                                                                                            arguments.threads,
                                                                                            arguments.shape,
-                                                                                           arguments.window_size);
+                                                                                           arguments.window_size,
+                                                                                           arguments.count_memory);
     // GCOVR_EXCL_STOP
     arguments.bin_size_timer.stop();
 
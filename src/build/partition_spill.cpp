@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Implements raptor::partition_spill.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <omp.h>
+
+#include <hibf/contrib/robin_hood.hpp>
+
+#include <raptor/build/partition_spill.hpp>
+#include <raptor/call_parallel_on_bins.hpp>
+#include <raptor/file_reader.hpp>
+#include <raptor/minimiser_container.hpp>
+
+namespace raptor
+{
+
+namespace detail
+{
+
+template <file_types file_type>
+void spill_partitions(partition_config const & cfg,
+                      build_arguments const & arguments,
+                      std::filesystem::path const & directory,
+                      std::vector<size_t> & max_counts)
+{
+    std::mutex max_counts_mutex{};
+    file_reader<file_type> const reader{arguments.shape, arguments.window_size};
+    std::string const shape_string = arguments.shape.to_string();
+
+    // One shard per thread and partition. Shards are only created by threads that process a user bin.
+    std::vector<std::unique_ptr<minimiser_shard_writer>> shard_writers(arguments.threads * cfg.partitions);
+
+    auto worker = [&](auto && zipped_view)
+    {
+        std::vector<size_t> local_max_counts(cfg.partitions);
+
+        for (auto && [file_names, bin_number] : zipped_view)
+        {
+            auto span = arguments.trace.scoped("Spill user bin", "build");
+            span.add_arg("user_bin", bin_number);
+
+            // Like in compute_minimiser, the sets are constructed for each user bin to not keep the memory of the
+            // biggest user bin for the whole run.
+            std::vector<robin_hood::unordered_flat_set<uint64_t>> minimisers(cfg.partitions);
+            reader.for_each_hash(file_names,
+                                 [&](uint64_t const hash)
+                                 {
+                                     minimisers[cfg.hash_partition(hash)].insert(hash);
+                                 });
+
+            size_t const thread_id = omp_get_thread_num();
+            for (size_t part = 0; part < cfg.partitions; ++part)
+            {
+                std::unique_ptr<minimiser_shard_writer> & shard = shard_writers[thread_id * cfg.partitions + part];
+                if (!shard)
+                    shard = std::make_unique<minimiser_shard_writer>(directory / std::to_string(part), thread_id);
+
+                std::array<uint64_t, minimiser_header::suffixes> suffix_counts{};
+                std::ostream & output = shard->begin();
+                for (uint64_t const hash : minimisers[part])
+                {
+                    ++suffix_counts[minimiser_header::suffix(hash)];
+                    output.write(reinterpret_cast<char const *>(&hash), sizeof(hash));
+                }
+                shard->commit(std::to_string(bin_number),
+                              {.shape_string = shape_string,
+                               .window_size = arguments.window_size,
+                               .count = minimisers[part].size(),
+                               .suffix_counts = suffix_counts});
+
+                local_max_counts[part] = std::max(local_max_counts[part], minimisers[part].size());
+            }
+        }
+
+        std::lock_guard<std::mutex> guard{max_counts_mutex};
+        for (size_t part = 0; part < cfg.partitions; ++part)
+            max_counts[part] = std::max(max_counts[part], local_max_counts[part]);
+    };
+
+    call_parallel_on_bins(worker, arguments.bin_path, arguments.threads);
+}
+
+} // namespace detail
+
+partition_spill::partition_spill(partition_config const & cfg, build_arguments const & arguments) :
+    directory{arguments.out_path.string() + ".spill"},
+    max_counts(cfg.partitions),
+    bin_paths(cfg.partitions)
+{
+    // Leftovers of an aborted run.
+    std::filesystem::remove_all(directory.path);
+
+    size_t const number_of_bins = arguments.bin_path.size();
+    for (size_t part = 0; part < cfg.partitions; ++part)
+    {
+        std::filesystem::path const part_directory = directory.path / std::to_string(part);
+        std::filesystem::create_directories(part_directory);
+
+        bin_paths[part].reserve(number_of_bins);
+        for (size_t bin = 0; bin < number_of_bins; ++bin)
+            bin_paths[part].push_back({(part_directory / (std::to_string(bin) + ".minimiser")).string()});
+    }
+
+    arguments.bin_size_timer.start();
+    // GCOVR_EXCL_START
+    if (arguments.input_is_minimiser)
+        detail::spill_partitions<file_types::minimiser>(cfg, arguments, directory.path, max_counts);
+    else
+        detail::spill_partitions<file_types::sequence>(cfg, arguments, directory.path, max_counts);
+    // GCOVR_EXCL_STOP
+    arguments.bin_size_timer.stop();
+}
+
+void partition_spill::remove(size_t const part) const
+{
+    std::filesystem::remove_all(directory.path / std::to_string(part));
+}
+
+} // namespace raptor
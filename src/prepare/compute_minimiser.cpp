@@ -7,12 +7,15 @@
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
+#include <array>
+#include <bit>
+#include <memory>
+#include <mutex>
 #include <omp.h>
 
 #include <seqan3/io/sequence_file/input.hpp>
 #include <seqan3/search/views/minimiser_hash.hpp>
 
-#include <hibf/contrib/robin_hood.hpp>
 #include <hibf/contrib/std/chunk_view.hpp>
 #include <hibf/contrib/std/zip_view.hpp>
 #include <hibf/misc/divide_and_ceil.hpp>
@@ -20,8 +23,13 @@
 #include <raptor/adjust_seed.hpp>
 #include <raptor/dna4_traits.hpp>
 #include <raptor/file_reader.hpp>
+#include <raptor/minimiser_container.hpp>
+#include <raptor/minimiser_file.hpp>
+#include <raptor/minimiser_header.hpp>
 #include <raptor/prepare/compute_minimiser.hpp>
 #include <raptor/prepare/cutoff.hpp>
+#include <raptor/prepare/minimiser_counter.hpp>
+#include <raptor/record_ranges.hpp>
 
 namespace raptor
 {
@@ -49,87 +57,233 @@ void write_list_file(prepare_arguments const & arguments)
     }
 }
 
+/*!\brief Hashes the ranges of a large user bin with all threads.
+ * \details
+ * Each thread buffers the hashes per counter and inserts a full buffer while holding the counter's lock. The counters
+ * are partitioned by the most significant bits of the hash.
+ */
+void count_in_parallel(prepare_arguments const & arguments,
+                       file_reader<file_types::sequence> const & reader,
+                       std::vector<record_range> const & ranges,
+                       std::vector<std::unique_ptr<minimiser_counter>> & counters,
+                       int const partition_shift)
+{
+    static constexpr size_t batch_size{1ULL << 14};
+    std::vector<std::mutex> mutexes(counters.size());
+
+#pragma omp parallel num_threads(arguments.threads)
+    {
+        seqan::hibf::serial_timer local_compute_minimiser_timer{};
+        std::vector<std::vector<uint64_t>> buffers(counters.size());
+
+        auto submit = [&](size_t const partition)
+        {
+            std::lock_guard<std::mutex> guard{mutexes[partition]};
+            for (uint64_t const hash : buffers[partition])
+                counters[partition]->insert(hash);
+            buffers[partition].clear();
+        };
+
+        local_compute_minimiser_timer.start();
+#pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            reader.for_each_hash(ranges[i],
+                                 [&](uint64_t const hash)
+                                 {
+                                     size_t const partition = hash >> partition_shift;
+                                     buffers[partition].push_back(hash);
+                                     if (buffers[partition].size() == batch_size)
+                                         submit(partition);
+                                 });
+        }
+
+        for (size_t partition = 0; partition < counters.size(); ++partition)
+            if (!buffers[partition].empty())
+                submit(partition);
+        local_compute_minimiser_timer.stop();
+        arguments.compute_minimiser_timer += local_compute_minimiser_timer;
+    }
+}
+
 void compute_minimiser(prepare_arguments const & arguments)
 {
     file_reader<file_types::sequence> const reader{arguments.shape, arguments.window_size};
     raptor::cutoff const cutoffs{arguments};
+    std::vector<bool> const large_bins = large_user_bins(arguments.bin_path, arguments.threads, record_chunk_size);
+    int const hash_bits = 2 * arguments.shape.count();
 
-    auto worker = [&](auto && zipped_view)
+    // With --container, each thread appends to its own shard. Shards are only created by threads that process a bin.
+    minimiser_container const completed =
+        arguments.container ? minimiser_container::recover(arguments.out_dir) : minimiser_container{};
+    std::vector<std::unique_ptr<minimiser_shard_writer>> shard_writers(arguments.threads);
+
+    // Large user bins are processed one after another, and each one uses all threads.
+    auto process_bin = [&](std::vector<std::string> const & file_names, size_t const bin_number, bool const large)
     {
         seqan::hibf::serial_timer local_compute_minimiser_timer{};
         seqan::hibf::serial_timer local_write_minimiser_timer{};
         seqan::hibf::serial_timer local_write_header_timer{};
 
-        for (auto && [file_names, bin_number] : zipped_view)
-        {
-            std::filesystem::path const file_name{file_names[0]};
-            std::filesystem::path output_path = get_output_path(arguments.out_dir, file_name);
+        std::filesystem::path const file_name{file_names[0]};
+        std::filesystem::path output_path = get_output_path(arguments.out_dir, file_name);
 
-            std::filesystem::path const minimiser_file =
-                std::filesystem::path{output_path}.replace_extension("minimiser");
-            std::filesystem::path const progress_file =
-                std::filesystem::path{output_path}.replace_extension("in_progress");
-            std::filesystem::path const header_file = std::filesystem::path{output_path}.replace_extension("header");
+        std::filesystem::path const minimiser_file = std::filesystem::path{output_path}.replace_extension("minimiser");
+        std::filesystem::path const progress_file =
+            std::filesystem::path{output_path}.replace_extension("in_progress");
+        std::filesystem::path const header_file = std::filesystem::path{output_path}.replace_extension("header");
+        std::string const name = output_path.stem().string();
 
-            // If we are already done with this file, we can skip it. Otherwise, we create a ".in_progress" file to keep
-            // track of whether the minimiser computation was successful.
+        // If we are already done with this file, we can skip it. Otherwise, we create a ".in_progress" file to keep
+        // track of whether the minimiser computation was successful.
+        // In a container, a file is done as soon as it is in the index of a shard.
+        if (arguments.container)
+        {
+            if (completed.contains(name))
+                return;
+        }
+        else
+        {
             bool const already_done = std::filesystem::exists(minimiser_file) && std::filesystem::exists(header_file)
                                    && !std::filesystem::exists(progress_file);
 
             if (already_done)
-                continue;
+                return;
             else
                 std::ofstream outfile{progress_file, std::ios::binary};
+        }
+
+        minimiser_shard_writer * shard{nullptr};
+        if (arguments.container)
+        {
+            size_t const thread_id = omp_get_thread_num();
+            if (!shard_writers[thread_id])
+                shard_writers[thread_id] = std::make_unique<minimiser_shard_writer>(arguments.out_dir, thread_id);
+            shard = shard_writers[thread_id].get();
+        }
+
+        auto span = arguments.trace.scoped(file_name.filename().string(), "prepare");
+        span.add_arg("user_bin", bin_number);
 
-            // The hash table stores how often a minimiser appears. It does not matter whether a minimiser appears
-            // 50 times or 2000 times, it is stored regardless because the biggest cutoff value is 50. Hence,
-            // the hash table stores only values up to 254 to save memory.
-            robin_hood::unordered_map<uint64_t, uint8_t> minimiser_table{};
-            // The map is (re-)constructed for each file. The alternative is to construct it once for each thread
-            // and clear+reuse it for every file that a thread works on. However, this dramatically increases
-            // memory consumption because the map will stay as big as needed for the biggest encountered file.
+        uint8_t const cutoff = cutoffs.get(file_name);
+        uint64_t count{};
 
+        // The counters are (re-)constructed for each file. The alternative is to construct them once for each thread
+        // and clear+reuse them for every file that a thread works on. However, this dramatically increases
+        // memory consumption because the map will stay as big as needed for the biggest encountered file.
+        int const partition_bits =
+            large ? std::min(static_cast<int>(std::bit_width(arguments.threads * 4u)) - 1, hash_bits) : 0;
+        size_t const number_of_counters = 1ULL << partition_bits;
+        size_t const memory = large ? arguments.memory / number_of_counters : arguments.memory / arguments.threads;
+        std::filesystem::path const bucket_prefix = std::filesystem::path{output_path}.replace_extension("bucket");
+
+        std::vector<std::unique_ptr<minimiser_counter>> counters(number_of_counters);
+        for (size_t i = 0; i < number_of_counters; ++i)
+        {
+            std::filesystem::path prefix{bucket_prefix};
+            if (large)
+                prefix += "_p" + std::to_string(i);
+            counters[i] = std::make_unique<minimiser_counter>(cutoff, memory, prefix, hash_bits - partition_bits);
+        }
+
+        if (large)
+        {
+            std::vector<record_range> const ranges = record_ranges(file_names, record_chunk_size);
+            span.add_arg("ranges", ranges.size());
+            count_in_parallel(arguments, reader, ranges, counters, hash_bits - partition_bits);
+        }
+        else
+        {
             local_compute_minimiser_timer.start();
             reader.for_each_hash(file_names,
-                                 [&](auto && hash)
+                                 [&](uint64_t const hash)
                                  {
-                                     minimiser_table[hash] = std::min<uint8_t>(254u, minimiser_table[hash] + 1);
+                                     counters[0]->insert(hash);
                                  });
             local_compute_minimiser_timer.stop();
+        }
+
+        std::array<uint64_t, minimiser_header::suffixes> suffix_counts{};
 
-            uint8_t const cutoff = cutoffs.get(file_name);
-            uint64_t count{};
+        // Counters are partitioned by the most significant bits. Hence, emitting them in order keeps the hashes sorted.
+        auto emit = [&](auto && callback)
+        {
+            for (auto & counter : counters)
+                counter->emit(arguments.compress,
+                              [&](uint64_t const hash)
+                              {
+                                  ++suffix_counts[minimiser_header::suffix(hash)];
+                                  callback(hash);
+                              });
+        };
 
-            local_write_minimiser_timer.start();
+        local_write_minimiser_timer.start();
+        {
+            std::ofstream minimiser_stream{};
+            if (!shard)
+                minimiser_stream.open(minimiser_file, std::ios::binary);
+            std::ostream & output = shard ? shard->begin() : minimiser_stream;
+
+            if (arguments.compress)
             {
-                std::ofstream outfile{minimiser_file, std::ios::binary};
-                for (auto && [hash, occurrences] : minimiser_table)
-                {
-                    if (occurrences >= cutoff)
+                compressed_minimiser_writer writer{output, arguments.shape, arguments.window_size};
+                emit(
+                    [&](uint64_t const hash)
                     {
-                        outfile.write(reinterpret_cast<char const *>(&hash), sizeof(hash));
+                        writer.push(hash);
                         ++count;
-                    }
-                }
+                    });
             }
-            local_write_minimiser_timer.stop();
-
-            local_write_header_timer.start();
+            else
             {
-                std::ofstream headerfile{header_file};
-                headerfile << arguments.shape.to_string() << '\t' << arguments.window_size << '\t'
-                           << static_cast<uint16_t>(cutoff) << '\t' << count << '\n';
+                emit(
+                    [&](uint64_t const hash)
+                    {
+                        output.write(reinterpret_cast<char const *>(&hash), sizeof(hash));
+                        ++count;
+                    });
             }
-            local_write_header_timer.stop();
+        }
+        local_write_minimiser_timer.stop();
 
-            std::filesystem::remove(progress_file);
+        size_t distinct{};
+        bool spilled{};
+        for (auto const & counter : counters)
+        {
+            distinct += counter->distinct();
+            spilled |= counter->spilled();
         }
+        span.add_arg("spilled", static_cast<int>(spilled));
+        span.add_arg("distinct_minimiser", distinct);
+
+        local_write_header_timer.start();
+        minimiser_header const header{.shape_string = arguments.shape.to_string(),
+                                      .window_size = arguments.window_size,
+                                      .cutoff = cutoff,
+                                      .count = count,
+                                      .suffix_counts = suffix_counts};
+        if (shard)
+            shard->commit(name, header);
+        else
+            header.write(header_file);
+        local_write_header_timer.stop();
+        span.add_arg("written_minimiser", count);
+
+        if (!shard)
+            std::filesystem::remove(progress_file);
 
         arguments.compute_minimiser_timer += local_compute_minimiser_timer;
         arguments.write_minimiser_timer += local_write_minimiser_timer;
         arguments.write_header_timer += local_write_header_timer;
     };
 
+    auto worker = [&](auto && zipped_view)
+    {
+        for (auto && [file_names, bin_number] : zipped_view)
+            if (!large_bins[bin_number])
+                process_bin(file_names, bin_number, false);
+    };
+
     size_t const number_of_bins = arguments.bin_path.size();
     size_t const chunk_size = seqan::hibf::divide_and_ceil(number_of_bins, arguments.threads);
     auto chunked_view = seqan::stl::views::zip(arguments.bin_path, std::views::iota(0u, number_of_bins))
@@ -142,6 +296,10 @@ void compute_minimiser(prepare_arguments const & arguments)
         std::invoke(worker, chunked_view[i]);
     }
 
+    for (size_t bin_number = 0; bin_number < number_of_bins; ++bin_number)
+        if (large_bins[bin_number])
+            process_bin(arguments.bin_path[bin_number], bin_number, true);
+
     write_list_file(arguments);
 }
 
@@ -97,7 +97,7 @@ int main(int argc, char ** argv)
         if (sub_parser.info.app_name == std::string_view{"Raptor-update"})
             raptor::update_parsing(sub_parser);
         if (sub_parser.info.app_name == std::string_view{"Raptor-upgrade"})
-            raptor::upgrade_parsing(sub_parser); // GCOVR_EXCL_LINE
+            raptor::upgrade_parsing(sub_parser);
     }
     catch (std::exception const & ext)
     {
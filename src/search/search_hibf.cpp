@@ -7,6 +7,7 @@
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
+#include <raptor/search/lazy_hibf.hpp>
 #include <raptor/search/search_hibf.hpp>
 #include <raptor/search/search_singular_ibf.hpp>
 
@@ -15,6 +16,13 @@ namespace raptor
 
 void search_hibf(search_arguments const & arguments)
 {
+    if (arguments.hibf_cache_size != 0u)
+    {
+        lazy_hibf index{};
+        search_singular_ibf(arguments, index);
+        return;
+    }
+
     auto index = raptor_index<index_structure::hibf>{};
     search_singular_ibf(arguments, std::move(index));
 }
@@ -7,6 +7,7 @@
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
+#include <chrono>
 #include <future>
 #include <random>
 
@@ -54,11 +55,15 @@ void search_partitioned_ibf(search_arguments const & arguments)
                                         });
 
         records.clear();
-        arguments.query_file_io_timer.start();
-        std::ranges::move(chunked_records, std::back_inserter(records));
-        // Very fast, improves parallel processing when chunks of the query belong to the same bin.
-        std::ranges::shuffle(records, std::mt19937_64{0u});
-        arguments.query_file_io_timer.stop();
+        {
+            auto span = arguments.trace.scoped("Query file I/O", "io");
+            arguments.query_file_io_timer.start();
+            std::ranges::move(chunked_records, std::back_inserter(records));
+            // Very fast, improves parallel processing when chunks of the query belong to the same bin.
+            std::ranges::shuffle(records, std::mt19937_64{0u});
+            arguments.query_file_io_timer.stop();
+            span.add_arg("reads", records.size());
+        }
 
         cereal_future.get();
         [[maybe_unused]] static bool header_written = write_header(); // called exactly once
@@ -67,12 +72,28 @@ void search_partitioned_ibf(search_arguments const & arguments)
             records.size(),
             seqan::hibf::counting_vector<uint16_t>(index.ibf().bin_count(), 0));
 
+        using clock = std::chrono::steady_clock;
+        // A read is processed once per part; its latency is the sum over all parts.
+        size_t const latency_records = arguments.latency ? records.size() : 0u;
+        std::vector<clock::duration> compute_minimiser_durations(latency_records, clock::duration::zero());
+        std::vector<clock::duration> query_ibf_durations(latency_records, clock::duration::zero());
+
+        // The timestamps for the latency histograms are only taken if requested.
+        auto timestamp = [&arguments]()
+        {
+            return arguments.latency ? clock::now() : clock::time_point{};
+        };
+
         size_t part{};
 
         auto count_task = [&](size_t const start, size_t const extent)
         {
+            auto span = arguments.trace.scoped("Count", "search");
             seqan::hibf::serial_timer local_compute_minimiser_timer{};
             seqan::hibf::serial_timer local_query_ibf_timer{};
+            perf_counter_group const perf_group{arguments.perf_counters};
+            serial_perf_counter local_compute_minimiser_perf{perf_group};
+            serial_perf_counter local_query_ibf_perf{perf_group};
 
             auto & ibf = index.ibf();
             auto counter = ibf.template counting_agent<uint16_t>();
@@ -86,9 +107,13 @@ void search_partitioned_ibf(search_arguments const & arguments)
             for (auto && [id, seq] : std::span{records.data() + start, extent})
             {
                 auto minimiser_view = seq | hash_view | std::views::common;
+                clock::time_point const hash_start = timestamp();
                 local_compute_minimiser_timer.start();
+                local_compute_minimiser_perf.start();
                 minimiser.assign(minimiser_view.begin(), minimiser_view.end());
+                local_compute_minimiser_perf.stop();
                 local_compute_minimiser_timer.stop();
+                clock::time_point const query_start = timestamp();
 
                 // GCOVR_EXCL_START
                 auto filtered = minimiser
@@ -100,12 +125,28 @@ void search_partitioned_ibf(search_arguments const & arguments)
                 // GCOVR_EXCL_STOP
 
                 local_query_ibf_timer.start();
-                counts[counter_id++] += counter.bulk_count(filtered);
+                local_query_ibf_perf.start();
+                counts[counter_id] += counter.bulk_count(filtered);
+                local_query_ibf_perf.stop();
                 local_query_ibf_timer.stop();
+
+                if (arguments.latency)
+                {
+                    compute_minimiser_durations[counter_id] += query_start - hash_start;
+                    query_ibf_durations[counter_id] += clock::now() - query_start;
+                }
+                ++counter_id;
             }
 
             arguments.compute_minimiser_timer += local_compute_minimiser_timer;
+            arguments.compute_minimiser_perf += local_compute_minimiser_perf;
             arguments.query_ibf_timer += local_query_ibf_timer;
+            arguments.query_ibf_perf += local_query_ibf_perf;
+
+            span.add_arg("part", part);
+            span.add_arg("reads", extent);
+            span.add_arg("compute_minimiser_in_seconds", local_compute_minimiser_timer.in_seconds());
+            span.add_arg("query_ibf_in_seconds", local_query_ibf_timer.in_seconds());
         };
 
         arguments.parallel_search_timer.start();
@@ -126,9 +167,19 @@ void search_partitioned_ibf(search_arguments const & arguments)
 
         auto output_task = [&](size_t const start, size_t const extent)
         {
+            auto span = arguments.trace.scoped("Search", "search");
             seqan::hibf::serial_timer local_compute_minimiser_timer{};
             seqan::hibf::serial_timer local_query_ibf_timer{};
             seqan::hibf::serial_timer local_generate_results_timer{};
+            perf_counter_group const perf_group{arguments.perf_counters};
+            serial_perf_counter local_compute_minimiser_perf{perf_group};
+            serial_perf_counter local_query_ibf_perf{perf_group};
+            serial_perf_counter local_generate_results_perf{perf_group};
+            latency_histogram local_compute_minimiser_latency{};
+            latency_histogram local_threshold_latency{};
+            latency_histogram local_query_ibf_latency{};
+            latency_histogram local_generate_results_latency{};
+            uint64_t local_minimiser_count{};
 
             auto & ibf = index.ibf();
             auto counter = ibf.template counting_agent<uint16_t>();
@@ -148,9 +199,13 @@ void search_partitioned_ibf(search_arguments const & arguments)
                 result_string += '\t';
 
                 auto minimiser_view = seq | hash_adaptor | std::views::common;
+                clock::time_point const hash_start = timestamp();
                 local_compute_minimiser_timer.start();
+                local_compute_minimiser_perf.start();
                 minimiser.assign(minimiser_view.begin(), minimiser_view.end());
+                local_compute_minimiser_perf.stop();
                 local_compute_minimiser_timer.stop();
+                clock::time_point const query_start = timestamp();
 
                 // GCOVR_EXCL_START
                 auto filtered = minimiser
@@ -161,17 +216,23 @@ void search_partitioned_ibf(search_arguments const & arguments)
                                     });
                 // GCOVR_EXCL_STOP
                 local_query_ibf_timer.start();
+                local_query_ibf_perf.start();
                 counts[counter_id] += counter.bulk_count(filtered);
+                local_query_ibf_perf.stop();
                 local_query_ibf_timer.stop();
+                clock::time_point const threshold_start = timestamp();
 
                 size_t const minimiser_count{minimiser.size()};
                 size_t current_bin{0};
+                local_minimiser_count += minimiser_count;
 
                 size_t const threshold = thresholder.get(minimiser_count);
+                clock::time_point const results_start = timestamp();
                 local_generate_results_timer.start();
+                local_generate_results_perf.start();
                 for (auto && count : counts[counter_id++])
                 {
-                    if (count >= threshold)
+                    if (count >= threshold && arguments.is_selected(current_bin))
                     {
                         auto conv = std::to_chars(buffer.data(), buffer.data() + buffer.size(), current_bin);
                         assert(conv.ec == std::errc{});
@@ -187,12 +248,38 @@ void search_partitioned_ibf(search_arguments const & arguments)
                     result_string += '\n';
 
                 synced_out.write(result_string);
+                local_generate_results_perf.stop();
                 local_generate_results_timer.stop();
+
+                if (arguments.latency)
+                {
+                    size_t const read_id = counter_id - 1u;
+                    local_compute_minimiser_latency.record(compute_minimiser_durations[read_id]
+                                                           + (query_start - hash_start));
+                    local_query_ibf_latency.record(query_ibf_durations[read_id] + (threshold_start - query_start));
+                    local_threshold_latency.record(results_start - threshold_start);
+                    local_generate_results_latency.record(clock::now() - results_start);
+                }
             }
 
             arguments.compute_minimiser_timer += local_compute_minimiser_timer;
+            arguments.compute_minimiser_perf += local_compute_minimiser_perf;
             arguments.query_ibf_timer += local_query_ibf_timer;
+            arguments.query_ibf_perf += local_query_ibf_perf;
             arguments.generate_results_timer += local_generate_results_timer;
+            arguments.generate_results_perf += local_generate_results_perf;
+            arguments.compute_minimiser_latency += local_compute_minimiser_latency;
+            arguments.threshold_latency += local_threshold_latency;
+            arguments.query_ibf_latency += local_query_ibf_latency;
+            arguments.generate_results_latency += local_generate_results_latency;
+            arguments.query_counter += extent;
+            arguments.minimiser_counter += local_minimiser_count;
+
+            span.add_arg("part", part);
+            span.add_arg("reads", extent);
+            span.add_arg("compute_minimiser_in_seconds", local_compute_minimiser_timer.in_seconds());
+            span.add_arg("query_ibf_in_seconds", local_query_ibf_timer.in_seconds());
+            span.add_arg("generate_results_in_seconds", local_generate_results_timer.in_seconds());
         };
 
         arguments.parallel_search_timer.start();
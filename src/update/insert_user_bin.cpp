@@ -7,11 +7,15 @@
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
+#include <filesystem>
+#include <memory>
+
 #include <hibf/contrib/robin_hood.hpp>
 
 #include <raptor/argument_parsing/update_arguments.hpp>
 #include <raptor/file_reader.hpp>
 #include <raptor/index.hpp>
+#include <raptor/minimiser_store.hpp>
 #include <raptor/update/dump_index.hpp> // DEBUG
 
 #include "insert/is_fpr_exceeded.hpp"
@@ -28,15 +32,43 @@ rebuild_location insert_tb_and_parents(robin_hood::unordered_flat_set<uint64_t>
                                        insert_location insert_location,
                                        raptor_index<index_structure::hibf> & index);
 
-robin_hood::unordered_flat_set<uint64_t> compute_kmers(std::filesystem::path const & ub_file,
-                                                       raptor_index<index_structure::hibf> const & index)
+robin_hood::unordered_flat_set<uint64_t> compute_kmers(std::string const & ub_file,
+                                                       raptor_index<index_structure::hibf> const & index,
+                                                       minimiser_store * const store)
 {
     robin_hood::unordered_flat_set<uint64_t> kmers{};
     raptor::file_reader<raptor::file_types::sequence> reader{index.shape(), static_cast<uint32_t>(index.window_size())};
-    reader.hash_into(ub_file, std::inserter(kmers, kmers.begin()));
+    // The new user bin gets the next user bin ID.
+    if (store != nullptr)
+        store->hash_into(index.bin_path().size(), {ub_file}, reader, std::inserter(kmers, kmers.begin()));
+    else
+        reader.hash_into(ub_file, std::inserter(kmers, kmers.begin()));
     return kmers;
 }
 
+/*!\brief Opens the minimiser store of the index, if there is one.
+ * \details
+ * If the updated index is written to a different file, the store is copied and the copy is used.
+ */
+std::unique_ptr<minimiser_store> open_minimiser_store(update_arguments const & arguments,
+                                                      raptor_index<index_structure::hibf> const & index)
+{
+    std::filesystem::path const input_directory = minimiser_store::directory_of(arguments.index_file);
+    if (!std::filesystem::is_directory(input_directory))
+        return nullptr;
+
+    std::filesystem::path const output_directory = minimiser_store::directory_of(arguments.out_path);
+    if (std::filesystem::weakly_canonical(input_directory) != std::filesystem::weakly_canonical(output_directory))
+    {
+        std::filesystem::remove_all(output_directory);
+        std::filesystem::copy(input_directory, output_directory, std::filesystem::copy_options::recursive);
+    }
+
+    return std::make_unique<minimiser_store>(output_directory,
+                                             index.shape(),
+                                             static_cast<uint32_t>(index.window_size()));
+}
+
 // ceil(BITS / (-HASH / log(1 - exp(log(FPR) / HASH))))
 size_t max_elements(max_elements_parameters const & params)
 {
@@ -111,7 +143,8 @@ void get_overwrite_ibf(std::vector<size_t> & result, raptor_index<index_structur
 
 void partial_rebuild(update_arguments const & arguments,
                      detail::rebuild_location const & rebuild_location,
-                     raptor_index<index_structure::hibf> & index)
+                     raptor_index<index_structure::hibf> & index,
+                     minimiser_store * const store)
 {
     std::cout << "Partial Rebuild\n";
     assert(index.ibf().ibf_bin_to_user_bin_id[rebuild_location.ibf_idx][rebuild_location.bin_idx]
@@ -136,7 +169,10 @@ void partial_rebuild(update_arguments const & arguments,
     {
         raptor::file_reader<raptor::file_types::sequence> reader{index.shape(),
                                                                  static_cast<uint32_t>(index.window_size())};
-        reader.hash_into(index.bin_path()[ub_ids[user_bin_id]], it);
+        if (store != nullptr)
+            store->hash_into(ub_ids[user_bin_id], index.bin_path()[ub_ids[user_bin_id]], reader, it);
+        else
+            reader.hash_into(index.bin_path()[ub_ids[user_bin_id]], it);
     };
 
     seqan::hibf::config config{index.config()};
@@ -241,7 +277,9 @@ void partial_rebuild(update_arguments const & arguments,
 
 static constexpr bool consider_lower_level_tmax{false};
 
-void full_rebuild(update_arguments const & arguments, raptor_index<index_structure::hibf> & index)
+void full_rebuild(update_arguments const & arguments,
+                  raptor_index<index_structure::hibf> & index,
+                  minimiser_store * const store)
 {
     std::cout << "Full Rebuild\n";
     auto bin_path = index.bin_path();
@@ -251,7 +289,10 @@ void full_rebuild(update_arguments const & arguments, raptor_index<index_structu
     auto input_fn = [&](size_t const user_bin_id, seqan::hibf::insert_iterator it)
     {
         raptor::file_reader<raptor::file_types::sequence> reader{shape, window_size};
-        reader.hash_into(bin_path[user_bin_id], it);
+        if (store != nullptr)
+            store->hash_into(user_bin_id, bin_path[user_bin_id], reader, it);
+        else
+            reader.hash_into(bin_path[user_bin_id], it);
     };
 
     seqan::hibf::config config{index.config()};
@@ -292,7 +333,7 @@ tmax_check check_tmax_rebuild(update_arguments const & arguments,
         else if constexpr (consider_lower_level_tmax)
         {
             auto const parent = index.ibf().prev_ibf_id[ibf_idx];
-            partial_rebuild(arguments, detail::rebuild_location{parent.ibf_idx, parent.bin_idx}, index);
+            partial_rebuild(arguments, detail::rebuild_location{parent.ibf_idx, parent.bin_idx}, index, nullptr);
             return tmax_check::partial_rebuild;
         }
 
@@ -305,9 +346,10 @@ tmax_check check_tmax_rebuild(update_arguments const & arguments,
 void insert_user_bin(update_arguments const & arguments, raptor_index<index_structure::hibf> & index)
 {
     auto full_rebuild_bin_path = index.bin_path();
-    full_rebuild_bin_path.insert(full_rebuild_bin_path.end(),
-                                 arguments.user_bins_to_insert.begin(),
-                                 arguments.user_bins_to_insert.end());
+    for (auto const & user_bin : arguments.user_bins_to_insert)
+        full_rebuild_bin_path.push_back(user_bin);
+
+    std::unique_ptr<minimiser_store> const store = detail::open_minimiser_store(arguments, index);
 
     for (auto const & ub : arguments.user_bins_to_insert)
     {
@@ -316,7 +358,7 @@ void insert_user_bin(update_arguments const & arguments, raptor_index<index_stru
 
         for (auto const & path : ub)
         {
-            auto const kmers = detail::compute_kmers(path, index);
+            auto const kmers = detail::compute_kmers(path, index, store.get());
             size_t const kmer_count = kmers.size();
 
             std::vector<detail::ibf_max> const max_kmers = detail::max_ibf_sizes(index);
@@ -333,13 +375,13 @@ void insert_user_bin(update_arguments const & arguments, raptor_index<index_stru
                     if (rebuild_location.ibf_idx == 0u && is_fpr_exceeded(index, rebuild_location))
                     {
                         index.replace_bin_path(std::move(full_rebuild_bin_path));
-                        full_rebuild(arguments, index);
+                        full_rebuild(arguments, index, store.get());
                         return;
                     }
                     else
                     {
                         // some downstream fpr too high
-                        partial_rebuild(arguments, rebuild_location, index);
+                        partial_rebuild(arguments, rebuild_location, index, store.get());
                     }
                 }
             }
@@ -349,7 +391,7 @@ void insert_user_bin(update_arguments const & arguments, raptor_index<index_stru
                 if (check_tmax_rebuild(arguments, index, insert_location.ibf_idx) == tmax_check::full_rebuild)
                 {
                     index.replace_bin_path(std::move(full_rebuild_bin_path));
-                    full_rebuild(arguments, index);
+                    full_rebuild(arguments, index, store.get());
                     return;
                 }
             }
@@ -7,10 +7,10 @@
  * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
  */
 
-#include <fstream>
-
 #include <raptor/build/store_index.hpp>
 #include <raptor/index.hpp>
+#include <raptor/index_sections.hpp>
+#include <raptor/search/load_index.hpp>
 #include <raptor/update/delete_user_bins.hpp>
 #include <raptor/update/dump_index.hpp>
 #include <raptor/update/insert_user_bin.hpp>
@@ -21,24 +21,29 @@ namespace raptor
 
 void raptor_update(update_arguments const & arguments)
 {
-    std::ifstream index_file{arguments.index_file};
-    cereal::BinaryInputArchive archive{index_file};
     raptor::raptor_index<index_structure::hibf> index;
-    archive(index);
+    bool const compress = index_section_table::is_compressed(arguments.index_file);
+    {
+        auto span = arguments.trace.scoped("Load index", "io");
+        detail::load_index(index, arguments.index_file, arguments.threads);
+    }
 
     // dump_index(index);
     if (!arguments.user_bins_to_delete.empty())
     {
+        auto span = arguments.trace.scoped("Delete user bins", "update");
         delete_user_bins(arguments, index);
         // dump_index(index);
     }
     if (!arguments.user_bins_to_insert.empty())
     {
+        auto span = arguments.trace.scoped("Insert user bins", "update");
         insert_user_bin(arguments, index);
         // dump_index(index);
     }
 
-    store_index(arguments.out_path, std::move(index));
+    auto span = arguments.trace.scoped("Store index", "io");
+    store_index(arguments.out_path, std::move(index), arguments.threads, compress);
 }
 
 } // namespace raptor
@@ -16,8 +16,26 @@
 namespace raptor
 {
 
-void raptor_upgrade(upgrade_arguments & /* arguments */) // GCOVR_EXCL_LINE
+void raptor_upgrade(upgrade_arguments & arguments)
 {
+    if (arguments.sectioned)
+    {
+        sectioned_index_upgrader const upgrader{arguments};
+
+        if (arguments.parts == 1u)
+        {
+            upgrader.upgrade(arguments.index_file, arguments.output_file);
+            return;
+        }
+
+        for (size_t part{0}; part < arguments.parts; ++part)
+        {
+            std::string const suffix = '_' + std::to_string(part);
+            upgrader.upgrade(arguments.index_file.string() + suffix, arguments.output_file.string() + suffix);
+        }
+        return;
+    }
+
     // if (arguments.parts == 1u)
     // {
     //     size_t const max_count = std::isnan(arguments.fpr) ? max_bin_count(arguments) : 0u;
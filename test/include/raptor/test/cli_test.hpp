@@ -16,6 +16,7 @@
 #include <hibf/contrib/std/zip_view.hpp>
 
 #include <raptor/index.hpp>
+#include <raptor/search/load_index.hpp>
 
 #ifndef RAPTOR_ASSERT_ZERO_EXIT
 #    define RAPTOR_ASSERT_ZERO_EXIT(arg)                                                                               \
@@ -271,16 +272,8 @@ struct raptor_base : public cli_test
 
         raptor::raptor_index<data_t> expected_index{}, actual_index{};
 
-        {
-            std::ifstream is{expected_result, std::ios::binary};
-            cereal::BinaryInputArchive iarchive{is};
-            iarchive(expected_index);
-        }
-        {
-            std::ifstream is{actual_result, std::ios::binary};
-            cereal::BinaryInputArchive iarchive{is};
-            iarchive(actual_index);
-        }
+        raptor::detail::load_index(expected_index, expected_result);
+        raptor::detail::load_index(actual_index, actual_result);
 
         EXPECT_EQ(expected_index.window_size(), actual_index.window_size());
         EXPECT_EQ(expected_index.shape(), actual_index.shape());
@@ -322,7 +315,8 @@ struct raptor_base : public cli_test
             }
         }
 
-        auto const &all_expected_bins{expected_index.bin_path()}, all_actual_bins{actual_index.bin_path()};
+        auto const all_expected_bins{expected_index.bin_path().to_vector()};
+        auto const all_actual_bins{actual_index.bin_path().to_vector()};
         EXPECT_EQ(std::ranges::distance(all_expected_bins), std::ranges::distance(all_actual_bins));
 
         if constexpr (is_ibf)
@@ -439,4 +433,51 @@ struct raptor_base : public cli_test
         EXPECT_FALSE(std::getline(search_result, line));
         EXPECT_TRUE(query_ids.all());
     }
+
+    /*!\brief Checks the result of a search with `--error 0` that is restricted with `--bins`.
+     * \details
+     * Each query is expected to be found in all user bins for which `is_selected(user_bin_id, file_names)` holds,
+     * except for the ones with bin4.fa.
+     */
+    template <typename predicate_t>
+    static inline void compare_selected_search(std::string_view const filename, predicate_t && is_selected)
+    {
+        std::ifstream search_result{filename.data()};
+        std::string line;
+        std::vector<uint64_t> expected_hits;
+        std::vector<uint64_t> actual_hits;
+        uint64_t tmp{};
+
+        // Skip parameter information
+        while (std::getline(search_result, line) && line.starts_with("##"))
+        {}
+
+        while (line != "#QUERY_NAME\tUSER_BINS")
+        {
+            std::string_view line_view{line};
+            size_t const tab = line_view.find('\t');
+            std::from_chars(line_view.data() + 1u, line_view.data() + tab, tmp);
+            if (!line_view.ends_with("bin4.fa") && is_selected(tmp, line_view.substr(tab + 1u)))
+                expected_hits.push_back(tmp);
+            ASSERT_TRUE(std::getline(search_result, line));
+        }
+
+        size_t number_of_queries{};
+        while (std::getline(search_result, line))
+        {
+            std::string_view line_view{line};
+            actual_hits.clear();
+
+            for (auto && hit : std::views::split(line_view.substr(line_view.find('\t') + 1u), ','))
+            {
+                std::from_chars(hit.data(), hit.data() + hit.size(), tmp);
+                actual_hits.push_back(tmp);
+            }
+            std::ranges::sort(actual_hits);
+            ASSERT_EQ(expected_hits, actual_hits);
+            ++number_of_queries;
+        }
+
+        EXPECT_EQ(number_of_queries, 3u);
+    }
 };
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*!\file
+ * \brief Provides raptor::test::synthetic_data.
+ * \author Enrico Seiler <enrico.seiler AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <seqan3/alphabet/nucleotide/dna4.hpp>
+#include <seqan3/alphabet/views/to_char.hpp>
+#include <seqan3/test/performance/sequence_generator.hpp>
+#include <seqan3/test/tmp_directory.hpp>
+
+namespace raptor::test
+{
+
+/*!\brief Generates a random genome and writes user bins and reads as FASTA files.
+ * \details
+ * The genome is split into `bin_count` equally sized user bins. Reads are sampled from the genome without errors.
+ * Files are only written once per parameter set and removed when the object is destroyed.
+ */
+class synthetic_data
+{
+public:
+    synthetic_data() = delete;
+    synthetic_data(synthetic_data const &) = delete;
+    synthetic_data & operator=(synthetic_data const &) = delete;
+    synthetic_data(synthetic_data &&) = delete;
+    synthetic_data & operator=(synthetic_data &&) = delete;
+    ~synthetic_data() = default;
+
+    explicit synthetic_data(size_t const genome_size, size_t const seed = 0u) :
+        genome{seqan3::test::generate_sequence<seqan3::dna4>(genome_size, 0, seed)}
+    {}
+
+    std::filesystem::path directory() const
+    {
+        return tmp_directory.path();
+    }
+
+    //!\brief Returns the paths of the user bins; one file per user bin.
+    std::vector<std::vector<std::string>> bin_path(size_t const bin_count) const
+    {
+        std::filesystem::path const bin_directory = directory() / ("bins_" + std::to_string(bin_count));
+        size_t const bin_size = (genome.size() + bin_count - 1u) / bin_count;
+        bool const exists = std::filesystem::exists(bin_directory);
+        std::filesystem::create_directories(bin_directory);
+
+        std::vector<std::vector<std::string>> result{};
+        result.reserve(bin_count);
+
+        for (size_t bin = 0; bin < bin_count; ++bin)
+        {
+            std::filesystem::path const file = bin_directory / ("bin_" + std::to_string(bin) + ".fa");
+            result.push_back({file.string()});
+
+            if (exists)
+                continue;
+
+            size_t const start = std::min(genome.size(), bin * bin_size);
+            size_t const end = std::min(genome.size(), start + bin_size);
+            write_fasta(file, "bin_" + std::to_string(bin), std::span{genome.data() + start, end - start});
+        }
+
+        return result;
+    }
+
+    //!\brief Returns the path of a FASTA file containing `read_count` reads of length `read_length`.
+    std::filesystem::path reads(size_t const read_count, size_t const read_length) const
+    {
+        std::filesystem::path const file =
+            directory() / ("reads_" + std::to_string(read_count) + "_" + std::to_string(read_length) + ".fa");
+
+        if (std::filesystem::exists(file))
+            return file;
+
+        std::ofstream output{file};
+        size_t id{};
+        for (size_t const start :
+             seqan3::test::generate_numeric_sequence<size_t>(read_count, 0u, genome.size() - read_length, 0u))
+        {
+            output << ">read_" << id++ << '\n';
+            std::ranges::copy(std::span{genome.data() + start, read_length} | seqan3::views::to_char,
+                              std::ostreambuf_iterator<char>{output});
+            output << '\n';
+        }
+
+        return file;
+    }
+
+private:
+    std::vector<seqan3::dna4> genome{};
+    seqan3::test::tmp_directory tmp_directory{};
+
+    static void write_fasta(std::filesystem::path const & file,
+                            std::string const & id,
+                            std::span<seqan3::dna4 const> const sequence)
+    {
+        std::ofstream output{file};
+        output << '>' << id << '\n';
+        std::ranges::copy(sequence | seqan3::views::to_char, std::ostreambuf_iterator<char>{output});
+        output << '\n';
+    }
+};
+
+} // namespace raptor::test
@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <hibf/hierarchical_interleaved_bloom_filter.hpp>
+
+#include <raptor/argument_parsing/compute_bin_size.hpp>
+#include <raptor/argument_parsing/memory_usage.hpp>
+#include <raptor/build/max_count_per_partition.hpp>
+#include <raptor/build/raptor_build.hpp>
+#include <raptor/build/store_index.hpp>
+#include <raptor/file_reader.hpp>
+#include <raptor/prepare/compute_minimiser.hpp>
+#include <raptor/test/synthetic_data.hpp>
+
+#define USE_UNIT_TEST_PARAMETERS 1
+
+#if USE_UNIT_TEST_PARAMETERS
+static constexpr size_t const genome_size{1ULL << 20};
+static constexpr size_t const bin_count{64u};
+static constexpr size_t const max_threads{2u};
+#else
+static constexpr size_t const genome_size{1ULL << 30};
+static constexpr size_t const bin_count{1024u};
+static constexpr size_t const max_threads{64u};
+#endif
+
+static constexpr uint8_t const kmer_size{20u};
+static constexpr uint32_t const window_size{24u};
+static constexpr double const fpr{0.05};
+static constexpr uint8_t const parts{4u};
+
+static raptor::test::synthetic_data const data{genome_size};
+
+// getrusage's peak RSS cannot be reset. On Linux, writing 5 to /proc/self/clear_refs resets VmHWM.
+static void reset_peak_rss()
+{
+    std::ofstream clear_refs{"/proc/self/clear_refs"};
+    if (clear_refs.good())
+        clear_refs << "5";
+}
+
+static long peak_rss_in_KiB()
+{
+    std::ifstream status{"/proc/self/status"};
+    std::string line{};
+    while (std::getline(status, line))
+        if (line.starts_with("VmHWM:"))
+            return std::stol(line.substr(6));
+
+    return raptor::peak_ram_in_KiB();
+}
+
+/*!\brief Runs `fun` and reports throughput, peak RSS, and parallel efficiency.
+ * \details
+ * The parallel efficiency is `time(1 thread) / (threads * time(threads))`. It is only reported if the run with a
+ * single thread of the same benchmark has been executed before, which is the case when using `thread_counts()`.
+ */
+static void measure(benchmark::State & state, auto && fun)
+{
+    static std::map<std::string, double> single_thread_seconds{};
+
+    size_t const threads = static_cast<size_t>(state.range(0));
+    double seconds{};
+
+    reset_peak_rss();
+    for (auto _ : state)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        fun(threads);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    seconds /= state.iterations();
+
+    state.counters["bp/s"] = benchmark::Counter(genome_size, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["peak_rss_KiB"] = peak_rss_in_KiB();
+
+    std::string const name{state.name().substr(0, state.name().find('/'))};
+    if (threads == 1u)
+        single_thread_seconds[name] = seconds;
+    if (auto it = single_thread_seconds.find(name); it != single_thread_seconds.end() && seconds > 0.0)
+        state.counters["efficiency"] = it->second / (threads * seconds);
+}
+
+static raptor::build_arguments make_build_arguments(size_t const threads)
+{
+    raptor::build_arguments arguments{};
+    arguments.kmer_size = kmer_size;
+    arguments.window_size = window_size;
+    arguments.shape = seqan3::shape{seqan3::ungapped{kmer_size}};
+    arguments.out_path = data.directory() / "raptor.index";
+    arguments.bin_path = data.bin_path(bin_count);
+    arguments.bins = bin_count;
+    arguments.fpr = fpr;
+    arguments.threads = threads;
+    return arguments;
+}
+
+static void build_ibf(benchmark::State & state)
+{
+    raptor::build_arguments arguments = make_build_arguments(1u);
+    arguments.bits = raptor::compute_bin_size(arguments);
+
+    measure(state,
+            [&](size_t const threads)
+            {
+                arguments.threads = threads;
+                raptor::raptor_build(arguments);
+            });
+}
+
+static void build_partitioned_ibf(benchmark::State & state)
+{
+    raptor::build_arguments arguments = make_build_arguments(1u);
+    arguments.parts = parts;
+
+    measure(state,
+            [&](size_t const threads)
+            {
+                arguments.threads = threads;
+                raptor::raptor_build(arguments);
+            });
+}
+
+static void build_hibf(benchmark::State & state)
+{
+    std::vector<std::vector<std::string>> const bin_path = data.bin_path(bin_count);
+    seqan3::shape const shape{seqan3::ungapped{kmer_size}};
+    raptor::file_reader<raptor::file_types::sequence> const reader{shape, window_size};
+
+    measure(state,
+            [&](size_t const threads)
+            {
+                seqan::hibf::config config{};
+                config.input_fn = [&](size_t const user_bin_id, seqan::hibf::insert_iterator it)
+                {
+                    reader.hash_into(bin_path[user_bin_id], it);
+                };
+                config.number_of_user_bins = bin_count;
+                config.maximum_fpr = fpr;
+                config.threads = threads;
+
+                seqan::hibf::hierarchical_interleaved_bloom_filter hibf{config};
+                raptor::raptor_index<raptor::index_structure::hibf> index{raptor::window{window_size},
+                                                                          shape,
+                                                                          1u,
+                                                                          bin_path,
+                                                                          config,
+                                                                          std::move(hibf)};
+                raptor::store_index(data.directory() / "raptor.hibf", std::move(index));
+            });
+}
+
+static void compute_bin_size(benchmark::State & state)
+{
+    raptor::build_arguments arguments = make_build_arguments(1u);
+
+    measure(state,
+            [&](size_t const threads)
+            {
+                arguments.threads = threads;
+                benchmark::DoNotOptimize(raptor::compute_bin_size(arguments));
+            });
+}
+
+static void max_count_per_partition(benchmark::State & state)
+{
+    raptor::build_arguments arguments = make_build_arguments(1u);
+    arguments.parts = parts;
+    raptor::partition_config const cfg{parts};
+
+    measure(state,
+            [&](size_t const threads)
+            {
+                arguments.threads = threads;
+                benchmark::DoNotOptimize(raptor::max_count_per_partition(cfg, arguments));
+            });
+}
+
+static void compute_minimiser(benchmark::State & state)
+{
+    raptor::prepare_arguments arguments{};
+    arguments.kmer_size = kmer_size;
+    arguments.window_size = window_size;
+    arguments.shape = seqan3::shape{seqan3::ungapped{kmer_size}};
+    arguments.out_dir = data.directory() / "prepare";
+    arguments.bin_path = data.bin_path(bin_count);
+
+    measure(state,
+            [&](size_t const threads)
+            {
+                // Finished files are skipped; start from scratch in every iteration.
+                std::filesystem::remove_all(arguments.out_dir);
+                std::filesystem::create_directories(arguments.out_dir);
+                arguments.threads = threads;
+                raptor::compute_minimiser(arguments);
+            });
+}
+
+static void thread_counts(benchmark::internal::Benchmark * benchmark)
+{
+    size_t const limit = std::min<size_t>(max_threads, std::max(1u, std::thread::hardware_concurrency()));
+
+    benchmark->ArgName("threads");
+    for (size_t threads = 1u; threads <= limit; threads *= 2u)
+        benchmark->Arg(threads);
+
+    benchmark->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+BENCHMARK(build_ibf)->Apply(thread_counts);
+BENCHMARK(build_partitioned_ibf)->Apply(thread_counts);
+BENCHMARK(build_hibf)->Apply(thread_counts);
+BENCHMARK(compute_bin_size)->Apply(thread_counts);
+BENCHMARK(max_count_per_partition)->Apply(thread_counts);
+BENCHMARK(compute_minimiser)->Apply(thread_counts);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <benchmark/benchmark.h>
+
+#include <hibf/hierarchical_interleaved_bloom_filter.hpp>
+
+#include <raptor/argument_parsing/compute_bin_size.hpp>
+#include <raptor/build/raptor_build.hpp>
+#include <raptor/build/store_index.hpp>
+#include <raptor/file_reader.hpp>
+#include <raptor/search/search.hpp>
+#include <raptor/test/synthetic_data.hpp>
+
+#define USE_UNIT_TEST_PARAMETERS 1
+
+#if USE_UNIT_TEST_PARAMETERS
+static constexpr size_t const genome_size{1ULL << 20};
+static constexpr size_t const read_count{1ULL << 10};
+static constexpr size_t const threads{1u};
+#else
+static constexpr size_t const genome_size{1ULL << 28};
+static constexpr size_t const read_count{1ULL << 20};
+static constexpr size_t const threads{4u};
+#endif
+
+static constexpr uint8_t const kmer_size{20u};
+static constexpr double const fpr{0.05};
+static constexpr uint8_t const parts{4u};
+
+static raptor::test::synthetic_data const data{genome_size};
+
+enum class index_kind : uint8_t
+{
+    ibf,
+    partitioned_ibf,
+    hibf
+};
+
+// The window determines whether the lemma (window == k-mer) or the probabilistic threshold is used.
+// A percentage threshold of 0.0 reports every bin for every read and hence stresses the output formatting.
+enum class threshold_kind : uint8_t
+{
+    lemma,
+    probabilistic,
+    percentage,
+    all_bins
+};
+
+static uint32_t window_size(threshold_kind const threshold)
+{
+    return threshold == threshold_kind::probabilistic ? kmer_size + 4u : kmer_size;
+}
+
+static std::filesystem::path index_path(index_kind const kind, size_t const bin_count, uint32_t const window)
+{
+    std::filesystem::path result{data.directory()};
+    result /= "index_" + std::to_string(static_cast<int>(kind)) + "_" + std::to_string(bin_count) + "_"
+            + std::to_string(window);
+    return result;
+}
+
+static void build_ibf(index_kind const kind, size_t const bin_count, uint32_t const window)
+{
+    raptor::build_arguments arguments{};
+    arguments.kmer_size = kmer_size;
+    arguments.window_size = window;
+    arguments.shape = seqan3::shape{seqan3::ungapped{kmer_size}};
+    arguments.out_path = index_path(kind, bin_count, window);
+    arguments.bin_path = data.bin_path(bin_count);
+    arguments.bins = bin_count;
+    arguments.fpr = fpr;
+    arguments.threads = threads;
+
+    if (kind == index_kind::partitioned_ibf)
+        arguments.parts = parts;
+    else
+        arguments.bits = raptor::compute_bin_size(arguments);
+
+    raptor::raptor_build(arguments);
+}
+
+static void build_hibf(size_t const bin_count, uint32_t const window)
+{
+    std::vector<std::vector<std::string>> const bin_path = data.bin_path(bin_count);
+    seqan3::shape const shape{seqan3::ungapped{kmer_size}};
+    raptor::file_reader<raptor::file_types::sequence> const reader{shape, window};
+
+    seqan::hibf::config config{};
+    config.input_fn = [&](size_t const user_bin_id, seqan::hibf::insert_iterator it)
+    {
+        reader.hash_into(bin_path[user_bin_id], it);
+    };
+    config.number_of_user_bins = bin_count;
+    config.maximum_fpr = fpr;
+    config.threads = threads;
+
+    seqan::hibf::hierarchical_interleaved_bloom_filter hibf{config};
+    raptor::raptor_index<raptor::index_structure::hibf> index{raptor::window{window},
+                                                              shape,
+                                                              1u,
+                                                              bin_path,
+                                                              config,
+                                                              std::move(hibf)};
+    raptor::store_index(index_path(index_kind::hibf, bin_count, window), std::move(index));
+}
+
+static std::filesystem::path get_index(index_kind const kind, size_t const bin_count, uint32_t const window)
+{
+    std::filesystem::path const path = index_path(kind, bin_count, window);
+    std::filesystem::path const existing = kind == index_kind::partitioned_ibf ? path.string() + "_0" : path;
+
+    if (!std::filesystem::exists(existing))
+    {
+        if (kind == index_kind::hibf)
+            build_hibf(bin_count, window);
+        else
+            build_ibf(kind, bin_count, window);
+    }
+
+    return path;
+}
+
+static void search(benchmark::State & state, index_kind const kind, threshold_kind const threshold)
+{
+    size_t const bin_count = static_cast<size_t>(state.range(0));
+    size_t const read_length = static_cast<size_t>(state.range(1));
+    uint32_t const window = window_size(threshold);
+
+    raptor::search_arguments arguments{};
+    arguments.window_size = window;
+    arguments.shape = seqan3::shape{seqan3::ungapped{kmer_size}};
+    arguments.shape_size = arguments.shape.size();
+    arguments.shape_weight = arguments.shape.count();
+    arguments.threads = threads;
+    arguments.parts = kind == index_kind::partitioned_ibf ? parts : 1u;
+    arguments.fpr = fpr;
+    arguments.query_length = read_length;
+    arguments.errors = 1u;
+    arguments.is_hibf = kind == index_kind::hibf;
+    // Otherwise, the probabilistic thresholds would be recomputed in every iteration.
+    arguments.cache_thresholds = true;
+    arguments.index_file = get_index(kind, bin_count, window);
+    arguments.bin_path = raptor::bin_path_table{data.bin_path(bin_count)};
+    arguments.query_file = data.reads(read_count, read_length);
+    arguments.out_file = data.directory() / "search.out";
+
+    if (threshold == threshold_kind::percentage)
+        arguments.threshold = 0.7;
+    else if (threshold == threshold_kind::all_bins)
+        arguments.threshold = 0.0;
+
+    for (auto _ : state)
+        raptor::raptor_search(arguments);
+
+    // Includes query I/O and loading the index.
+    state.counters["reads/s"] = benchmark::Counter(read_count, benchmark::Counter::kIsIterationInvariantRate);
+
+    // Only the time spent in do_parallel.
+    double const search_time = arguments.parallel_search_timer.in_seconds();
+    state.counters["search_reads/s"] = search_time > 0.0 ? arguments.query_counter.value() / search_time : 0.0;
+    state.counters["search_minimisers/s"] =
+        search_time > 0.0 ? arguments.minimiser_counter.value() / search_time : 0.0;
+}
+
+#if USE_UNIT_TEST_PARAMETERS
+static void arguments(benchmark::internal::Benchmark * benchmark)
+{
+    benchmark->ArgNames({"bins", "read_length"})->ArgsProduct({{64, 128}, {100, 250}});
+}
+#else
+static void arguments(benchmark::internal::Benchmark * benchmark)
+{
+    benchmark->ArgNames({"bins", "read_length"})->ArgsProduct({{64, 1024, 8192}, {100, 250, 1000}});
+}
+#endif
+
+BENCHMARK_CAPTURE(search, ibf_lemma, index_kind::ibf, threshold_kind::lemma)->Apply(arguments);
+BENCHMARK_CAPTURE(search, ibf_probabilistic, index_kind::ibf, threshold_kind::probabilistic)->Apply(arguments);
+BENCHMARK_CAPTURE(search, ibf_percentage, index_kind::ibf, threshold_kind::percentage)->Apply(arguments);
+BENCHMARK_CAPTURE(search, ibf_all_bins, index_kind::ibf, threshold_kind::all_bins)->Apply(arguments);
+BENCHMARK_CAPTURE(search, partitioned_ibf_lemma, index_kind::partitioned_ibf, threshold_kind::lemma)
+    ->Apply(arguments);
+BENCHMARK_CAPTURE(search, hibf_lemma, index_kind::hibf, threshold_kind::lemma)->Apply(arguments);
+BENCHMARK_CAPTURE(search, hibf_probabilistic, index_kind::hibf, threshold_kind::probabilistic)->Apply(arguments);
+BENCHMARK_CAPTURE(search, hibf_percentage, index_kind::hibf, threshold_kind::percentage)->Apply(arguments);
+
+BENCHMARK_MAIN();
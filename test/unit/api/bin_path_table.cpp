@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+
+#include <raptor/bin_path_table.hpp>
+
+static std::vector<std::vector<std::string>> make_bin_path(size_t const count)
+{
+    std::vector<std::vector<std::string>> result{};
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::vector<std::string> & file_names = result.emplace_back();
+        for (size_t j = 0; j < i % 3u; ++j)
+            file_names.push_back("/data/genomes/bin_" + std::to_string(i) + "/file_" + std::to_string(j) + ".fa");
+    }
+    return result;
+}
+
+TEST(bin_path_table, empty)
+{
+    raptor::bin_path_table const table{};
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_TRUE(table.to_vector().empty());
+}
+
+TEST(bin_path_table, access)
+{
+    auto const bin_path = make_bin_path(50u);
+    raptor::bin_path_table const table{bin_path};
+
+    ASSERT_EQ(table.size(), bin_path.size());
+    EXPECT_EQ(table.to_vector(), bin_path);
+    for (size_t i = 0; i < bin_path.size(); ++i)
+        EXPECT_EQ(table[i], bin_path[i]);
+
+    std::string joined{};
+    table.for_each_file(38u,
+                        [&joined](std::string_view const file_name)
+                        {
+                            joined += file_name;
+                            joined += ';';
+                        });
+    EXPECT_EQ(joined, "/data/genomes/bin_38/file_0.fa;/data/genomes/bin_38/file_1.fa;");
+}
+
+TEST(bin_path_table, shared_prefixes_are_compressed)
+{
+    auto const bin_path = make_bin_path(1000u);
+    size_t plain_size{};
+    for (auto const & file_names : bin_path)
+        for (auto const & file_name : file_names)
+            plain_size += file_name.size();
+
+    raptor::bin_path_table const table{bin_path};
+    EXPECT_LT(table.encoded_size(), plain_size / 2u);
+}
+
+TEST(bin_path_table, push_back_after_subtable)
+{
+    auto bin_path = make_bin_path(40u);
+    raptor::bin_path_table table = raptor::bin_path_table{bin_path}.subtable(16u, 24u);
+    bin_path.erase(bin_path.begin(), bin_path.begin() + 16);
+
+    table.push_back({"/data/genomes/bin_39/file_0.fa", "/data/other/file.fa"});
+    bin_path.push_back({"/data/genomes/bin_39/file_0.fa", "/data/other/file.fa"});
+    EXPECT_EQ(table.to_vector(), bin_path);
+}
+
+TEST(bin_path_table, subtable_and_append)
+{
+    auto const bin_path = make_bin_path(70u);
+    raptor::bin_path_table const table{bin_path};
+
+    raptor::bin_path_table joined{};
+    for (size_t i = 0; i < table.size(); i += 32u)
+        joined.append(table.subtable(i, std::min<size_t>(32u, table.size() - i)));
+    EXPECT_EQ(joined, table);
+
+    // Appending to a table with an incomplete bucket re-encodes the other table.
+    raptor::bin_path_table unaligned = table.subtable(0u, 5u);
+    unaligned.append(table.subtable(16u, 20u));
+    std::vector<std::vector<std::string>> expected(bin_path.begin(), bin_path.begin() + 5);
+    expected.insert(expected.end(), bin_path.begin() + 16, bin_path.begin() + 36);
+    EXPECT_EQ(unaligned.to_vector(), expected);
+}
+
+TEST(bin_path_table, serialisation)
+{
+    raptor::bin_path_table const expected{make_bin_path(33u)};
+
+    std::stringstream stream{};
+    {
+        cereal::BinaryOutputArchive archive{stream};
+        archive(expected);
+    }
+
+    raptor::bin_path_table actual{};
+    {
+        cereal::BinaryInputArchive archive{stream};
+        archive(actual);
+    }
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(bin_path_table, corrupted)
+{
+    std::stringstream stream{};
+    {
+        cereal::BinaryOutputArchive archive{stream};
+        archive(uint64_t{33u});
+        archive(std::vector<uint64_t>{0u});
+        archive(std::string{});
+    }
+
+    raptor::bin_path_table actual{};
+    cereal::BinaryInputArchive archive{stream};
+    EXPECT_THROW(archive(actual), std::runtime_error);
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <raptor/build/bulk_inserter.hpp>
+
+// If this fails, the IBF's hashing changed and raptor::detail::ibf_positions needs to be updated.
+TEST(bulk_inserter, replica_matches_ibf)
+{
+    for (size_t hash_count = 1u; hash_count <= 5u; ++hash_count)
+    {
+        // 130 user bins: The last word column is only partially used.
+        for (size_t bins : {64u, 130u})
+        {
+            seqan::hibf::interleaved_bloom_filter expected{seqan::hibf::bin_count{bins},
+                                                           seqan::hibf::bin_size{1021u},
+                                                           seqan::hibf::hash_function_count{hash_count}};
+            seqan::hibf::interleaved_bloom_filter actual{expected};
+            raptor::detail::ibf_positions const positions{actual};
+
+            uint64_t * const data = actual.raw_data().data();
+            for (uint64_t i = 0; i < 256u; ++i)
+            {
+                uint64_t const value = i * 0x9E37'79B9'7F4A'7C15ULL;
+                size_t const bin = (i * 7u) % bins;
+                expected.emplace(value, seqan::hibf::bin_index{bin});
+                for (size_t h = 0; h < hash_count; ++h)
+                    data[positions.word(value, h) + bin / 64u] |= 1ULL << (bin % 64u);
+            }
+
+            EXPECT_EQ(std::memcmp(expected.raw_data().data(), data, actual.bit_size() / 8u), 0)
+                << "hash_count: " << hash_count << ", bins: " << bins;
+        }
+    }
+}
+
+TEST(bulk_inserter, same_as_emplace)
+{
+    // 200 user bins: The last word column is only partially used.
+    // 2^22 bits per bin: More than one memory block.
+    seqan::hibf::interleaved_bloom_filter expected{seqan::hibf::bin_count{200u},
+                                                   seqan::hibf::bin_size{1ULL << 22},
+                                                   seqan::hibf::hash_function_count{3u}};
+    seqan::hibf::interleaved_bloom_filter actual{expected};
+    raptor::detail::ibf_positions const positions{actual};
+
+    {
+        raptor::bulk_inserter inserter{actual, positions};
+        for (size_t bin = 0; bin < 200u; ++bin)
+        {
+            auto it = inserter.emplacer(seqan::hibf::bin_index{bin});
+            for (uint64_t i = 0; i < 5000u; ++i)
+            {
+                uint64_t const value = i * 0x1234'5677ULL + bin;
+                expected.emplace(value, seqan::hibf::bin_index{bin});
+                *it = value;
+                ++it;
+            }
+        }
+        inserter.flush();
+    }
+
+    EXPECT_EQ(std::memcmp(expected.raw_data().data(), actual.raw_data().data(), actual.bit_size() / 8u), 0);
+}
+
+TEST(bulk_inserter, insert_blocks)
+{
+    seqan::hibf::interleaved_bloom_filter expected{seqan::hibf::bin_count{70u},
+                                                   seqan::hibf::bin_size{1ULL << 20},
+                                                   seqan::hibf::hash_function_count{2u}};
+    seqan::hibf::interleaved_bloom_filter actual{expected};
+    raptor::detail::ibf_positions const positions{actual};
+
+    // Bigger than the buffer of the bulk inserter.
+    std::vector<uint64_t> values((1ULL << 20) + 10u);
+    {
+        raptor::bulk_inserter inserter{actual, positions};
+        for (size_t bin : {0u, 69u, 3u})
+        {
+            for (uint64_t i = 0; i < values.size(); ++i)
+            {
+                values[i] = i * 0x9E37'79B9'7F4A'7C15ULL + bin;
+                expected.emplace(values[i], seqan::hibf::bin_index{bin});
+            }
+            inserter.insert(std::span<uint64_t const>{values}.first(1000u), seqan::hibf::bin_index{bin});
+            inserter.insert(std::span<uint64_t const>{values}.subspan(1000u), seqan::hibf::bin_index{bin});
+        }
+    }
+
+    EXPECT_EQ(std::memcmp(expected.raw_data().data(), actual.raw_data().data(), actual.bit_size() / 8u), 0);
+}
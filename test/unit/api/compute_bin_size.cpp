@@ -45,3 +45,13 @@ TEST_F(compute_bin_size, mixed)
     size_t const result = raptor::compute_bin_size(config);
     EXPECT_EQ(result, 3794u); // exact count = 480, exact size = 3794
 }
+
+TEST_F(compute_bin_size, memory_limit)
+{
+    // The biggest user bin is read multiple times; each pass counts a subset of the minimisers.
+    raptor::build_arguments const config{.count_memory = 1u,
+                                         .bin_path = {{data("multi_record_bin.fa")}, {data("bin3.fa")}},
+                                         .threads = 2u};
+    size_t const result = raptor::compute_bin_size(config);
+    EXPECT_EQ(result, 3794u); // exact count = 480, exact size = 3794
+}
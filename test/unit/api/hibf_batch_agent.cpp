@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include <seqan3/io/sequence_file/input.hpp>
+#include <seqan3/search/views/minimiser_hash.hpp>
+
+#include <raptor/adjust_seed.hpp>
+#include <raptor/dna4_traits.hpp>
+#include <raptor/search/hibf_batch_agent.hpp>
+#include <raptor/search/load_index.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct hibf_batch_agent : public raptor_base, public testing::WithParamInterface<std::string>
+{
+    using hibf_index_t = raptor::raptor_index<raptor::index_structure::hibf>;
+
+    std::vector<std::vector<uint64_t>> queries{};
+    std::vector<size_t> thresholds{};
+
+    void make_queries(hibf_index_t const & index)
+    {
+        auto hash_adaptor = seqan3::views::minimiser_hash(index.shape(),
+                                                          seqan3::window_size{index.window_size()},
+                                                          seqan3::seed{raptor::adjust_seed(index.shape().count())});
+
+        // Reads of different bins, and reads that are not in the index.
+        seqan3::sequence_file_input<raptor::dna4_traits, seqan3::fields<seqan3::field::seq>> fin{data("query.fq")};
+        for (auto && [seq] : fin)
+        {
+            auto minimiser_view = seq | hash_adaptor | std::views::common;
+            queries.emplace_back(minimiser_view.begin(), minimiser_view.end());
+        }
+        std::mt19937_64 engine{42u};
+        for (size_t i = 0; i < 10u; ++i)
+        {
+            std::vector<uint64_t> & query = queries.emplace_back(queries[i % 3u]);
+            std::uniform_int_distribution<uint64_t> distribution{};
+            for (size_t j = 0; j < query.size(); j += i + 1u)
+                query[j] = distribution(engine);
+        }
+
+        thresholds.resize(queries.size());
+        for (size_t i = 0; i < thresholds.size(); ++i)
+            thresholds[i] = 1u + i * 7u % (queries[i].size() + 1u);
+    }
+
+    std::vector<std::vector<uint64_t>> expected_results(hibf_index_t & index) const
+    {
+        auto agent = index.ibf().membership_agent();
+        std::vector<std::vector<uint64_t>> expected{};
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            auto & result = expected.emplace_back(agent.membership_for(queries[i], thresholds[i]));
+            std::ranges::sort(result);
+        }
+        return expected;
+    }
+};
+
+TEST_P(hibf_batch_agent, same_results)
+{
+    hibf_index_t index{};
+    raptor::detail::load_index(index, data(GetParam()));
+    make_queries(index);
+    std::vector<std::vector<uint64_t>> const expected = expected_results(index);
+
+    raptor::hibf_batch_agent<raptor::index_structure::hibf> actual_agent{index.ibf()};
+    for (size_t const batch_size : {1u, 2u, 5u, 1000u})
+    {
+        for (size_t start = 0; start < queries.size(); start += batch_size)
+        {
+            size_t const count = std::min(batch_size, queries.size() - start);
+            auto const & actual = actual_agent.membership_for({queries.data() + start, count},
+                                                              {thresholds.data() + start, count});
+            ASSERT_EQ(actual.size(), count);
+            for (size_t i = 0; i < count; ++i)
+                EXPECT_EQ(actual[i], expected[start + i]) << "Batch size " << batch_size << ", read " << start + i;
+        }
+    }
+
+    EXPECT_TRUE(actual_agent.membership_for({}, {}).empty());
+}
+
+TEST_P(hibf_batch_agent, deleted_bins)
+{
+    hibf_index_t index{};
+    raptor::detail::load_index(index, data(GetParam()));
+    make_queries(index);
+
+    // Mark every fourth user bin as deleted. The bins are not cleared, such that the deleted bins are reported.
+    for (std::vector<uint64_t> & user_bin_ids : index.ibf().ibf_bin_to_user_bin_id)
+        for (uint64_t & user_bin_id : user_bin_ids)
+            if (user_bin_id != seqan::hibf::bin_kind::merged && user_bin_id % 4u == 1u)
+                user_bin_id = seqan::hibf::bin_kind::deleted;
+
+    std::vector<std::vector<uint64_t>> const expected = expected_results(index);
+    ASSERT_TRUE(std::ranges::any_of(expected,
+                                    [](std::vector<uint64_t> const & result)
+                                    {
+                                        return std::ranges::find(result, seqan::hibf::bin_kind::deleted)
+                                            != result.end();
+                                    }));
+
+    raptor::hibf_batch_agent<raptor::index_structure::hibf> actual_agent{index.ibf()};
+    auto const & actual = actual_agent.membership_for(queries, thresholds);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i)
+        EXPECT_EQ(actual[i], expected[i]) << "Read " << i;
+}
+
+TEST_P(hibf_batch_agent, selected_bins)
+{
+    hibf_index_t index{};
+    raptor::detail::load_index(index, data(GetParam()));
+    make_queries(index);
+    std::vector<std::vector<uint64_t>> expected = expected_results(index);
+
+    // Every third user bin.
+    std::vector<bool> selected_user_bins(index.bin_path().size());
+    for (size_t user_bin_id = 0; user_bin_id < selected_user_bins.size(); user_bin_id += 3u)
+        selected_user_bins[user_bin_id] = true;
+    for (std::vector<uint64_t> & result : expected)
+        std::erase_if(result,
+                      [&](uint64_t const user_bin_id)
+                      {
+                          return !selected_user_bins[user_bin_id];
+                      });
+
+    using agent_t = raptor::hibf_batch_agent<raptor::index_structure::hibf>;
+    std::vector<std::vector<bool>> const selected_bins = agent_t::select_bins(index.ibf(), selected_user_bins);
+    ASSERT_EQ(selected_bins.size(), index.ibf().ibf_vector.size());
+
+    agent_t actual_agent{index.ibf(), selected_bins};
+    auto const & actual = actual_agent.membership_for(queries, thresholds);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i)
+        EXPECT_EQ(actual[i], expected[i]) << "Read " << i;
+}
+
+INSTANTIATE_TEST_SUITE_P(hibf_batch_agent_suite,
+                         hibf_batch_agent,
+                         testing::Values("three_levels.hibf", "128bins23window.hibf"),
+                         [](testing::TestParamInfo<hibf_batch_agent::ParamType> const & info)
+                         {
+                             std::string name = info.param.substr(0, info.param.find('.'));
+                             return name;
+                         });
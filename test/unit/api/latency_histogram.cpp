@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <raptor/argument_parsing/latency_histogram.hpp>
+
+using namespace std::chrono_literals;
+
+TEST(latency_histogram, bucket_index)
+{
+    using buckets = raptor::detail::latency_buckets;
+
+    // Small values are exact.
+    for (uint64_t value = 0u; value < 2u * buckets::sub_bucket_count; ++value)
+    {
+        EXPECT_EQ(buckets::index_of(value), value);
+        EXPECT_EQ(buckets::highest_equivalent_value(buckets::index_of(value)), value);
+    }
+
+    // Larger values are mapped to a bucket whose upper bound is at most 1/16 off.
+    for (uint64_t value : {33ULL, 100ULL, 1000ULL, 123456ULL, 987654321ULL, (1ULL << 40) + 17u, ~0ULL})
+    {
+        size_t const index = buckets::index_of(value);
+        ASSERT_LT(index, buckets::bucket_count);
+        uint64_t const upper = buckets::highest_equivalent_value(index);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / buckets::sub_bucket_count);
+        if (index > 0u)
+        {
+            EXPECT_LT(buckets::highest_equivalent_value(index - 1u), value);
+        }
+    }
+}
+
+TEST(latency_histogram, empty)
+{
+    raptor::concurrent_latency_histogram histogram{};
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile_in_microseconds(50.0), 0.0);
+    EXPECT_EQ(histogram.max_in_microseconds(), 0.0);
+}
+
+TEST(latency_histogram, percentiles)
+{
+    raptor::latency_histogram local{};
+    for (size_t i = 1u; i <= 100u; ++i)
+        local.record(std::chrono::microseconds{i});
+
+    raptor::concurrent_latency_histogram histogram{};
+    histogram += local;
+    histogram += local;
+
+    EXPECT_EQ(histogram.count(), 200u);
+    EXPECT_NEAR(histogram.percentile_in_microseconds(50.0), 50.0, 50.0 / 16);
+    EXPECT_NEAR(histogram.percentile_in_microseconds(95.0), 95.0, 95.0 / 16);
+    EXPECT_NEAR(histogram.percentile_in_microseconds(99.0), 99.0, 99.0 / 16);
+    EXPECT_EQ(histogram.percentile_in_microseconds(100.0), 100.0);
+    EXPECT_EQ(histogram.max_in_microseconds(), 100.0);
+}
+
+TEST(latency_histogram, copy_does_not_copy_values)
+{
+    raptor::latency_histogram local{};
+    local.record(1ms);
+
+    raptor::concurrent_latency_histogram histogram{};
+    histogram += local;
+    raptor::concurrent_latency_histogram copy{histogram};
+    EXPECT_EQ(histogram.count(), 1u);
+    EXPECT_EQ(copy.count(), 0u);
+
+    raptor::concurrent_counter counter{};
+    counter += 5u;
+    counter += 7u;
+    raptor::concurrent_counter counter_copy{counter};
+    EXPECT_EQ(counter.value(), 12u);
+    EXPECT_EQ(counter_copy.value(), 0u);
+}
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <seqan3/io/sequence_file/input.hpp>
+#include <seqan3/search/views/minimiser_hash.hpp>
+
+#include <raptor/adjust_seed.hpp>
+#include <raptor/build/store_index.hpp>
+#include <raptor/dna4_traits.hpp>
+#include <raptor/search/hibf_batch_agent.hpp>
+#include <raptor/search/lazy_hibf.hpp>
+#include <raptor/search/load_index.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct lazy_hibf : public raptor_base
+{
+    using hibf_index_t = raptor::raptor_index<raptor::index_structure::hibf>;
+
+    static std::vector<std::vector<uint64_t>> minimisers(hibf_index_t const & index)
+    {
+        auto hash_adaptor = seqan3::views::minimiser_hash(index.shape(),
+                                                          seqan3::window_size{index.window_size()},
+                                                          seqan3::seed{raptor::adjust_seed(index.shape().count())});
+
+        std::vector<std::vector<uint64_t>> result{};
+        seqan3::sequence_file_input<raptor::dna4_traits, seqan3::fields<seqan3::field::seq>> fin{data("query.fq")};
+        for (auto && [seq] : fin)
+        {
+            auto minimiser_view = seq | hash_adaptor | std::views::common;
+            result.emplace_back(minimiser_view.begin(), minimiser_view.end());
+        }
+        return result;
+    }
+};
+
+TEST_F(lazy_hibf, same_results)
+{
+    hibf_index_t expected{};
+    raptor::detail::load_index(expected, data("three_levels.hibf"));
+    std::vector<std::vector<uint64_t>> const queries = minimisers(expected);
+
+    {
+        hibf_index_t index{};
+        raptor::detail::load_index(index, data("three_levels.hibf"));
+        raptor::store_index("lazy.hibf", std::move(index), 2u);
+    }
+
+    // A cache of 0 bytes keeps only the last loaded IBF.
+    raptor::lazy_hibf actual{};
+    actual.load("lazy.hibf", 1u, 0u, 2u);
+    EXPECT_EQ(actual.levels(), 3u);
+    EXPECT_EQ(actual.hash_function_count(), expected.ibf().ibf_vector[0].hash_function_count());
+
+    // One read per batch: Each IBF on the path of a read is queried once per read.
+    auto expected_agent = expected.ibf().membership_agent();
+    raptor::hibf_batch_agent<raptor::lazy_hibf> actual_agent{actual};
+    for (std::vector<uint64_t> const & query : queries)
+    {
+        for (size_t const threshold : {1u, 10u, 50u})
+        {
+            auto expected_result = expected_agent.membership_for(query, threshold);
+            std::ranges::sort(expected_result);
+            auto const & actual_result = actual_agent.membership_for({&query, 1u}, {&threshold, 1u});
+            ASSERT_EQ(actual_result.size(), 1u);
+            EXPECT_EQ(actual_result[0], expected_result);
+        }
+    }
+
+    std::vector<raptor::hibf_level_counts> const & counts = actual_agent.level_counts();
+    ASSERT_EQ(counts.size(), 3u);
+    EXPECT_EQ(counts[0].queries, queries.size() * 3u);
+    EXPECT_EQ(counts[0].loads, 0u); // Resident
+    EXPECT_GT(counts[1].queries, 0u);
+    EXPECT_GT(counts[1].loads, 0u);
+    EXPECT_LE(counts[2].loads, counts[2].queries);
+}
+
+TEST_F(lazy_hibf, cache)
+{
+    {
+        hibf_index_t index{};
+        raptor::detail::load_index(index, data("three_levels.hibf"));
+        raptor::store_index("lazy.hibf", std::move(index), 1u, true);
+    }
+
+    hibf_index_t expected{};
+    raptor::detail::load_index(expected, "lazy.hibf");
+    std::vector<std::vector<uint64_t>> const queries = minimisers(expected);
+
+    // All levels are resident.
+    raptor::lazy_hibf resident{};
+    resident.load("lazy.hibf", 3u, 0u, 1u);
+    std::vector<size_t> const thresholds(queries.size(), 1u);
+    raptor::hibf_batch_agent<raptor::lazy_hibf> resident_agent{resident};
+    resident_agent.membership_for(queries, thresholds);
+    for (raptor::hibf_level_counts const & level : resident_agent.level_counts())
+        EXPECT_EQ(level.loads, 0u);
+    EXPECT_EQ(resident.cache_size(), 0u);
+
+    // The cache is big enough for all IBFs: Each IBF is loaded at most once.
+    raptor::lazy_hibf cached{};
+    cached.load("lazy.hibf", 1u, 1ULL << 30, 1u);
+    raptor::hibf_batch_agent<raptor::lazy_hibf> cached_agent{cached};
+    for (size_t i = 0; i < queries.size(); ++i)
+        cached_agent.membership_for({&queries[i], 1u}, {&thresholds[i], 1u});
+    cached_agent.membership_for(queries, thresholds);
+
+    uint64_t loads{};
+    for (raptor::hibf_level_counts const & level : cached_agent.level_counts())
+        loads += level.loads;
+    EXPECT_GT(loads, 0u);
+    EXPECT_LT(loads, expected.ibf().ibf_vector.size());
+    EXPECT_GT(cached.cache_size(), 0u);
+}
+
+TEST_F(lazy_hibf, pinned)
+{
+    {
+        hibf_index_t index{};
+        raptor::detail::load_index(index, data("three_levels.hibf"));
+        raptor::store_index("lazy.hibf", std::move(index), 1u);
+    }
+
+    raptor::lazy_hibf lazy{};
+    lazy.load("lazy.hibf", 1u, 0u, 1u);
+
+    std::vector<size_t> loadable{};
+    for (size_t ibf_id = 0; ibf_id < lazy.next_ibf_id().size(); ++ibf_id)
+        if (lazy.level(ibf_id) > 0u)
+            loadable.push_back(ibf_id);
+    ASSERT_GE(loadable.size(), 3u);
+
+    bool loaded{};
+    uint64_t pinned_size{};
+    {
+        // A pinned IBF is not evicted and counts towards the cache.
+        auto const first = lazy.ibf(loadable[0], loaded);
+        EXPECT_TRUE(loaded);
+        pinned_size = lazy.cache_size();
+        EXPECT_GT(pinned_size, 0u);
+
+        auto const second = lazy.ibf(loadable[1], loaded);
+        EXPECT_TRUE(loaded);
+        EXPECT_GT(lazy.cache_size(), pinned_size);
+        EXPECT_EQ(lazy.ibf(loadable[0], loaded), first);
+        EXPECT_FALSE(loaded);
+    }
+
+    // Once released, the IBFs are evicted by the next load.
+    auto const third = lazy.ibf(loadable[2], loaded);
+    EXPECT_TRUE(loaded);
+    uint64_t const third_size = lazy.cache_size();
+    lazy.ibf(loadable[0], loaded);
+    EXPECT_TRUE(loaded);
+    EXPECT_EQ(lazy.cache_size(), third_size + pinned_size);
+}
@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <raptor/minimiser_container.hpp>
+#include <raptor/minimiser_file.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct minimiser_container : public raptor_base
+{
+    static raptor::minimiser_header header(uint64_t const count)
+    {
+        return {.shape_string = "1111111111111111111",
+                .window_size = 23u,
+                .cutoff = 1u,
+                .count = count,
+                .suffix_counts = std::array<uint64_t, raptor::minimiser_header::suffixes>{}};
+    }
+
+    static std::vector<uint64_t> read(std::filesystem::path const & path)
+    {
+        std::vector<uint64_t> result{};
+        raptor::for_each_minimiser(path,
+                                   [&](uint64_t const value)
+                                   {
+                                       result.push_back(value);
+                                   });
+        return result;
+    }
+
+    // Writes a compressed and an uncompressed minimiser file to shard 0.
+    static void write_shard(std::filesystem::path const & directory)
+    {
+        raptor::minimiser_shard_writer shard{directory, 0u};
+        {
+            raptor::compressed_minimiser_writer writer{shard.begin(), seqan3::shape{seqan3::ungapped{19u}}, 23u};
+            for (uint64_t const value : compressed_values)
+                writer.push(value);
+        }
+        shard.commit("compressed", header(compressed_values.size()));
+
+        std::ostream & stream = shard.begin();
+        stream.write(reinterpret_cast<char const *>(uncompressed_values.data()),
+                     uncompressed_values.size() * sizeof(uint64_t));
+        shard.commit("uncompressed", header(uncompressed_values.size()));
+    }
+
+    static inline std::vector<uint64_t> const compressed_values{1u, 5u, 300u, 1ULL << 40};
+    static inline std::vector<uint64_t> const uncompressed_values{42u, 7u, 1ULL << 50};
+};
+
+TEST_F(minimiser_container, read)
+{
+    std::filesystem::create_directory("container");
+    write_shard("container");
+
+    EXPECT_EQ(read("container/compressed.minimiser"), compressed_values);
+    EXPECT_EQ(read("container/uncompressed.minimiser"), uncompressed_values);
+    EXPECT_EQ(raptor::minimiser_count("container/compressed.minimiser"), compressed_values.size());
+    EXPECT_EQ(raptor::minimiser_count("container/uncompressed.minimiser"), uncompressed_values.size());
+
+    auto const found = raptor::find_minimiser_header("container/uncompressed.minimiser");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->count, uncompressed_values.size());
+    EXPECT_EQ(found->window_size, 23u);
+    EXPECT_TRUE(found->suffix_counts.has_value());
+
+    EXPECT_FALSE(raptor::minimiser_container::find("container/missing.minimiser").has_value());
+    EXPECT_FALSE(raptor::find_minimiser_header("container/missing.minimiser").has_value());
+}
+
+TEST_F(minimiser_container, recover)
+{
+    std::filesystem::create_directory("container");
+    write_shard("container");
+    size_t const shard_size = std::filesystem::file_size(raptor::minimiser_container::shard_path("container", 0u));
+
+    // An interrupted run: A minimiser file without index line, and an incomplete index line.
+    {
+        std::ofstream{raptor::minimiser_container::shard_path("container", 0u), std::ios::app} << "partial";
+        std::ofstream{raptor::minimiser_container::index_path("container", 0u), std::ios::app} << "partial\t0";
+        std::ofstream{raptor::minimiser_container::shard_path("container", 1u)} << "partial";
+    }
+
+    raptor::minimiser_container const container = raptor::minimiser_container::recover("container");
+    EXPECT_EQ(container.size(), 2u);
+    EXPECT_TRUE(container.contains("compressed"));
+    EXPECT_TRUE(container.contains("uncompressed"));
+    EXPECT_EQ(std::filesystem::file_size(raptor::minimiser_container::shard_path("container", 0u)), shard_size);
+    EXPECT_EQ(std::filesystem::file_size(raptor::minimiser_container::shard_path("container", 1u)), 0u);
+
+    // Appending after recovering.
+    {
+        raptor::minimiser_shard_writer shard{"container", 0u};
+        uint64_t const value{3u};
+        shard.begin().write(reinterpret_cast<char const *>(&value), sizeof(value));
+        shard.commit("appended", header(1u));
+    }
+
+    EXPECT_EQ(raptor::minimiser_container{"container"}.size(), 3u);
+    EXPECT_EQ(read("container/appended.minimiser"), std::vector<uint64_t>{3u});
+    EXPECT_EQ(read("container/uncompressed.minimiser"), uncompressed_values);
+}
+
+TEST_F(minimiser_container, cache)
+{
+    std::filesystem::create_directory("container");
+    write_shard("container");
+
+    auto append = [](size_t const shard_id, std::string const & name)
+    {
+        raptor::minimiser_shard_writer shard{"container", shard_id};
+        uint64_t const value{3u};
+        shard.begin().write(reinterpret_cast<char const *>(&value), sizeof(value));
+        shard.commit(name, header(1u));
+    };
+
+    // Without a cache, the indices are read on each lookup.
+    EXPECT_FALSE(raptor::minimiser_container::find("container/first.minimiser").has_value());
+    append(1u, "first");
+    EXPECT_TRUE(raptor::minimiser_container::find("container/first.minimiser").has_value());
+
+    {
+        raptor::minimiser_container::cache const cache{};
+        EXPECT_TRUE(raptor::minimiser_container::find("container/compressed.minimiser").has_value());
+
+        // Changes are not visible while the cache exists.
+        append(1u, "second");
+        EXPECT_FALSE(raptor::minimiser_container::find("container/second.minimiser").has_value());
+    }
+    EXPECT_TRUE(raptor::minimiser_container::find("container/second.minimiser").has_value());
+
+    // A file that exists is not looked up in the container.
+    {
+        std::ofstream file{"container/compressed.minimiser", std::ios::binary};
+        uint64_t const value{3u};
+        file.write(reinterpret_cast<char const *>(&value), sizeof(value));
+    }
+    EXPECT_FALSE(raptor::minimiser_container::find("container/compressed.minimiser").has_value());
+    EXPECT_EQ(read("container/compressed.minimiser"), std::vector<uint64_t>{3u});
+}
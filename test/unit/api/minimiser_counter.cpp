@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <raptor/prepare/minimiser_counter.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct minimiser_counter : public raptor_base
+{
+    static constexpr int hash_bits{40};
+
+    // All hashes share the 6 most significant bits: The first bucket needs to be split again.
+    static std::vector<uint64_t> hashes()
+    {
+        std::vector<uint64_t> result{};
+        for (uint64_t i = 0; i < 300'000u; ++i)
+        {
+            uint64_t const hash = (5ULL << (hash_bits - 6)) | ((i * 0x9E37'79B9ULL) & ((1ULL << (hash_bits - 6)) - 1u));
+            result.insert(result.end(), i % 5u + 1u, hash);
+        }
+        return result;
+    }
+
+    static std::vector<uint64_t> count(size_t const memory_limit, uint8_t const cutoff, bool const sorted)
+    {
+        raptor::minimiser_counter counter{cutoff, memory_limit, "test.bucket", hash_bits};
+        for (uint64_t const hash : hashes())
+            counter.insert(hash);
+
+        std::vector<uint64_t> result{};
+        counter.emit(sorted,
+                     [&](uint64_t const hash)
+                     {
+                         result.push_back(hash);
+                     });
+
+        EXPECT_EQ(counter.spilled(), memory_limit != 0u);
+        EXPECT_EQ(counter.distinct(), 300'000u);
+        return result;
+    }
+};
+
+TEST_F(minimiser_counter, same_as_unlimited)
+{
+    for (uint8_t const cutoff : {1u, 3u})
+    {
+        std::vector<uint64_t> expected = count(0u, cutoff, false);
+        std::ranges::sort(expected);
+        EXPECT_EQ(expected.size(), cutoff == 1u ? 300'000u : 180'000u);
+
+        EXPECT_EQ(count(0u, cutoff, true), expected);
+        EXPECT_EQ(count(1u, cutoff, true), expected);
+
+        std::vector<uint64_t> unsorted = count(1u, cutoff, false);
+        std::ranges::sort(unsorted);
+        EXPECT_EQ(unsorted, expected);
+    }
+
+    // All bucket files are removed.
+    EXPECT_TRUE(std::filesystem::is_empty(std::filesystem::current_path()));
+}
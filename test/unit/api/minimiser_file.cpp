@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <raptor/minimiser_file.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct minimiser_file : public raptor_base
+{
+    // Small and big deltas; more than one read block.
+    static std::vector<uint64_t> values()
+    {
+        std::vector<uint64_t> result{0u, 127u, 128u, 16'383u, 16'384u, std::numeric_limits<uint64_t>::max()};
+        for (uint64_t i = 1u; i < 1'000'000u; ++i)
+            result.push_back(i * 0x9E37'79B9'7F4A'7C15ULL);
+        return result;
+    }
+
+    static std::vector<uint64_t> read(std::filesystem::path const & path)
+    {
+        std::vector<uint64_t> result{};
+        raptor::for_each_minimiser(path,
+                                   [&](uint64_t const value)
+                                   {
+                                       result.push_back(value);
+                                   });
+        return result;
+    }
+};
+
+TEST_F(minimiser_file, compressed)
+{
+    std::vector<uint64_t> expected = values();
+    std::vector<uint64_t> minimisers = expected;
+    raptor::write_compressed_minimiser_file("test.minimiser", minimisers, seqan3::shape{seqan3::ungapped{19u}}, 23u);
+    std::ranges::sort(expected);
+
+    EXPECT_EQ(read("test.minimiser"), expected);
+    EXPECT_EQ(raptor::minimiser_count("test.minimiser"), expected.size());
+    EXPECT_LT(std::filesystem::file_size("test.minimiser"), expected.size() * sizeof(uint64_t));
+
+    std::ifstream stream{"test.minimiser", std::ios::binary};
+    auto const header = raptor::detail::read_minimiser_file_header(stream);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->count, expected.size());
+    EXPECT_EQ(header->shape, seqan3::shape{seqan3::ungapped{19u}}.to_ulong());
+    EXPECT_EQ(header->window_size, 23u);
+}
+
+TEST_F(minimiser_file, uncompressed)
+{
+    std::vector<uint64_t> const expected = values();
+    {
+        std::ofstream stream{"test.minimiser", std::ios::binary};
+        stream.write(reinterpret_cast<char const *>(expected.data()), expected.size() * sizeof(uint64_t));
+    }
+
+    EXPECT_EQ(read("test.minimiser"), expected);
+    EXPECT_EQ(raptor::minimiser_count("test.minimiser"), expected.size());
+}
+
+TEST_F(minimiser_file, empty)
+{
+    std::vector<uint64_t> minimisers{};
+    raptor::write_compressed_minimiser_file("test.minimiser", minimisers, seqan3::shape{seqan3::ungapped{19u}}, 19u);
+    EXPECT_TRUE(read("test.minimiser").empty());
+    EXPECT_EQ(raptor::minimiser_count("test.minimiser"), 0u);
+
+    std::ofstream{"empty.minimiser"};
+    EXPECT_TRUE(read("empty.minimiser").empty());
+    EXPECT_EQ(raptor::minimiser_count("empty.minimiser"), 0u);
+}
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include <raptor/minimiser_header.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct minimiser_header : public raptor_base
+{};
+
+TEST_F(minimiser_header, suffix_counts)
+{
+    std::array<uint64_t, raptor::minimiser_header::suffixes> counts{};
+    std::iota(counts.begin(), counts.end(), 1u);
+
+    raptor::minimiser_header{.shape_string = "1111111111111111111",
+                             .window_size = 23u,
+                             .cutoff = 3u,
+                             .count = 2080u,
+                             .suffix_counts = counts}
+        .write("test.header");
+
+    raptor::minimiser_header const header = raptor::minimiser_header::read("test.header");
+    EXPECT_EQ(header.shape_string, "1111111111111111111");
+    EXPECT_EQ(header.window_size, 23u);
+    EXPECT_EQ(header.cutoff, 3u);
+    EXPECT_EQ(header.count, 2080u);
+    ASSERT_TRUE(header.suffix_counts.has_value());
+    EXPECT_EQ(*header.suffix_counts, counts);
+}
+
+// Headers written by older versions of raptor prepare.
+TEST_F(minimiser_header, without_suffix_counts)
+{
+    std::ofstream{"test.header"} << "1111111111111111111\t23\t3\t2080\n";
+
+    raptor::minimiser_header const header = raptor::minimiser_header::read("test.header");
+    EXPECT_EQ(header.count, 2080u);
+    EXPECT_FALSE(header.suffix_counts.has_value());
+}
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#include <raptor/argument_parsing/perf_counters.hpp>
+
+using raptor::detail::perf_event;
+
+TEST(perf_counters, disabled)
+{
+    raptor::perf_counter_group const group{false};
+    EXPECT_FALSE(group.is_valid());
+    EXPECT_EQ(group.unavailable_mask(), 0b1111);
+
+    raptor::serial_perf_counter local{group};
+    local.start();
+    local.stop();
+
+    raptor::concurrent_perf_counter counter{};
+    counter += local;
+    EXPECT_FALSE(counter.is_available(perf_event::cycles));
+    EXPECT_FALSE(counter.is_available(perf_event::dtlb_load_misses));
+
+    std::ostringstream output_stream{};
+    raptor::detail::write_perf_counter_header(output_stream, "query_ibf");
+    EXPECT_EQ(output_stream.str(),
+              "\tquery_ibf_cycles\tquery_ibf_instructions\tquery_ibf_ipc\tquery_ibf_llc_misses"
+              "\tquery_ibf_dtlb_load_misses");
+
+    output_stream.str("");
+    raptor::detail::write_perf_counter_values(output_stream, counter);
+    EXPECT_EQ(output_stream.str(), "\tNA\tNA\tNA\tNA\tNA");
+}
+
+// Counters may not be accessible, e.g., in containers or due to perf_event_paranoid.
+TEST(perf_counters, enabled)
+{
+    raptor::perf_counter_group const group{true};
+    raptor::serial_perf_counter local{group};
+
+    std::vector<uint64_t> values(1u << 16);
+    local.start();
+    std::iota(values.begin(), values.end(), 0u);
+    local.stop();
+    EXPECT_EQ(values.back(), values.size() - 1u);
+
+    raptor::concurrent_perf_counter counter{};
+    counter += local;
+
+    if (!group.is_valid())
+    {
+        EXPECT_FALSE(counter.is_available(perf_event::cycles));
+        GTEST_SKIP() << "Hardware performance counters are not available.";
+    }
+
+    EXPECT_TRUE(counter.is_available(perf_event::cycles));
+    EXPECT_GT(counter[perf_event::cycles], 0u);
+
+    raptor::concurrent_perf_counter const copy{counter};
+    EXPECT_FALSE(copy.is_available(perf_event::cycles));
+}
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <raptor/file_reader.hpp>
+#include <raptor/record_ranges.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct record_ranges : public raptor_base
+{
+    static void check(std::filesystem::path const & file, size_t const chunk_size)
+    {
+        std::vector<std::string> const file_names{file.string()};
+        std::vector<raptor::record_range> const ranges = raptor::record_ranges(file_names, chunk_size);
+        ASSERT_FALSE(ranges.empty());
+        EXPECT_EQ(ranges.front().begin, 0u);
+        EXPECT_EQ(ranges.back().end, std::filesystem::file_size(file));
+        for (size_t i = 1; i < ranges.size(); ++i)
+            EXPECT_EQ(ranges[i].begin, ranges[i - 1u].end);
+
+        raptor::file_reader<raptor::file_types::sequence> const reader{seqan3::shape{seqan3::ungapped{19u}}, 23u};
+        std::vector<uint64_t> expected{};
+        reader.hash_into(file_names, std::back_inserter(expected));
+
+        std::vector<uint64_t> actual{};
+        for (auto const & range : ranges)
+            reader.for_each_hash(range,
+                                 [&](uint64_t const hash)
+                                 {
+                                     actual.push_back(hash);
+                                 });
+
+        EXPECT_EQ(actual, expected);
+    }
+};
+
+TEST_F(record_ranges, fasta)
+{
+    check(data("multi_record_bin.fa"), 1u);
+    check(data("multi_record_bin.fa"), 100u);
+    check(data("multi_record_bin.fa"), 1ULL << 24);
+}
+
+TEST_F(record_ranges, fastq)
+{
+    check(data("query.fq"), 1u);
+    check(data("query.fq"), 1000u);
+    check(data("query.fq"), 1ULL << 24);
+}
+
+TEST_F(record_ranges, compressed)
+{
+    std::vector<std::string> const file_names{data("bin1.fa.gz").string()};
+    std::vector<raptor::record_range> const ranges = raptor::record_ranges(file_names, 1u);
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].format, raptor::record_range::formats::whole_file);
+}
+
+TEST_F(record_ranges, large_user_bins)
+{
+    std::vector<std::vector<std::string>> const bin_path{{data("bin1.fa")}, {data("multi_record_bin.fa")}};
+    EXPECT_EQ(raptor::large_user_bins(bin_path, 1u, 1u), (std::vector<bool>{false, false}));
+    EXPECT_EQ(raptor::large_user_bins(bin_path, 2u, 1u), (std::vector<bool>{false, true}));
+    EXPECT_EQ(raptor::large_user_bins(bin_path, 2u, 1ULL << 24), (std::vector<bool>{false, false}));
+
+    // A single compressed file and a single record are one range each.
+    std::vector<std::vector<std::string>> const single_range{{data("bin1.fa.gz")}, {data("bin1.fa")}};
+    EXPECT_EQ(raptor::large_user_bins(single_range, 8u, 1u), (std::vector<bool>{false, false}));
+
+    std::vector<std::vector<std::string>> const two_files{{data("bin1.fa.gz"), data("bin2.fa.gz")}, {data("bin1.fa")}};
+    EXPECT_EQ(raptor::large_user_bins(two_files, 8u, 1u), (std::vector<bool>{true, false}));
+}
+
+TEST_F(record_ranges, record_range_buffer)
+{
+    std::filesystem::path const file = data("multi_record_bin.fa");
+    std::string const content = [&]()
+    {
+        std::ifstream stream{file, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    }();
+
+    raptor::record_range const range{.file_name = file.string(), .begin = 10u, .end = 500u};
+    for (size_t const buffer_size : {1u, 7u, 1000u})
+    {
+        raptor::detail::record_range_buffer buffer{range, buffer_size};
+        std::string const actual{std::istreambuf_iterator<char>{&buffer}, std::istreambuf_iterator<char>{}};
+        EXPECT_EQ(actual, content.substr(10u, 490u));
+    }
+}
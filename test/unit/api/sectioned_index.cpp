@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <raptor/build/store_index.hpp>
+#include <raptor/search/load_index.hpp>
+#include <raptor/sectioned_index.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct sectioned_index : public raptor_base
+{
+    static raptor::raptor_index<raptor::index_structure::hibf> load_expected()
+    {
+        raptor::raptor_index<raptor::index_structure::hibf> index{};
+        raptor::detail::load_index(index, data("128bins23window.hibf"));
+        return index;
+    }
+};
+
+TEST_F(sectioned_index, store_and_load)
+{
+    EXPECT_FALSE(raptor::sectioned_index::is_sectioned(data("128bins23window.hibf")));
+
+    raptor::store_index("sectioned.hibf", load_expected(), 4u);
+    ASSERT_TRUE(raptor::sectioned_index::is_sectioned("sectioned.hibf"));
+
+    raptor::raptor_index<raptor::index_structure::hibf> const expected = load_expected();
+    raptor::raptor_index<raptor::index_structure::hibf> actual{};
+    raptor::detail::load_index(actual, "sectioned.hibf", 3u);
+
+    EXPECT_EQ(expected.window_size(), actual.window_size());
+    EXPECT_EQ(expected.shape(), actual.shape());
+    EXPECT_EQ(expected.parts(), actual.parts());
+    EXPECT_EQ(expected.bin_path(), actual.bin_path());
+    EXPECT_EQ(expected.fpr(), actual.fpr());
+    EXPECT_TRUE(actual.is_hibf());
+
+    auto const & expected_hibf = expected.ibf();
+    auto const & actual_hibf = actual.ibf();
+    ASSERT_EQ(expected_hibf.ibf_vector.size(), actual_hibf.ibf_vector.size());
+    for (size_t i = 0; i < expected_hibf.ibf_vector.size(); ++i)
+        EXPECT_TRUE(expected_hibf.ibf_vector[i] == actual_hibf.ibf_vector[i]) << "IBF " << i;
+    EXPECT_EQ(expected_hibf.next_ibf_id, actual_hibf.next_ibf_id);
+    EXPECT_EQ(expected_hibf.ibf_bin_to_user_bin_id, actual_hibf.ibf_bin_to_user_bin_id);
+    EXPECT_EQ(expected_hibf.prev_ibf_id.size(), actual_hibf.prev_ibf_id.size());
+}
+
+TEST_F(sectioned_index, load_parameters)
+{
+    raptor::store_index("sectioned.hibf", load_expected(), 2u);
+
+    raptor::raptor_index<> parameters{};
+    raptor::sectioned_index::load_parameters("sectioned.hibf", parameters);
+
+    raptor::raptor_index<raptor::index_structure::hibf> const expected = load_expected();
+    EXPECT_EQ(parameters.window_size(), expected.window_size());
+    EXPECT_EQ(parameters.shape(), expected.shape());
+    EXPECT_TRUE(parameters.bin_path().empty());
+    EXPECT_TRUE(parameters.is_hibf());
+    EXPECT_EQ(raptor::sectioned_index::load_bin_paths("sectioned.hibf", 2u), expected.bin_path());
+}
+
+TEST_F(sectioned_index, corrupted)
+{
+    raptor::store_index("sectioned.hibf", load_expected(), 1u);
+    std::filesystem::resize_file("sectioned.hibf", std::filesystem::file_size("sectioned.hibf") / 2u);
+
+    raptor::raptor_index<raptor::index_structure::hibf> index{};
+    EXPECT_THROW(raptor::detail::load_index(index, "sectioned.hibf", 2u), sharg::parser_error);
+}
+
+TEST_F(sectioned_index, checksum)
+{
+    raptor::store_index("sectioned.hibf", load_expected(), 2u);
+
+    raptor::index_header const header = raptor::index_section_table::read("sectioned.hibf");
+    EXPECT_EQ(header.version, raptor::index_section_table::format_version);
+    for (raptor::index_section const & section : header.sections)
+        EXPECT_EQ(section.offset % raptor::index_section_table::alignment, 0u);
+
+    // Flip a bit in the middle of the last IBF.
+    {
+        raptor::index_section const & last = header.sections.back();
+        std::fstream stream{"sectioned.hibf", std::ios::binary | std::ios::in | std::ios::out};
+        stream.seekg(last.offset + last.size / 2u);
+        char const value = static_cast<char>(stream.get() ^ 0x10);
+        stream.seekp(last.offset + last.size / 2u);
+        stream.put(value);
+    }
+
+    raptor::raptor_index<raptor::index_structure::hibf> index{};
+    EXPECT_THROW(raptor::detail::load_index(index, "sectioned.hibf", 2u), sharg::parser_error);
+
+    // The parameters are still readable.
+    raptor::raptor_index<> parameters{};
+    EXPECT_NO_THROW(raptor::sectioned_index::load_parameters("sectioned.hibf", parameters));
+}
+
+TEST_F(sectioned_index, compressed_hibf)
+{
+    raptor::store_index("compressed.hibf", load_expected(), 4u, true);
+    ASSERT_TRUE(raptor::index_section_table::is_compressed("compressed.hibf"));
+    EXPECT_GT(raptor::index_section_table::memory_size("compressed.hibf"),
+              std::filesystem::file_size("compressed.hibf"));
+
+    raptor::raptor_index<raptor::index_structure::hibf> const expected = load_expected();
+    raptor::raptor_index<raptor::index_structure::hibf> actual{};
+    raptor::detail::load_index(actual, "compressed.hibf", 3u);
+
+    EXPECT_EQ(expected.bin_path(), actual.bin_path());
+    auto const & expected_hibf = expected.ibf();
+    auto const & actual_hibf = actual.ibf();
+    ASSERT_EQ(expected_hibf.ibf_vector.size(), actual_hibf.ibf_vector.size());
+    for (size_t i = 0; i < expected_hibf.ibf_vector.size(); ++i)
+        EXPECT_TRUE(expected_hibf.ibf_vector[i] == actual_hibf.ibf_vector[i]) << "IBF " << i;
+    EXPECT_EQ(expected_hibf.next_ibf_id, actual_hibf.next_ibf_id);
+    EXPECT_EQ(expected_hibf.ibf_bin_to_user_bin_id, actual_hibf.ibf_bin_to_user_bin_id);
+
+    raptor::raptor_index<> parameters{};
+    raptor::sectioned_index::load_parameters("compressed.hibf", parameters);
+    EXPECT_EQ(raptor::sectioned_index::load_bin_paths("compressed.hibf", 2u), expected.bin_path());
+}
+
+TEST_F(sectioned_index, compressed_ibf)
+{
+    raptor::raptor_index<> expected{};
+    raptor::detail::load_index(expected, data("1bins23window.index"));
+
+    {
+        raptor::raptor_index<> index{};
+        raptor::detail::load_index(index, data("1bins23window.index"));
+        raptor::store_index("compressed.index", std::move(index), 2u, true);
+    }
+    ASSERT_TRUE(raptor::index_section_table::is_compressed("compressed.index"));
+
+    raptor::raptor_index<> actual{};
+    raptor::detail::load_index(actual, "compressed.index", 2u);
+
+    EXPECT_EQ(expected.window_size(), actual.window_size());
+    EXPECT_EQ(expected.shape(), actual.shape());
+    EXPECT_EQ(expected.bin_path(), actual.bin_path());
+    EXPECT_TRUE(expected.ibf() == actual.ibf());
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <span>
+
+#include <raptor/build/sliced_index_writer.hpp>
+#include <raptor/sectioned_index.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct sliced_index_writer : public raptor_base
+{
+    static std::string read_file(std::filesystem::path const & path)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        return {std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    }
+};
+
+// If this fails, the serialisation of the index changed and raptor::detail::sliced_index_writer needs to be updated.
+TEST_F(sliced_index_writer, same_as_store)
+{
+    // 130 user bins: The last word column is only partially used.
+    // 9000 user bins: More than one bin path section.
+    for (size_t const bins : {1u, 64u, 130u, 9000u})
+    {
+        for (size_t const hash : {1u, 2u, 5u})
+        {
+            raptor::build_arguments arguments{};
+            arguments.bins = bins;
+            arguments.bits = 1021u;
+            arguments.hash = hash;
+            arguments.window_size = 23u;
+            arguments.shape = seqan3::shape{seqan3::ungapped{19u}};
+            arguments.fpr = 0.01;
+            for (size_t i = 0; i < bins; ++i)
+                arguments.bin_path.push_back({"bin" + std::to_string(i) + ".fa"});
+
+            raptor::raptor_index<> index{arguments};
+            auto & data = index.ibf().raw_data();
+            for (size_t i = 0; i < data.size(); ++i)
+                data[i] = i * 0x9E37'79B9'7F4A'7C15ULL;
+            std::vector<uint64_t> const words(data.begin(), data.end());
+
+            {
+                std::ofstream stream{"sliced.index", std::ios::binary};
+                raptor::detail::sliced_index_writer writer{stream, arguments};
+                ASSERT_EQ(writer.words(), words.size());
+
+                // Slices of three rows.
+                size_t const slice_words = 3u * writer.row_words();
+                for (size_t i = 0; i < words.size(); i += slice_words)
+                    writer.write(std::span<uint64_t const>{words}.subspan(i, std::min(slice_words, words.size() - i)));
+                writer.finish();
+            }
+
+            raptor::sectioned_index::store("stored.index", std::move(index), 1u, false);
+
+            EXPECT_EQ(read_file("sliced.index"), read_file("stored.index")) << "bins: " << bins << ", hash: " << hash;
+        }
+    }
+}
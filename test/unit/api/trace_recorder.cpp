@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <raptor/argument_parsing/trace_recorder.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct trace_recorder : public raptor_base
+{
+    static std::string read(std::filesystem::path const & path)
+    {
+        std::ifstream stream{path};
+        std::stringstream buffer{};
+        buffer << stream.rdbuf();
+        return buffer.str();
+    }
+
+    static size_t count(std::string const & text, std::string_view const pattern)
+    {
+        size_t result{};
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1u))
+            ++result;
+        return result;
+    }
+
+    // Each thread records `spans` spans.
+    static void record(raptor::trace_recorder const & recorder, size_t const threads, size_t const spans)
+    {
+        std::vector<std::thread> workers{};
+        for (size_t i = 0; i < threads; ++i)
+            workers.emplace_back(
+                [&]()
+                {
+                    for (size_t j = 0; j < spans; ++j)
+                    {
+                        auto span = recorder.scoped("Work", "test");
+                        span.add_arg("span", j);
+                    }
+                });
+        for (std::thread & worker : workers)
+            worker.join();
+    }
+};
+
+TEST_F(trace_recorder, disabled)
+{
+    raptor::trace_recorder const recorder{};
+    record(recorder, 2u, 10u);
+    recorder.write("trace.json");
+    EXPECT_FALSE(std::filesystem::exists("trace.json"));
+}
+
+TEST_F(trace_recorder, threads)
+{
+    raptor::trace_recorder recorder{};
+    recorder.enable();
+    raptor::trace_recorder const copy{recorder};
+    record(copy, 4u, 25u);
+    recorder.write("trace.json");
+
+    std::string const trace = read("trace.json");
+    EXPECT_TRUE(trace.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_EQ(count(trace, "\"name\":\"Work\""), 100u);
+    EXPECT_EQ(count(trace, "\"args\":{\"span\":24}"), 4u);
+    EXPECT_NE(trace.find("\"otherData\":{\"dropped_events\":0}"), std::string::npos);
+}
+
+TEST_F(trace_recorder, max_events)
+{
+    raptor::trace_recorder recorder{};
+    recorder.enable(10u);
+    record(recorder, 4u, 25u);
+    recorder.write("trace.json");
+
+    std::string const trace = read("trace.json");
+    EXPECT_EQ(count(trace, "\"name\":\"Work\""), 10u);
+    EXPECT_NE(trace.find("\"otherData\":{\"dropped_events\":90}"), std::string::npos);
+}
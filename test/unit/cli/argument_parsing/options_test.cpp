@@ -264,6 +264,57 @@ TEST_F(argparse_build, partitioned_parts)
     RAPTOR_ASSERT_FAIL_EXIT(result);
 }
 
+TEST_F(argparse_build, single_pass_without_parts)
+{
+    cli_test_result const result =
+        execute_app("raptor", "build", "--single-pass", "--output index.raptor", "--input", tmp_bin_list_file);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{"[Error] --single-pass requires --parts.\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
+TEST_F(argparse_build, wrong_store_memory)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "build",
+                                               "--parts 4",
+                                               "--store-memory 12X",
+                                               "--output index.raptor",
+                                               "--input",
+                                               tmp_bin_list_file);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{"[Error] --store-memory: Unknown unit in \"12X\".\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
+TEST_F(argparse_build, index_memory_with_parts)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "build",
+                                               "--parts 4",
+                                               "--index-memory 1Gi",
+                                               "--output index.raptor",
+                                               "--input",
+                                               tmp_bin_list_file);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{"[Error] --index-memory cannot be used with --parts.\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
+TEST_F(argparse_build, index_memory_with_compress)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "build",
+                                               "--compress",
+                                               "--index-memory 1Gi",
+                                               "--output index.raptor",
+                                               "--input",
+                                               tmp_bin_list_file);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{"[Error] --index-memory cannot be used with --compress.\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
 TEST_F(argparse_build, minimiser_and_shape)
 {
     cli_test_result const result =
@@ -549,6 +600,30 @@ TEST_F(argparse_upgrade, not_implemented)
     RAPTOR_ASSERT_FAIL_EXIT(result);
 }
 
+TEST_F(argparse_upgrade, sectioned_without_output)
+{
+    cli_test_result const result = execute_app("raptor", "upgrade", "--sectioned", "--input", tmp_index_file);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{"[Error] --sectioned requires --input and --output.\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
+TEST_F(argparse_upgrade, ambiguous_index)
+{
+    {
+        std::ofstream monolithic_index{"raptor.index"};
+        std::ofstream partitioned_index{"raptor.index_0"};
+    }
+
+    cli_test_result const result =
+        execute_app("raptor", "upgrade", "--sectioned", "--input raptor.index", "--output upgraded.index");
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err,
+              std::string{"[Error] Ambiguous index. Both monolithic (raptor.index) and partitioned index "
+                          "(raptor.index_0) exist. Please rename the monolithic index.\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
 TEST_F(argparse_prepare, no_options)
 {
     cli_test_result const result = execute_app("raptor", "prepare");
@@ -557,12 +632,25 @@ TEST_F(argparse_prepare, no_options)
         "build\n====================================================================================\n"
         "    raptor prepare --input <file> --output <directory> [--threads <number>]\n    [--quiet] [-"
         "-kmer <number>|--shape <01-pattern>] [--window <number>]\n    [--kmer-count-cutoff <number>|--use-filesize-de"
-        "pendent-cutoff]\n    Try -h or --help for more information.\n"};
+        "pendent-cutoff]\n    [--compress] [--memory <size>] [--container]\n    Try -h or --help for more information.\n"};
     EXPECT_EQ(result.out, expected);
     EXPECT_EQ(result.err, std::string{});
     RAPTOR_ASSERT_ZERO_EXIT(result);
 }
 
+TEST_F(argparse_prepare, wrong_memory)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "prepare",
+                                               "--output directory",
+                                               "--memory 12X",
+                                               "--input",
+                                               tmp_bin_list_file);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{"[Error] --memory: Unknown unit in \"12X\".\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
 TEST_F(argparse_prepare, cutoffs)
 {
     cli_test_result const result = execute_app("raptor",
@@ -2,6 +2,8 @@
 // SPDX-FileCopyrightText: 2016-2024 Knut Reinert & MPI für molekulare Genetik
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include <raptor/minimiser_container.hpp>
+#include <raptor/minimiser_file.hpp>
 #include <raptor/test/cli_test.hpp>
 
 struct build_hibf : public raptor_base, public testing::WithParamInterface<std::tuple<size_t, size_t, bool>>
@@ -55,6 +57,144 @@ TEST_P(build_hibf, with_shape)
                                                  "raptor.index");
 }
 
+TEST_P(build_hibf, minimiser_store_interrupted)
+{
+    auto const [number_of_repeated_bins, window_size, run_parallel_tmp] = GetParam();
+    bool const run_parallel = run_parallel_tmp && number_of_repeated_bins >= 32;
+
+    { // A store from an interrupted build with a different window size must not be used.
+        std::filesystem::create_directory("raptor.index.minimisers");
+        seqan3::shape const shape{seqan3::ungapped{19u}};
+        raptor::minimiser_shard_writer shard{"raptor.index.minimisers", 0u};
+        {
+            raptor::compressed_minimiser_writer writer{shard.begin(), shape, window_size + 1u};
+            writer.push(1u);
+        }
+        shard.commit("0",
+                     raptor::minimiser_header{.shape_string = shape.to_string(),
+                                              .window_size = window_size + 1u,
+                                              .cutoff = 1u,
+                                              .count = 1u,
+                                              .suffix_counts = std::array<uint64_t, 64>{}});
+        // And an incomplete minimiser file.
+        shard.begin() << "partial";
+    }
+
+    cli_test_result const result = execute_app("raptor",
+                                               "build",
+                                               "--kmer 19",
+                                               "--window",
+                                               std::to_string(window_size),
+                                               "--threads",
+                                               run_parallel ? "2" : "1",
+                                               "--minimiser-store",
+                                               "--output raptor.index",
+                                               "--quiet",
+                                               "--input",
+                                               layout_path(number_of_repeated_bins));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    compare_index<raptor::index_structure::hibf>(ibf_path(number_of_repeated_bins, window_size, is_hibf::yes),
+                                                 "raptor.index");
+    EXPECT_TRUE(std::filesystem::exists("raptor.index.minimisers"));
+}
+
+TEST_P(build_hibf, minimiser_store)
+{
+    auto const [number_of_repeated_bins, window_size, run_parallel_tmp] = GetParam();
+    bool const run_parallel = run_parallel_tmp && number_of_repeated_bins >= 32;
+
+    // The second build only reads the stored minimisers.
+    for (size_t run = 0; run < 2; ++run)
+    {
+        cli_test_result const result = execute_app("raptor",
+                                                   "build",
+                                                   "--kmer 19",
+                                                   "--window",
+                                                   std::to_string(window_size),
+                                                   "--threads",
+                                                   run_parallel ? "2" : "1",
+                                                   "--minimiser-store",
+                                                   "--output raptor.index",
+                                                   "--quiet",
+                                                   "--input",
+                                                   layout_path(number_of_repeated_bins));
+        EXPECT_EQ(result.out, std::string{});
+        EXPECT_EQ(result.err, std::string{});
+        RAPTOR_ASSERT_ZERO_EXIT(result);
+
+        compare_index<raptor::index_structure::hibf>(ibf_path(number_of_repeated_bins, window_size, is_hibf::yes),
+                                                     "raptor.index");
+        EXPECT_EQ(raptor::minimiser_container{"raptor.index.minimisers"}.size(),
+                  std::max<size_t>(1u, number_of_repeated_bins * 4u));
+    }
+}
+
+TEST_F(build_hibf, minimiser_store_changed_input)
+{
+    // The same layout, but user bin i has the file of user bin 63 - i.
+    {
+        std::ifstream layout{layout_path(16)};
+        std::vector<std::string> lines{};
+        std::vector<size_t> user_bin_lines{};
+        bool in_user_bins{false};
+        for (std::string line{}; std::getline(layout, line);)
+        {
+            if (line == "@CHOPPER_USER_BINS_END")
+                in_user_bins = false;
+            else if (in_user_bins)
+                user_bin_lines.push_back(lines.size());
+            else if (line == "@CHOPPER_USER_BINS")
+                in_user_bins = true;
+            lines.push_back(std::move(line));
+        }
+        ASSERT_EQ(user_bin_lines.size(), 64u);
+
+        auto file_name = [&](size_t const user_bin_id)
+        {
+            std::string const & line = lines[user_bin_lines[user_bin_id]];
+            return line.substr(line.find(' ') + 1u);
+        };
+        std::vector<std::string> reversed_lines{lines};
+        for (size_t user_bin_id = 0; user_bin_id < 64u; ++user_bin_id)
+            reversed_lines[user_bin_lines[user_bin_id]] =
+                '@' + std::to_string(user_bin_id) + ' ' + file_name(63u - user_bin_id);
+
+        std::ofstream reversed{"reversed.layout"};
+        for (std::string const & line : reversed_lines)
+            reversed << line << '\n';
+    }
+
+    auto build = [this](std::filesystem::path const & layout, std::string_view const output, bool const use_store)
+    {
+        cli_test_result const result = execute_app("raptor",
+                                                   "build",
+                                                   "--kmer 19",
+                                                   "--window 19",
+                                                   "--threads 1",
+                                                   use_store ? "--minimiser-store" : "",
+                                                   "--output",
+                                                   output,
+                                                   "--quiet",
+                                                   "--input",
+                                                   layout);
+        EXPECT_EQ(result.out, std::string{});
+        EXPECT_EQ(result.err, std::string{});
+        RAPTOR_ASSERT_ZERO_EXIT(result);
+    };
+
+    // The second build must not use the minimisers that the first build stored for the same user bin IDs.
+    build(layout_path(16), "raptor.index", true);
+    build("reversed.layout", "raptor.index", true);
+    build("reversed.layout", "expected.index", false);
+
+    compare_index<raptor::index_structure::hibf>("expected.index", "raptor.index");
+    // The entries of the first build were replaced.
+    EXPECT_EQ(raptor::minimiser_container{"raptor.index.minimisers"}.size(), 64u);
+}
+
 INSTANTIATE_TEST_SUITE_P(build_hibf_suite,
                          build_hibf,
                          testing::Combine(testing::Values(0, 16, 32),
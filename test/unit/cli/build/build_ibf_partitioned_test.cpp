@@ -136,6 +136,117 @@ TEST_F(build_ibf_partitioned, pipeline_misc)
     compare_search(16, 1, "search2.out", is_empty::yes);
 }
 
+// A user bin of multiple preprocessed files: Only the user bins that may be the biggest are read to size the parts.
+TEST_F(build_ibf_partitioned, pipeline_multiple_files)
+{
+    { // generate input files
+        std::ofstream file{"raptor_cli_test.txt"};
+        std::ofstream sequence_file{"raptor_cli_test_sequences.txt"};
+        std::ofstream minimiser_file{"raptor_cli_test.minimiser"};
+        for (auto && file_path : get_repeated_bins(1))
+            file << file_path << '\n';
+        std::vector<std::vector<std::string>> const user_bins{{"bin1", "bin2"},
+                                                              {"bin3", "bin4"},
+                                                              {"bin1", "bin3"},
+                                                              {"bin2"}};
+        for (auto const & stems : user_bins)
+        {
+            for (size_t i{}; i < stems.size(); ++i)
+            {
+                char const separator = i + 1u == stems.size() ? '\n' : ' ';
+                sequence_file << data(stems[i] + ".fa").string() << separator;
+                minimiser_file << "precomputed_minimisers/" << stems[i] << ".minimiser" << separator;
+            }
+        }
+    }
+
+    cli_test_result const result1 = execute_app("raptor",
+                                                "prepare",
+                                                "--kmer 19",
+                                                "--window 23",
+                                                "--output precomputed_minimisers",
+                                                "--quiet",
+                                                "--input",
+                                                "raptor_cli_test.txt");
+    EXPECT_EQ(result1.out, std::string{});
+    EXPECT_EQ(result1.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result1);
+
+    cli_test_result const result2 = execute_app("raptor",
+                                                "build",
+                                                "--kmer 19",
+                                                "--window 23",
+                                                "--output sequences.index",
+                                                "--parts 4",
+                                                "--quiet",
+                                                "--input",
+                                                "raptor_cli_test_sequences.txt");
+    EXPECT_EQ(result2.out, std::string{});
+    EXPECT_EQ(result2.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result2);
+
+    cli_test_result const result3 = execute_app("raptor",
+                                                "build",
+                                                "--output minimisers.index",
+                                                "--parts 4",
+                                                "--quiet",
+                                                "--input",
+                                                "raptor_cli_test.minimiser");
+    EXPECT_EQ(result3.out, std::string{});
+    EXPECT_EQ(result3.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result3);
+
+    for (size_t part{}; part < 4u; ++part)
+    {
+        std::string const suffix = '_' + std::to_string(part);
+        compare_index("sequences.index" + suffix,
+                      "minimisers.index" + suffix,
+                      compare_extension::no,
+                      is_preprocessed::yes);
+    }
+}
+
+TEST_F(build_ibf_partitioned, single_pass)
+{
+    {
+        std::ofstream file{"raptor_cli_test.txt"};
+        for (auto && file_path : get_repeated_bins(16))
+            file << file_path << '\n';
+    }
+
+    cli_test_result const result1 = execute_app("raptor",
+                                                "build",
+                                                "--kmer 19",
+                                                "--window 23",
+                                                "--output raptor.index",
+                                                "--threads 2",
+                                                "--parts 4",
+                                                "--single-pass",
+                                                "--store-memory 1Gi",
+                                                "--quiet",
+                                                "--input",
+                                                "raptor_cli_test.txt");
+    EXPECT_EQ(result1.out, std::string{});
+    EXPECT_EQ(result1.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result1);
+    EXPECT_FALSE(std::filesystem::exists("raptor.index.spill"));
+
+    cli_test_result const result2 = execute_app("raptor",
+                                                "search",
+                                                "--output search.out",
+                                                "--error 1",
+                                                "--index ",
+                                                "raptor.index",
+                                                "--quiet",
+                                                "--query ",
+                                                data("query.fq"));
+    EXPECT_EQ(result2.out, std::string{});
+    EXPECT_EQ(result2.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result2);
+
+    compare_search(16, 1, "search.out");
+}
+
 INSTANTIATE_TEST_SUITE_P(
     build_ibf_partitioned_suite,
     build_ibf_partitioned,
@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2016-2024 Knut Reinert & MPI für molekulare Genetik
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include <raptor/index_sections.hpp>
 #include <raptor/test/cli_test.hpp>
 
 struct build_ibf : public raptor_base, public testing::WithParamInterface<std::tuple<size_t, size_t, bool>>
@@ -67,6 +68,38 @@ TEST_P(build_ibf, with_shape)
     compare_index(ibf_path(number_of_repeated_bins, window_size), "raptor.index");
 }
 
+TEST_P(build_ibf, in_slices)
+{
+    auto const [number_of_repeated_bins, window_size, run_parallel_tmp] = GetParam();
+    bool const run_parallel = run_parallel_tmp && number_of_repeated_bins >= 32;
+
+    { // generate input file
+        std::ofstream file{"raptor_cli_test.txt"};
+        for (auto && file_path : get_repeated_bins(number_of_repeated_bins))
+            file << file_path << '\n';
+        file << '\n';
+    }
+
+    cli_test_result const result = execute_app("raptor",
+                                               "build",
+                                               "--kmer 19",
+                                               "--window ",
+                                               std::to_string(window_size),
+                                               "--threads ",
+                                               run_parallel ? "2" : "1",
+                                               "--index-memory 4Ki",
+                                               "--output raptor.index",
+                                               "--quiet",
+                                               "--input",
+                                               "raptor_cli_test.txt");
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    compare_index(ibf_path(number_of_repeated_bins, window_size), "raptor.index");
+    EXPECT_EQ(raptor::index_section_table::read("raptor.index").version, raptor::index_section_table::format_version);
+}
+
 INSTANTIATE_TEST_SUITE_P(build_ibf_suite,
                          build_ibf,
                          testing::Combine(testing::Values(0, 16, 32),
@@ -105,3 +138,34 @@ TEST_F(build_ibf, verbose)
 
     compare_index(ibf_path(16, 19), "raptor.index");
 }
+
+TEST_F(build_ibf, trace)
+{
+    { // generate input file
+        std::ofstream file{"raptor_cli_test.txt"};
+        for (auto && file_path : get_repeated_bins(16u))
+            file << file_path << '\n';
+        file << '\n';
+    }
+
+    cli_test_result const result = execute_app("raptor",
+                                               "build",
+                                               "--kmer 19",
+                                               "--window 19",
+                                               "--threads 2",
+                                               "--quiet",
+                                               "--output raptor.index",
+                                               "--trace raptor.trace.json",
+                                               "--input",
+                                               "raptor_cli_test.txt");
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    std::string const trace = string_from_file("raptor.trace.json");
+    EXPECT_TRUE(trace.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(trace.find("\"name\":\"Insert user bin\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Store index\""), std::string::npos);
+
+    compare_index(ibf_path(16, 19), "raptor.index");
+}
@@ -100,3 +100,160 @@ TEST_F(search_hibf, three_levels)
 
     compare_search(32, 0, "search.out");
 }
+
+TEST_F(search_hibf, latency)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 0",
+                                               "--index ",
+                                               data("three_levels.hibf"),
+                                               "--latency",
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_NE(result.err.find("Per-read latency"), std::string::npos);
+    EXPECT_NE(result.err.find("Per-batch latency"), std::string::npos);
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    compare_search(32, 0, "search.out");
+}
+
+TEST_F(search_hibf, compact_header)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 0",
+                                               "--index ",
+                                               ibf_path(16, 19, is_hibf::yes),
+                                               "--compact-header",
+                                               "--quiet",
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    std::ifstream search_result{"search.out"};
+    std::string line{};
+    bool has_user_bin_count{false};
+    while (std::getline(search_result, line) && line.starts_with("##"))
+        has_user_bin_count |= line == "## User bins = 64";
+
+    EXPECT_TRUE(has_user_bin_count);
+    EXPECT_EQ(line, "#QUERY_NAME\tUSER_BINS");
+}
+
+TEST_F(search_hibf, load_on_demand)
+{
+    cli_test_result const result1 = execute_app("raptor",
+                                                "upgrade",
+                                                "--input",
+                                                ibf_path(16, 19, is_hibf::yes),
+                                                "--output raptor.index");
+    RAPTOR_ASSERT_ZERO_EXIT(result1);
+
+    cli_test_result const result2 = execute_app("raptor",
+                                                "search",
+                                                "--output search.out",
+                                                "--error 0",
+                                                "--index raptor.index",
+                                                "--hibf-cache-size 1",
+                                                "--timing-output raptor.time",
+                                                "--query ",
+                                                data("query.fq"));
+    EXPECT_EQ(result2.out, std::string{});
+    EXPECT_NE(result2.err.find("HIBF levels loaded on demand"), std::string::npos);
+    RAPTOR_ASSERT_ZERO_EXIT(result2);
+
+    compare_search(16, 0, "search.out");
+
+    std::ifstream timings{"raptor.time"};
+    std::string header{};
+    ASSERT_TRUE(std::getline(timings, header));
+    EXPECT_NE(header.find("hibf_level_0_queries"), std::string::npos);
+}
+
+TEST_F(search_hibf, load_on_demand_requires_sectioned_index)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 0",
+                                               "--index ",
+                                               ibf_path(16, 19, is_hibf::yes),
+                                               "--hibf-cache-size 1",
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err,
+              "[Error] --hibf-cache-size can only be used with an HIBF index in the current format. Use raptor "
+              "upgrade to convert older indexes.\n");
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
+
+TEST_F(search_hibf, batch_size)
+{
+    for (std::string const batch_size : {"1", "2"})
+    {
+        std::string const output_file{"search_" + batch_size + ".out"};
+        cli_test_result const result = execute_app("raptor",
+                                                   "search",
+                                                   "--output",
+                                                   output_file,
+                                                   "--error 0",
+                                                   "--index ",
+                                                   data("three_levels.hibf"),
+                                                   "--hibf-batch-size",
+                                                   batch_size,
+                                                   "--quiet",
+                                                   "--query ",
+                                                   data("query.fq"));
+        EXPECT_EQ(result.out, std::string{});
+        EXPECT_EQ(result.err, std::string{});
+        RAPTOR_ASSERT_ZERO_EXIT(result);
+
+        compare_search(32, 0, output_file);
+    }
+}
+
+TEST_F(search_hibf, bins)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 0",
+                                               "--index ",
+                                               data("three_levels.hibf"),
+                                               "--bins 0-7,bin1.fa",
+                                               "--quiet",
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    compare_selected_search("search.out",
+                            [](uint64_t const user_bin_id, std::string_view const file_names)
+                            {
+                                return user_bin_id <= 7u || file_names.ends_with("bin1.fa");
+                            });
+}
+
+TEST_F(search_hibf, bins_invalid)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 0",
+                                               "--index ",
+                                               data("three_levels.hibf"),
+                                               "--bins 3,128",
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, "[Error] --bins: The user bin ID 128 is invalid. The index has 128 user bins.\n");
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}
@@ -143,3 +143,124 @@ TEST_F(search_ibf, verbose)
 
     compare_search(16, 1, "search.out");
 }
+
+TEST_F(search_ibf, latency)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 1",
+                                               "--p_max 0.4",
+                                               "--index ",
+                                               ibf_path(16, 19),
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.err.find("Per-read latency"), std::string::npos);
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    cli_test_result const result2 = execute_app("raptor",
+                                                "search",
+                                                "--output search.out",
+                                                "--latency",
+                                                "--error 1",
+                                                "--p_max 0.4",
+                                                "--index ",
+                                                ibf_path(16, 19),
+                                                "--query ",
+                                                data("query.fq"));
+    EXPECT_NE(result2.err.find("Per-read latency"), std::string::npos);
+    RAPTOR_ASSERT_ZERO_EXIT(result2);
+
+    compare_search(16, 1, "search.out");
+}
+
+TEST_F(search_ibf, trace)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--quiet",
+                                               "--trace raptor.trace.json",
+                                               "--error 1",
+                                               "--p_max 0.4",
+                                               "--index ",
+                                               ibf_path(16, 19),
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    std::string const trace = string_from_file("raptor.trace.json");
+    EXPECT_TRUE(trace.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(trace.find("\"name\":\"Load index\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Query file I/O\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Search\""), std::string::npos);
+
+    compare_search(16, 1, "search.out");
+}
+
+TEST_F(search_ibf, bins_file)
+{
+    {
+        std::ofstream bins_file{"bins.txt"};
+        bins_file << "# Selected user bins\n3\n*/bin2.fa\n";
+    }
+
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 0",
+                                               "--index ",
+                                               ibf_path(16, 19),
+                                               "--bins @bins.txt",
+                                               "--quiet",
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    compare_selected_search("search.out",
+                            [](uint64_t const user_bin_id, std::string_view const file_names)
+                            {
+                                return user_bin_id == 3u || file_names.ends_with("/bin2.fa");
+                            });
+}
+
+TEST_F(search_ibf, bins_file_ambiguous)
+{
+    {
+        std::ofstream bins_file{"bins.txt"};
+        bins_file << "3\n";
+    }
+
+    // Without @, bins.txt is a pattern for the file names of the user bins.
+    cli_test_result const result = execute_app("raptor",
+                                               "search",
+                                               "--output search.out",
+                                               "--error 0",
+                                               "--index ",
+                                               ibf_path(16, 19),
+                                               "--bins bins.txt",
+                                               "--query ",
+                                               data("query.fq"));
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err,
+              "[Error] --bins: No user bin matches bins.txt. Use --bins @bins.txt to read the user bins from this "
+              "file.\n");
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+
+    cli_test_result const result2 = execute_app("raptor",
+                                                "search",
+                                                "--output search.out",
+                                                "--error 0",
+                                                "--index ",
+                                                ibf_path(16, 19),
+                                                "--bins @missing.txt",
+                                                "--query ",
+                                                data("query.fq"));
+    EXPECT_EQ(result2.out, std::string{});
+    EXPECT_EQ(result2.err, "[Error] --bins: The file missing.txt does not exist.\n");
+    RAPTOR_ASSERT_FAIL_EXIT(result2);
+}
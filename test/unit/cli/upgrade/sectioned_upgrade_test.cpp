@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2006-2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2016-2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <raptor/index_sections.hpp>
+#include <raptor/test/cli_test.hpp>
+
+struct sectioned_upgrade : public raptor_base
+{};
+
+TEST_F(sectioned_upgrade, ibf)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "upgrade",
+                                               "--sectioned",
+                                               "--input",
+                                               ibf_path(16, 19),
+                                               "--output raptor.index",
+                                               "--threads 2");
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    raptor::index_header const header = raptor::index_section_table::read("raptor.index");
+    EXPECT_EQ(header.version, raptor::index_section_table::format_version);
+    compare_index(ibf_path(16, 19), "raptor.index");
+}
+
+TEST_F(sectioned_upgrade, hibf)
+{
+    cli_test_result const result = execute_app("raptor",
+                                               "upgrade",
+                                               "--sectioned",
+                                               "--input",
+                                               ibf_path(16, 19, is_hibf::yes),
+                                               "--output raptor.index",
+                                               "--threads 2");
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result);
+
+    EXPECT_TRUE(raptor::index_section_table::is_sectioned("raptor.index"));
+    compare_index<raptor::index_structure::hibf>(ibf_path(16, 19, is_hibf::yes), "raptor.index");
+}
+
+TEST_F(sectioned_upgrade, compressed)
+{
+    cli_test_result const result1 = execute_app("raptor",
+                                                "upgrade",
+                                                "--sectioned",
+                                                "--input",
+                                                ibf_path(16, 19),
+                                                "--output raptor.index",
+                                                "--compress");
+    EXPECT_EQ(result1.out, std::string{});
+    EXPECT_EQ(result1.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result1);
+    EXPECT_TRUE(raptor::index_section_table::is_compressed("raptor.index"));
+
+    // An index in the sectioned format can be converted again, e.g., to remove the compression.
+    cli_test_result const result2 =
+        execute_app("raptor", "upgrade", "--sectioned", "--input raptor.index", "--output uncompressed.index");
+    EXPECT_EQ(result2.out, std::string{});
+    EXPECT_EQ(result2.err, std::string{});
+    RAPTOR_ASSERT_ZERO_EXIT(result2);
+    EXPECT_FALSE(raptor::index_section_table::is_compressed("uncompressed.index"));
+
+    compare_index(ibf_path(16, 19), "uncompressed.index");
+}
+
+TEST_F(sectioned_upgrade, old_index)
+{
+    cli_test_result const result =
+        execute_app("raptor", "upgrade", "--sectioned", "--input", data("3.0.index"), "--output raptor.index");
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err,
+              std::string{"[Error] Cannot convert index version 2. Only indexes of Raptor 4.0 and newer can be "
+                          "converted.\n"});
+    RAPTOR_ASSERT_FAIL_EXIT(result);
+}